@@ -0,0 +1,581 @@
+/*!
+* \file CanopySim.cpp
+* \date
+*			2026/10/17	Monte Carlo canopy of turbid crowns: gap fractions and path lengths with known LAI
+*			2026/10/17	NPY header for any case of the extension (.Npy), as the reader
+*
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "CanopySim.h"
+#include "LAIPathBinary.h"
+#include "LAIPathCompat.h"
+
+#define NPY_ALIGN			64			//header of NPY files, padded to a multiple
+#define BVH_STACK			64
+
+//crown with the box around it, copies of the crowns near the edges stand outside the plot
+struct canopy_box
+{
+	double lo[3], hi[3];
+	struct canopy_crown crown;
+};
+
+//node of the BVH: inner nodes have their first child next to them and the second at index,
+//leaves count > 0 boxes from index
+struct canopy_node
+{
+	double lo[3], hi[3];
+	size_t index;
+	size_t count;
+};
+
+struct canopy_bvh
+{
+	std::vector<struct canopy_box> boxes;
+	std::vector<struct canopy_node> nodes;
+};
+
+
+//splitmix64, the same canopy on every machine and for any number of threads
+static inline double Canopy_Uniform(uint64_t *state)
+{
+	uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	z ^= z >> 31;
+	return (z >> 11) * (1.0 / 9007199254740992.0);
+}
+
+
+//standard normal (Box-Muller)
+static double Canopy_Normal(uint64_t *state)
+{
+	double u = 1.0 - Canopy_Uniform(state);		//(0, 1]
+	return sqrt(-2 * log(u)) * cos(2 * M_PI * Canopy_Uniform(state));
+}
+
+
+//independent random numbers of a stream (crowns: 0, chunk k of rays: k + 1)
+static uint64_t Canopy_Stream(uint64_t seed, uint64_t stream)
+{
+	uint64_t state = seed ^ (stream * 0xD1B54A32D192ED03ull);
+	Canopy_Uniform(&state);
+	return state;
+}
+
+
+static double Canopy_Wrap(double x, double size)
+{
+	x = fmod(x, size);
+	return (x < 0) ? x + size : x;
+}
+
+
+//************************************
+// Method:    CanopySim_Default	A stand of 28% crown cover, LAI about 0.85
+// FullName:  CanopySim_Default
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: canopy_scene * scene
+//************************************
+void CanopySim_Default(struct canopy_scene *scene)
+{
+	scene->plotSize = 50;
+	scene->nCrowns = 100;
+	scene->shape = CANOPY_ELLIPSOID;
+	scene->crownRadius = 1.5;
+	scene->crownHeight = 5;
+	scene->crownBase = 2;
+	scene->sizeVariation = 0.2;
+	scene->lad = 0.9;
+	scene->G = 0.5;
+	scene->pattern = CANOPY_RANDOM;
+	scene->clusterSize = 5;
+	scene->clusterRadius = 3;
+	scene->zenith = 30;
+	scene->nRays = 100000;
+	scene->seed = 1;
+}
+
+
+//value of a key of the scene file, false if it is not understood
+static bool Scene_Field(struct canopy_scene *scene, const char *key, const char *value)
+{
+	char *end;
+	if (strcmp(key, "shape") == 0)
+	{
+		if (strcmp(value, "ellipsoid") == 0)
+			scene->shape = CANOPY_ELLIPSOID;
+		else if (strcmp(value, "cone") == 0)
+			scene->shape = CANOPY_CONE;
+		else
+			return false;
+		return true;
+	}
+	if (strcmp(key, "pattern") == 0)
+	{
+		if (strcmp(value, "random") == 0)
+			scene->pattern = CANOPY_RANDOM;
+		else if (strcmp(value, "regular") == 0)
+			scene->pattern = CANOPY_REGULAR;
+		else if (strcmp(value, "clumped") == 0)
+			scene->pattern = CANOPY_CLUMPED;
+		else
+			return false;
+		return true;
+	}
+	if (strcmp(key, "crowns") == 0 || strcmp(key, "rays") == 0 || strcmp(key, "seed") == 0)
+	{
+		unsigned long long n = strtoull(value, &end, 10);
+		if (end == value || *end != '\0' || value[0] == '-')
+			return false;
+		if (key[0] == 'c')
+			scene->nCrowns = (size_t)n;
+		else if (key[0] == 'r')
+			scene->nRays = (size_t)n;
+		else
+			scene->seed = n;
+		return true;
+	}
+
+	static const char *const keys[] = { "plot_size", "crown_radius", "crown_height", "crown_base", "size_variation",
+		"lad", "G", "cluster_size", "cluster_radius", "zenith" };
+	double *const fields[] = { &scene->plotSize, &scene->crownRadius, &scene->crownHeight, &scene->crownBase, &scene->sizeVariation,
+		&scene->lad, &scene->G, &scene->clusterSize, &scene->clusterRadius, &scene->zenith };
+	for (size_t i = 0; i < sizeof(keys) / sizeof(keys[0]); i++)
+		if (strcmp(key, keys[i]) == 0)
+		{
+			*fields[i] = strtod(value, &end);
+			return end != value && *end == '\0';
+		}
+	return false;
+}
+
+
+//************************************
+// Method:    CanopySim_ReadScene	Scene file over the defaults
+// FullName:  CanopySim_ReadScene
+// Access:    public
+// Returns:   int					GSL_SUCCESS, GSL_EFAILED (cannot open), GSL_EINVAL (lines not understood or values out of range)
+// Qualifier:
+// Parameter: const char * fname
+// Parameter: canopy_scene * scene	(for return) defaults (CanopySim_Default) for the keys not in the file
+// Parameter: FILE * report			lines not understood, 0: none
+//************************************
+int CanopySim_ReadScene(const char *fname, struct canopy_scene *scene, FILE *report)
+{
+	CanopySim_Default(scene);
+	FILE *f;
+	if (fopen_s(&f, fname, "r") != 0)
+		return GSL_EFAILED;
+
+	int status = GSL_SUCCESS;
+	char line[1024];
+	for (size_t n = 1; fgets(line, sizeof(line), f); n++)
+	{
+		line[strcspn(line, "%\r\n")] = '\0';
+		char *context = 0;
+		char *key = strtok_s(line, " \t", &context);
+		if (key == 0)
+			continue;				//empty line or comment
+		char *value = strtok_s(0, " \t", &context);
+		if (value == 0 || strtok_s(0, " \t", &context) != 0 || !Scene_Field(scene, key, value))
+		{
+			if (report)
+				fprintf(report, "Warning: line %zu of '%s' is not understood\n", n, fname);
+			status = GSL_EINVAL;
+		}
+	}
+	fclose(f);
+
+	if (!(scene->plotSize > 0) || !(scene->crownRadius > 0) || !(scene->crownHeight > 0) || !(scene->crownBase >= 0)
+		|| !(scene->sizeVariation >= 0 && scene->sizeVariation < 1) || !(scene->lad >= 0) || !(scene->G > 0)
+		|| !(scene->clusterSize >= 1) || !(scene->clusterRadius >= 0)
+		|| !(scene->zenith >= 0 && scene->zenith < CANOPY_MAX_ZENITH) || scene->nRays == 0)
+	{
+		if (report)
+			fprintf(report, "Warning: values of '%s' out of range (sizes > 0, 0 <= size_variation < 1, "
+				"cluster_size >= 1, 0 <= zenith < %d, rays > 0)\n", fname, CANOPY_MAX_ZENITH);
+		status = GSL_EINVAL;
+	}
+	return status;
+}
+
+
+//centers and sizes of the crowns of a plot
+static void Canopy_Crowns(const struct canopy_scene *scene, uint64_t seed, std::vector<struct canopy_crown> &crowns)
+{
+	uint64_t state = Canopy_Stream(seed, 0);
+	const double L = scene->plotSize;
+	const size_t n = scene->nCrowns;
+	crowns.resize(n);
+
+	//Thomas process: crowns scattered around the cluster centers
+	std::vector<double> clusters;
+	if (scene->pattern == CANOPY_CLUMPED)
+	{
+		size_t nClusters = GSL_MAX((size_t)(n / scene->clusterSize + 0.5), (size_t)1);
+		clusters.resize(2 * nClusters);
+		for (size_t c = 0; c < clusters.size(); c++)
+			clusters[c] = L * Canopy_Uniform(&state);
+	}
+	const size_t nx = (size_t)ceil(sqrt((double)n));
+	const size_t ny = nx ? (n + nx - 1) / nx : 0;
+
+	for (size_t i = 0; i < n; i++)
+	{
+		struct canopy_crown *c = &crowns[i];
+		if (scene->pattern == CANOPY_REGULAR)
+		{
+			c->x = ((i % nx) + 0.5) * L / nx;
+			c->y = ((i / nx) + 0.5) * L / ny;
+		}
+		else if (scene->pattern == CANOPY_CLUMPED)
+		{
+			size_t k = (size_t)(Canopy_Uniform(&state) * (clusters.size() / 2));
+			c->x = Canopy_Wrap(clusters[2 * k] + scene->clusterRadius * Canopy_Normal(&state), L);
+			c->y = Canopy_Wrap(clusters[2 * k + 1] + scene->clusterRadius * Canopy_Normal(&state), L);
+		}
+		else
+		{
+			c->x = L * Canopy_Uniform(&state);
+			c->y = L * Canopy_Uniform(&state);
+		}
+		c->radius = scene->crownRadius * (1 + scene->sizeVariation * (2 * Canopy_Uniform(&state) - 1));
+		c->height = scene->crownHeight * (1 + scene->sizeVariation * (2 * Canopy_Uniform(&state) - 1));
+		c->base = scene->crownBase;
+	}
+}
+
+
+//BVH over boxes[first, first + count), nodes appended
+static void Bvh_Build(struct canopy_bvh *bvh, size_t first, size_t count)
+{
+	size_t self = bvh->nodes.size();
+	bvh->nodes.push_back(canopy_node());
+	struct canopy_node node;
+	for (int a = 0; a < 3; a++)
+	{
+		node.lo[a] = GSL_POSINF;
+		node.hi[a] = GSL_NEGINF;
+	}
+	for (size_t i = first; i < first + count; i++)
+		for (int a = 0; a < 3; a++)
+		{
+			node.lo[a] = GSL_MIN(node.lo[a], bvh->boxes[i].lo[a]);
+			node.hi[a] = GSL_MAX(node.hi[a], bvh->boxes[i].hi[a]);
+		}
+
+	if (count <= CANOPY_BVH_LEAF)
+	{
+		node.index = first;
+		node.count = count;
+		bvh->nodes[self] = node;
+		return;
+	}
+
+	//median of the box centers along the longest side
+	int axis = 0;
+	for (int a = 1; a < 3; a++)
+		if (node.hi[a] - node.lo[a] > node.hi[axis] - node.lo[axis])
+			axis = a;
+	std::vector<struct canopy_box>::iterator begin = bvh->boxes.begin() + first;
+	std::nth_element(begin, begin + count / 2, begin + count,
+		[axis](const struct canopy_box &a, const struct canopy_box &b) { return a.lo[axis] + a.hi[axis] < b.lo[axis] + b.hi[axis]; });
+
+	Bvh_Build(bvh, first, count / 2);
+	node.index = bvh->nodes.size();
+	node.count = 0;
+	Bvh_Build(bvh, first + count / 2, count - count / 2);
+	bvh->nodes[self] = node;
+}
+
+
+//crowns and their copies across the edges within reach of the rays, margin: horizontal reach of a ray
+static void Bvh_Scene(struct canopy_bvh *bvh, const std::vector<struct canopy_crown> &crowns, double L, double margin)
+{
+	const int copies = (int)ceil(margin / L);
+	bvh->boxes.clear();
+	bvh->nodes.clear();
+	for (size_t i = 0; i < crowns.size(); i++)
+		for (int u = -copies; u <= copies; u++)
+			for (int v = -copies; v <= copies; v++)
+			{
+				struct canopy_box box;
+				box.crown = crowns[i];
+				box.crown.x += u * L;
+				box.crown.y += v * L;
+				box.lo[0] = box.crown.x - box.crown.radius;
+				box.hi[0] = box.crown.x + box.crown.radius;
+				box.lo[1] = box.crown.y - box.crown.radius;
+				box.hi[1] = box.crown.y + box.crown.radius;
+				box.lo[2] = box.crown.base;
+				box.hi[2] = box.crown.base + box.crown.height;
+				if (box.hi[0] >= -margin && box.lo[0] <= L + margin && box.hi[1] >= -margin && box.lo[1] <= L + margin)
+					bvh->boxes.push_back(box);
+			}
+	if (!bvh->boxes.empty())
+		Bvh_Build(bvh, 0, bvh->boxes.size());
+}
+
+
+//length of [t0, t1] inside [lo, hi]
+static inline double Canopy_Overlap(double t0, double t1, double lo, double hi)
+{
+	return GSL_MAX(GSL_MIN(t1, hi) - GSL_MAX(t0, lo), 0.0);
+}
+
+
+//chord of the ray o + t d (t >= 0, |d| = 1, d[2] > 0) through a crown
+static double Canopy_Chord(int shape, const struct canopy_crown *c, const double o[3], const double d[3])
+{
+	if (shape == CANOPY_ELLIPSOID)
+	{
+		//unit sphere after scaling, t unchanged
+		const double rz = c->height / 2;
+		const double q[3] = { (o[0] - c->x) / c->radius, (o[1] - c->y) / c->radius, (o[2] - c->base - rz) / rz };
+		const double e[3] = { d[0] / c->radius, d[1] / c->radius, d[2] / rz };
+		const double a = e[0] * e[0] + e[1] * e[1] + e[2] * e[2];
+		const double b = q[0] * e[0] + q[1] * e[1] + q[2] * e[2];
+		const double disc = b * b - a * (q[0] * q[0] + q[1] * q[1] + q[2] * q[2] - 1);
+		if (disc <= 0)
+			return 0;
+		const double s = sqrt(disc);
+		return Canopy_Overlap((-b - s) / a, (-b + s) / a, 0, GSL_POSINF);
+	}
+
+	//cone, apex up: x^2 + y^2 <= k^2 (z - apex)^2 between the base and the apex
+	const double apex = c->base + c->height, k2 = (c->radius / c->height) * (c->radius / c->height);
+	const double q[3] = { o[0] - c->x, o[1] - c->y, o[2] - apex };
+	const double s0 = GSL_MAX((c->base - o[2]) / d[2], 0.0), s1 = (apex - o[2]) / d[2];
+	if (s1 <= s0)
+		return 0;
+	const double a = d[0] * d[0] + d[1] * d[1] - k2 * d[2] * d[2];
+	const double b = q[0] * d[0] + q[1] * d[1] - k2 * q[2] * d[2];
+	const double cc = q[0] * q[0] + q[1] * q[1] - k2 * q[2] * q[2];
+	if (fabs(a) < 1e-12)
+	{
+		//ray along the surface of the cone: f(t) = 2 b t + cc
+		if (fabs(b) < 1e-12)
+			return (cc <= 0) ? s1 - s0 : 0;
+		const double t = -cc / (2 * b);
+		return (b > 0) ? Canopy_Overlap(s0, s1, GSL_NEGINF, t) : Canopy_Overlap(s0, s1, t, GSL_POSINF);
+	}
+	const double disc = b * b - a * cc;
+	if (disc <= 0)
+		return (a < 0) ? s1 - s0 : 0;
+	const double s = sqrt(disc);
+	const double t1 = GSL_MIN((-b - s) / a, (-b + s) / a), t2 = GSL_MAX((-b - s) / a, (-b + s) / a);
+	if (a > 0)
+		return Canopy_Overlap(s0, s1, t1, t2);
+	//steeper than the cone: inside before t1 or after t2, one of them on the upper nappe (outside the slab)
+	return Canopy_Overlap(s0, s1, GSL_NEGINF, t1) + Canopy_Overlap(s0, s1, t2, GSL_POSINF);
+}
+
+
+//sum of the chords of a ray through all crowns, -1: no crown
+static double Canopy_Trace(const struct canopy_bvh *bvh, int shape, const double o[3], const double d[3])
+{
+	if (bvh->nodes.empty())
+		return -1;
+
+	double inv[3];
+	for (int a = 0; a < 3; a++)
+		inv[a] = 1 / d[a];			//+-inf for d[a] == 0
+
+	bool hit = false;
+	double path = 0;
+	size_t stack[BVH_STACK];
+	int top = 0;
+	stack[top++] = 0;
+	while (top > 0)
+	{
+		const struct canopy_node *node = &bvh->nodes[stack[--top]];
+		double t0 = 0, t1 = GSL_POSINF;
+		for (int a = 0; a < 3; a++)
+		{
+			if (d[a] == 0)
+			{
+				if (o[a] < node->lo[a] || o[a] > node->hi[a])
+					t1 = -1;
+				continue;
+			}
+			double tlo = (node->lo[a] - o[a]) * inv[a], thi = (node->hi[a] - o[a]) * inv[a];
+			t0 = GSL_MAX(t0, GSL_MIN(tlo, thi));
+			t1 = GSL_MIN(t1, GSL_MAX(tlo, thi));
+		}
+		if (t1 < t0)
+			continue;
+
+		if (node->count == 0)
+		{
+			stack[top++] = node->index;
+			stack[top++] = node - &bvh->nodes[0] + 1;
+			continue;
+		}
+		for (size_t i = node->index; i < node->index + node->count; i++)
+		{
+			double chord = Canopy_Chord(shape, &bvh->boxes[i].crown, o, d);
+			if (chord > 0)
+			{
+				path += chord;
+				hit = true;
+			}
+		}
+	}
+	return hit ? path : -1;
+}
+
+
+//************************************
+// Method:    CanopySim_Plot		Crowns of a plot and its rays, traced in parallel
+// FullName:  CanopySim_Plot
+// Access:    public
+// Returns:   int					GSL_SUCCESS, GSL_EDOM (no ray through a crown: no path lengths)
+// Qualifier:
+// Parameter: LaiPathPool & pool
+// Parameter: const canopy_scene * scene	e.g. CanopySim_ReadScene
+// Parameter: uint64_t seed			crowns and rays of the plot
+// Parameter: canopy_sim * sim		(for return)
+//************************************
+int CanopySim_Plot(LaiPathPool &pool, const struct canopy_scene *scene, uint64_t seed, struct canopy_sim *sim)
+{
+	const double L = scene->plotSize;
+	Canopy_Crowns(scene, seed, sim->crowns);
+
+	double volume = 0, top = 0;
+	for (size_t i = 0; i < sim->crowns.size(); i++)
+	{
+		const struct canopy_crown *c = &sim->crowns[i];
+		volume += M_PI * c->radius * c->radius * c->height * ((scene->shape == CANOPY_ELLIPSOID) ? 2.0 / 3 : 1.0 / 3);
+		top = GSL_MAX(top, c->base + c->height);
+	}
+	sim->trueLAI = scene->lad * volume / (L * L);
+
+	const double zenith = scene->zenith * M_PI / 180;
+	struct canopy_bvh bvh;
+	Bvh_Scene(&bvh, sim->crowns, L, top * tan(zenith));
+
+	//path length of every ray (-1: large gap), then the rays through crowns in their order
+	const size_t nRays = scene->nRays;
+	const size_t nChunks = (nRays + CANOPY_RAY_CHUNK - 1) / CANOPY_RAY_CHUNK;
+	const double extinction = scene->G * scene->lad;
+	std::vector<float> &lengths = sim->pathLengths;
+	lengths.resize(nRays);
+	std::vector<double> chunkGap(nChunks);
+	pool.parallelFor(0, nChunks, 1, [&](size_t k0, size_t k1)
+	{
+		for (size_t k = k0; k < k1; k++)
+		{
+			uint64_t state = Canopy_Stream(seed, k + 1);
+			double gap = 0;
+			for (size_t r = k * CANOPY_RAY_CHUNK; r < GSL_MIN((k + 1) * CANOPY_RAY_CHUNK, nRays); r++)
+			{
+				const double o[3] = { L * Canopy_Uniform(&state), L * Canopy_Uniform(&state), 0 };
+				const double azimuth = 2 * M_PI * Canopy_Uniform(&state);
+				const double d[3] = { sin(zenith) * cos(azimuth), sin(zenith) * sin(azimuth), cos(zenith) };
+				double path = Canopy_Trace(&bvh, scene->shape, o, d);
+				if (path > 0)
+					gap += exp(-extinction * path);
+				lengths[r] = (float)path;
+			}
+			chunkGap[k] = gap;
+		}
+	});
+
+	size_t nHits = 0;
+	double gap = 0;
+	for (size_t k = 0; k < nChunks; k++)
+		gap += chunkGap[k];
+	for (size_t r = 0; r < nRays; r++)
+		if (lengths[r] > 0)
+			lengths[nHits++] = lengths[r];
+	lengths.resize(nHits);
+
+	sim->nRays = nRays;
+	sim->largeGaps = (double)(nRays - nHits) / nRays;
+	sim->gapFraction = nHits ? gap / nHits : 1.0;
+	return nHits ? GSL_SUCCESS : GSL_EDOM;
+}
+
+
+//5 header lines of the input files
+static void Canopy_Header(FILE *f, const struct canopy_scene *scene, const struct canopy_sim *sim)
+{
+	fprintf(f, "%.6f\t\t%% P_canopy, Gap fraction inside canopy (after removing large gaps)\n", sim->gapFraction);
+	fprintf(f, "%.6f\t\t%% P_large, Gap fraction of large gaps, simulated: true LAI %.6f\n", sim->largeGaps, sim->trueLAI);
+	fprintf(f, "%g\t\t%% Observing zenith angle (degree)\n", scene->zenith);
+	fprintf(f, "%g\t\t%% G function\n", scene->G);
+	fprintf(f, "-1\t\t%% Mode: path lengths below (m)\n");
+}
+
+
+//************************************
+// Method:    CanopySim_Write		Plot as an input file: text, or binary (.npy, .f32, .f64) with its header in the .hdr sidecar
+// FullName:  CanopySim_Write
+// Access:    public
+// Returns:   int					GSL_SUCCESS, GSL_EFAILED (cannot write)
+// Qualifier:
+// Parameter: const char * fname	format by the extension (LAIPathBinary_Format)
+// Parameter: const canopy_scene * scene
+// Parameter: const canopy_sim * sim
+//************************************
+int CanopySim_Write(const char *fname, const struct canopy_scene *scene, const struct canopy_sim *sim)
+{
+	const int format = LAIPathBinary_Format(fname);
+	const std::vector<float> &lengths = sim->pathLengths;
+	bool ok;
+	if (format == INPUT_TEXT)
+	{
+		FILE *f;
+		if (fopen_s(&f, fname, "w") != 0)
+			return GSL_EFAILED;
+		Canopy_Header(f, scene, sim);
+		for (size_t i = 0; i < lengths.size(); i++)
+			fprintf(f, "%.7g\n", lengths[i]);
+		ok = (ferror(f) == 0);
+		return (fclose(f) == 0 && ok) ? GSL_SUCCESS : GSL_EFAILED;
+	}
+
+	std::string sidecar(fname, strrchr(fname, '.'));
+	sidecar += BINARY_HEADER_EXT;
+	FILE *f;
+	if (fopen_s(&f, sidecar.c_str(), "w") != 0)
+		return GSL_EFAILED;
+	Canopy_Header(f, scene, sim);
+	ok = (ferror(f) == 0);
+	if (fclose(f) != 0 || !ok)
+		return GSL_EFAILED;
+
+	if (fopen_s(&f, fname, "wb") != 0)
+		return GSL_EFAILED;
+	if (LAIPathBinary_IsNpy(fname))
+	{
+		//NPY 1.0: magic, version, length of the dictionary, dictionary padded with blanks and '\n'
+		char dict[128];
+		int len = snprintf(dict, sizeof(dict), "{'descr': '<f4', 'fortran_order': False, 'shape': (%zu,), }", lengths.size());
+		const int total = (10 + len + 1 + NPY_ALIGN - 1) / NPY_ALIGN * NPY_ALIGN;
+		memset(dict + len, ' ', total - 10 - len - 1);
+		dict[total - 10 - 1] = '\n';
+		const unsigned char preamble[10] = { 0x93, 'N', 'U', 'M', 'P', 'Y', 1, 0,
+			(unsigned char)((total - 10) & 0xFF), (unsigned char)((total - 10) >> 8) };
+		fwrite(preamble, 1, sizeof(preamble), f);
+		fwrite(dict, 1, total - 10, f);
+	}
+	if (format == INPUT_FLOAT32)
+		fwrite(lengths.data(), sizeof(float), lengths.size(), f);
+	else
+		for (size_t i = 0; i < lengths.size(); i++)
+		{
+			double value = lengths[i];
+			fwrite(&value, sizeof(double), 1, f);
+		}
+	ok = (ferror(f) == 0);
+	return (fclose(f) == 0 && ok) ? GSL_SUCCESS : GSL_EFAILED;
+}
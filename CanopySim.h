@@ -0,0 +1,99 @@
+/*!
+* \file CanopySim.h
+* \date
+*			2026/10/17	Monte Carlo canopy of turbid crowns: gap fractions and path lengths with known LAI
+*
+* \brief
+*		Crowns (ellipsoids or cones, apex up) filled with leaves of density lad (m2/m3) stand
+*		on a square plot, periodic at its edges, in a random, regular or clumped pattern.
+*		Rays start at random points of the ground towards zenith angle zenith (random azimuth)
+*		and are traced through a BVH over the crowns; the path length of a ray is the sum of
+*		its chords through the crowns it crosses (overlapping crowns add up). Per plot:
+*			large gaps		fraction of rays without crown
+*			gap fraction	mean exp(-G * lad * path length) of the other rays (expected, not drawn)
+*			path lengths	of the other rays, in m
+*			true LAI		lad * volume of the crowns / plot area
+*		written as an input file (text, or binary with its .hdr sidecar, LAIPathBinary.h).
+*		Rays are traced in chunks of CANOPY_RAY_CHUNK by LaiPathPool, each chunk with its own
+*		random numbers: the results do not depend on the number of threads.
+*
+*		Scene file, one "key value" per line, '%' starts a comment (defaults: CanopySim_Default):
+*			plot_size		side of the plot (m)
+*			crowns			crowns per plot
+*			shape			ellipsoid or cone
+*			crown_radius	horizontal radius (m)
+*			crown_height	vertical extent of a crown (m)
+*			crown_base		height of the bottom of the crowns (m)
+*			size_variation	radius and height vary uniformly by +- this fraction
+*			lad				leaf area density (m2/m3)
+*			G				leaf projection function
+*			pattern			random, regular or clumped
+*			cluster_size	clumped: mean crowns per cluster
+*			cluster_radius	clumped: standard deviation of the crowns around their cluster (m)
+*			zenith			zenith angle of the rays (degree, < 89)
+*			rays			rays per plot
+*			seed			plot k of a run uses seed + k
+*
+*/
+
+#pragma once
+
+#include <cstdio>
+#include <stdint.h>
+#include <vector>
+
+#include "LaiPathPool.h"
+
+#define CANOPY_ELLIPSOID	0
+#define CANOPY_CONE			1
+
+#define CANOPY_RANDOM		0
+#define CANOPY_REGULAR		1
+#define CANOPY_CLUMPED		2
+
+#define CANOPY_RAY_CHUNK	65536
+#define CANOPY_BVH_LEAF		4			//crowns per leaf of the BVH
+#define CANOPY_MAX_ZENITH	89
+
+struct canopy_scene
+{
+	double plotSize;
+	size_t nCrowns;
+	int shape;
+	double crownRadius;
+	double crownHeight;
+	double crownBase;
+	double sizeVariation;
+	double lad;
+	double G;
+	int pattern;
+	double clusterSize;
+	double clusterRadius;
+	double zenith;
+	size_t nRays;
+	uint64_t seed;
+};
+
+struct canopy_crown
+{
+	double x, y;			//center on the ground
+	double base;			//height of the bottom
+	double radius;
+	double height;			//vertical extent
+};
+
+//one simulated plot
+struct canopy_sim
+{
+	double trueLAI;
+	double gapFraction;		//inside canopy
+	double largeGaps;
+	size_t nRays;
+	std::vector<float> pathLengths;		//rays through crowns, m
+	std::vector<struct canopy_crown> crowns;
+};
+
+void CanopySim_Default(struct canopy_scene *scene);
+int CanopySim_ReadScene(const char *fname, struct canopy_scene *scene, FILE *report = stderr);
+int CanopySim_Plot(LaiPathPool &pool, const struct canopy_scene *scene, uint64_t seed, struct canopy_sim *sim);
+int CanopySim_Write(const char *fname, const struct canopy_scene *scene, const struct canopy_sim *sim);
@@ -0,0 +1,286 @@
+/*!
+* \file CircleLUT.cpp
+* \date
+*			2026/10/17	Lookup table of LAImax(gap fraction) for the ellipse section assumption
+*
+* \brief
+*		Tabulate, map and interpolate LAImax of the ellipse section assumption (LAI_PATH_Circle).
+*
+*/
+
+#include <string.h>
+
+#include "CircleLUT.h"
+#include "LAIPathCompat.h"
+
+static const char CIRCLE_LUT_MAGIC[8] = "LAIPLUT";
+
+
+//************************************
+// Method:    CircleLUT_Solve	LAImax and dLAImax/dt of the ellipse section assumption at t = -ln(gap fraction)
+// FullName:  CircleLUT_Solve
+// Access:    private 
+// Returns:   double				LAImax
+// Qualifier:
+// Parameter: double t				-ln(gap fraction)
+// Parameter: double * slope		dLAImax/dt (for return)
+// Parameter: int * status			status of Solve_LAImax (for return), GSL_EINVAL: no root in the bracket
+//************************************
+static double CircleLUT_Solve(double t, double *slope, int *status)
+{
+	double gapFraction = exp(-t);
+	struct dualParams params = { gapFraction, 1.0 };	//int P(lr) = 1
+	struct solver_info info;
+	double f, df, d2f;
+
+	if (t <= 0)
+	{
+		Func_GapBiasFromLAImax_Circle_fdf(0, &params, &f, &df, &d2f);
+		*slope = -1 / df;
+		*status = GSL_SUCCESS;
+		return 0;
+	}
+
+	Solve_LAImax(&Func_GapBiasFromLAImax_Circle_fdf, &params, t, 20 * t, t / M_PI_4, 1e-12, 100, &info);
+	*status = info.status;
+
+	Func_GapBiasFromLAImax_Circle_fdf(info.LAImax, &params, &f, &df, &d2f);
+	*slope = -gapFraction / df;
+	return info.LAImax;
+}
+
+
+//************************************
+// Method:    CircleLUT_Hermite	Cubic Hermite interpolation inside cell i
+// FullName:  CircleLUT_Hermite
+// Access:    private 
+// Returns:   double
+// Qualifier:
+// Parameter: const double * y, * d		values and slopes at nodes
+// Parameter: size_t i					cell index
+// Parameter: double s					position in cell [0, 1]
+// Parameter: double h					node spacing
+//************************************
+static inline double CircleLUT_Hermite(const double *y, const double *d, size_t i, double s, double h)
+{
+	double s2 = s * s, s3 = s2 * s;
+	return (2 * s3 - 3 * s2 + 1) * y[i] + (s3 - 2 * s2 + s) * h * d[i]
+		+ (-2 * s3 + 3 * s2) * y[i + 1] + (s3 - s2) * h * d[i + 1];
+}
+
+
+//************************************
+// Method:    CircleLUT_Build	Tabulate LAImax(t = -ln(gap fraction)) of LAI_PATH_Circle into a binary file
+// FullName:  CircleLUT_Build
+// Access:    public 
+// Returns:   int					0 on success, -1 if LAImax is not solved at every node or the file cannot be written
+// Qualifier:
+// Parameter: const char * fname	output file
+// Parameter: uint32_t n			number of nodes
+// Parameter: double t_max			table range of -ln(gap fraction)
+// Parameter: FILE * report			print the measured interpolation error if not NULL
+//************************************
+int CircleLUT_Build(const char *fname, uint32_t n, double t_max, FILE *report)
+{
+	struct circle_lut_header header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, CIRCLE_LUT_MAGIC, sizeof(header.magic));
+	header.version = CIRCLE_LUT_VERSION;
+	header.n = n;
+	header.t_min = 0;
+	header.t_max = t_max;
+
+	double h = (header.t_max - header.t_min) / (n - 1);
+	double *y = new double[n];
+	double *d = new double[n];
+
+	//first node or midpoint where Solve_LAImax fails
+	int solveStatus = GSL_SUCCESS;
+	double failedT = 0;
+	for (uint32_t i = 0; i < n; i++)
+	{
+		int s;
+		y[i] = CircleLUT_Solve(header.t_min + i * h, &d[i], &s);
+		if (s != GSL_SUCCESS && solveStatus == GSL_SUCCESS)
+		{
+			solveStatus = s;
+			failedT = header.t_min + i * h;
+		}
+	}
+
+	//Fritsch-Carlson: keep the interpolant monotone
+	for (uint32_t i = 0; i + 1 < n; i++)
+	{
+		double delta = (y[i + 1] - y[i]) / h;
+		double alpha = d[i] / delta, beta = d[i + 1] / delta;
+		double r2 = alpha * alpha + beta * beta;
+		if (r2 > 9)
+		{
+			double tau = 3 / sqrt(r2);
+			d[i] = tau * alpha * delta;
+			d[i + 1] = tau * beta * delta;
+		}
+	}
+
+	//measure the error at cell midpoints
+	for (uint32_t i = 0; i + 1 < n; i++)
+	{
+		double slope;
+		int s;
+		double exact = CircleLUT_Solve(header.t_min + (i + 0.5) * h, &slope, &s);
+		if (s != GSL_SUCCESS && solveStatus == GSL_SUCCESS)
+		{
+			solveStatus = s;
+			failedT = header.t_min + (i + 0.5) * h;
+		}
+		double err = fabs(CircleLUT_Hermite(y, d, i, 0.5, h) - exact);
+		header.maxError = GSL_MAX(header.maxError, err);
+		if (exact > 0)
+			header.maxRelError = GSL_MAX(header.maxRelError, err / exact);
+	}
+
+	int status = -1;
+	FILE *fout = 0;
+	if (solveStatus != GSL_SUCCESS)
+	{
+		if (report)
+			fprintf(report, "ERROR: LAImax of the ellipse LUT not solved at -ln(gap fraction) = %.4f (%s), t_max too large\n",
+				failedT, gsl_strerror(solveStatus));
+	}
+	else if (fopen_s(&fout, fname, "wb") == 0)
+	{
+		if (fwrite(&header, sizeof(header), 1, fout) == 1
+			&& fwrite(y, sizeof(double), n, fout) == n
+			&& fwrite(d, sizeof(double), n, fout) == n)
+			status = 0;
+		if (fclose(fout) != 0)
+			status = -1;
+	}
+
+	if (report)
+		fprintf(report, "Ellipse LUT: %u nodes, -ln(gap fraction) in [%.1f, %.1f], max error of LAImax %.3e (relative %.3e)\n",
+			n, header.t_min, header.t_max, header.maxError, header.maxRelError);
+
+	delete[] y;
+	delete[] d;
+
+	return status;
+}
+
+
+//************************************
+// Method:    CircleLUT_Open	Memory map a table written by CircleLUT_Build
+// FullName:  CircleLUT_Open
+// Access:    public 
+// Returns:   circle_lut *			NULL if the file is missing, truncated or of another version
+// Qualifier:
+// Parameter: const char * fname	table file
+//************************************
+struct circle_lut *CircleLUT_Open(const char *fname)
+{
+	struct circle_lut *lut = new struct circle_lut;
+	if (MappedFile_Open(&lut->file, fname) != 0)
+	{
+		delete lut;
+		return 0;
+	}
+
+	const struct circle_lut_header *header = reinterpret_cast<const struct circle_lut_header *>(lut->file.data);
+	if (lut->file.size < sizeof(struct circle_lut_header)
+		|| memcmp(header->magic, CIRCLE_LUT_MAGIC, sizeof(header->magic)) != 0
+		|| header->version != CIRCLE_LUT_VERSION
+		|| header->n < 2
+		|| lut->file.size != sizeof(struct circle_lut_header) + 2 * sizeof(double) * header->n)
+	{
+		CircleLUT_Close(lut);
+		return 0;
+	}
+
+	lut->header = header;
+	lut->LAImax = reinterpret_cast<const double *>(lut->file.data + sizeof(struct circle_lut_header));
+	lut->slope = lut->LAImax + header->n;
+	lut->h = (header->t_max - header->t_min) / (header->n - 1);
+
+	return lut;
+}
+
+
+//************************************
+// Method:    CircleLUT_Close	Unmap and free a table
+// FullName:  CircleLUT_Close
+// Access:    public 
+// Returns:   void
+// Qualifier:
+// Parameter: circle_lut * lut
+//************************************
+void CircleLUT_Close(struct circle_lut *lut)
+{
+	if (!lut)
+		return;
+	MappedFile_Close(&lut->file);
+	delete lut;
+}
+
+
+//************************************
+// Method:    CircleLUT_LAImax	Interpolate LAImax of the ellipse section assumption
+// FullName:  CircleLUT_LAImax
+// Access:    public 
+// Returns:   double					LAImax, or -1 if gapFraction is outside the table
+// Qualifier:
+// Parameter: const circle_lut * lut
+// Parameter: double gapFraction		Total gap fraction
+//************************************
+double CircleLUT_LAImax(const struct circle_lut *lut, double gapFraction)
+{
+	const struct circle_lut_header *header = lut->header;
+	double t = -log(gapFraction);
+
+	if (!(t >= header->t_min && t <= header->t_max))
+		return -1;
+
+	double u = (t - header->t_min) / lut->h;
+	size_t i = static_cast<size_t>(u);
+	if (i >= header->n - 1)
+		i = header->n - 2;
+
+	return CircleLUT_Hermite(lut->LAImax, lut->slope, i, u - i, lut->h);
+}
+
+
+//************************************
+// Method:    LAI_PATH_Circle_LUT	LAI_PATH_Circle evaluated from the lookup table
+// FullName:  LAI_PATH_Circle_LUT
+// Access:    public 
+// Returns:   double				True LAI
+// Qualifier:
+// Parameter: const circle_lut * lut	table (NULL: LAI_PATH_Circle)
+// Parameter: double gapFraction	Total gap fraction
+// Parameter: double zenith			Zenith angle (degree) of data 
+// Parameter: double G				Leaf projection function G
+// Parameter: solver_info * info	LAImax and mean path length (iter = nEval = 0 if tabulated)
+//************************************
+double LAI_PATH_Circle_LUT(const struct circle_lut *lut, double gapFraction, double zenith, double G, struct solver_info *info)
+{
+	double LAImax = lut ? CircleLUT_LAImax(lut, gapFraction) : -1;
+	if (LAImax < 0)
+		return LAI_PATH_Circle(gapFraction, zenith, G, info);
+
+	//int lr*P(lr) = pi/4 for the normalized ellipse section distribution
+	if (info)
+	{
+		info->status = GSL_SUCCESS;
+		info->iter = 0;
+		info->nEval = 0;
+		info->LAImax = LAImax;
+		info->meanPath = M_PI_4;
+		info->zeroPath = 0;
+		info->nPathProb = 0;
+		info->nIntervals = 0;
+		info->maxIntervals = 0;
+		info->nBracketFail = 0;
+		info->fallback = 0;
+	}
+
+	return LAImax * M_PI_4 / G * cos(zenith*M_PI / 180);
+}
@@ -5,6 +5,13 @@
  *			2013/06/21 (standalone version)	New : Path length distribution inversed from measured gap data 
  *			2013/06/23 (GSL version)		Rewrite: Migrate to GSL library to improve speed   
  *			2016/12/13 (GSL version)		Distribute
+ *			2026/10/16 (GSL version)		New : Closed form of Eq(13) for histogram path length distribution (no quadrature)
+ *			2026/10/16 (GSL version)		New : Halley/Newton solver of LAImax with analytic derivatives
+ *			2026/10/17 (GSL version)		New : Ellipse section assumption in closed form (modified Bessel and Struve functions)
+ *			2026/10/17 (GSL version)		New : GSL error state per thread (reentrant LAI_PATH)
+ *			2026/10/17 (GSL version)		New : Geometric bracketing with warm start, path lengths close to 0 handled in LAI_PATH
+ *			2026/10/17 (GSL version)		New : Numerical work of the solves (integrand evaluations, quadrature subintervals, bracket failures)
+ *			2026/10/17 (GSL version)		Fix : Halley/Newton step below epsabs converges also if it rounds to an end of the bracket (was bisected)
  *
  * \author Ronghai Hu
  * Contact: huronghai@ucas.edu.cn
@@ -25,6 +32,28 @@
  *
 */
 #include "LAIPath.h"
+#include "PathHist.h"
+#include "LAIPathProfile.h"
+#include "LAIPathCounters.h"
+
+//numerical work of the calling thread, reported per solve as differences (solver_info)
+struct work_counters
+{
+	long long nPathProb;
+	long long nIntervals;
+	int maxIntervals;		//since the start of the solve
+};
+
+static thread_local struct work_counters t_work = { 0, 0, 0 };
+
+static inline void Work_Quadrature(const gsl_integration_workspace *w)
+{
+	t_work.nIntervals += w->size;
+	t_work.maxIntervals = GSL_MAX(t_work.maxIntervals, (int)w->size);
+}
+
+//LAI_PATH_SetTolerance, read by the solves of all threads
+static struct lai_path_tolerance g_tolerance = { LAI_PATH_EPSABS, LAI_PATH_EPSREL };
 
 
 //************************************
@@ -37,67 +66,189 @@
 // Parameter: double gapFraction		Total gap fraction
 // Parameter: double zenith				Zenith angle (degree) of data 
 // Parameter: double G					Leaf projection function G
+// Parameter: int integration			LAI_PATH_ANALYTIC, LAI_PATH_QUADRATURE or LAI_PATH_COMPARE
+// Parameter: solver_info * info		Iterations, evaluations and status of the LAImax solve (optional)
 //************************************
-double LAI_PATH(gsl_histogram *pathHist, double gapFraction, double zenith, double G)
+double LAI_PATH(gsl_histogram *pathHist, double gapFraction, double zenith, double G, int integration, struct solver_info *info)
 {
-	double effLAI = -log(gapFraction);
-	struct params_GapBiasFromLAImax params = { pathHist, gapFraction };
+	//only the quadrature needs workspaces (see LaiPathSolver to reuse them)
+	gsl_integration_workspace *w = 0;
+	gsl_root_fsolver *s = 0;
+	if (integration != LAI_PATH_ANALYTIC)
+		w = gsl_integration_workspace_alloc(1000);
+	if (integration == LAI_PATH_QUADRATURE)
+		s = gsl_root_fsolver_alloc(gsl_root_fsolver_brent);
 
-	//1.Resolve LAImax
-	int status;
-	int iter = 0, max_iter = 100;
+	double LAI = LAI_PATH_Workspace(pathHist, gapFraction, zenith, G, integration, info, w, s);
 
-	double r_LAImax = 0, r_expected = effLAI;
-	double x_lo = effLAI, x_hi = effLAI * 10;
+	if (s) gsl_root_fsolver_free(s);
+	if (w) gsl_integration_workspace_free(w);
 
-	double f_lo = Func_GapBiasFromLAImax(x_lo, &params);
-	double f_hi = Func_GapBiasFromLAImax(x_hi, &params);
-	if ((f_lo < 0.0 && f_hi < 0.0) || (f_lo > 0.0 && f_hi > 0.0))
-	{
-		return LAI_MAX;
-		printf("endpoints do not straddle y=0\n");
-	}
-
-	gsl_function F;
-	F.function = &Func_GapBiasFromLAImax;
+	return LAI;
+}
 
-	F.params = &params;
+//************************************
+// Method:    Hist_LAImax		LAImax and mean path length of a histogram path length distribution
+// FullName:  Hist_LAImax
+// Access:    private 
+// Returns:   void
+// Qualifier:
+// Parameter: gsl_histogram * pathHist	Path length distribution, its integral is mass
+// Parameter: double gapFraction		Total gap fraction
+// Parameter: double mass				int P(lr) of pathHist (normalization)
+// Parameter: int integration			LAI_PATH_ANALYTIC, LAI_PATH_QUADRATURE or LAI_PATH_COMPARE
+// Parameter: double seed				Initial guess of LAImax (Halley), 0: lower bound effLAI / mean path length
+// Parameter: gsl_integration_workspace * w, gsl_root_fsolver * s	see LAI_PATH_Workspace
+// Parameter: solver_info * info		LAImax, mean path length, iterations and status (for return)
+//************************************
+static void Hist_LAImax(gsl_histogram *pathHist, double gapFraction, double mass, int integration, double seed,
+	gsl_integration_workspace *w, gsl_root_fsolver *s, struct solver_info *info)
+{
+	double effLAI = -log(gapFraction);
+	struct params_GapBiasFromLAImax params = { pathHist, gapFraction * mass, w };
 
-	const gsl_root_fsolver_type *T;
-	gsl_root_fsolver *s;
-	T = gsl_root_fsolver_brent;
-	s = gsl_root_fsolver_alloc(T);
-	status = gsl_root_fsolver_set(s, &F, x_lo, x_hi);
+	double r_LAImax = 0;
+	double x_lo = effLAI, x_hi = effLAI * LAI_PATH_BRACKET;
+	double integralWeightedPath;
 
-	do
+	if (integration == LAI_PATH_QUADRATURE)
 	{
-		iter++;
-		status = gsl_root_fsolver_iterate(s);
-		r_LAImax = gsl_root_fsolver_root(s);
-		x_lo = gsl_root_fsolver_x_lower(s);
- 		x_hi = gsl_root_fsolver_x_upper(s);
-		status = gsl_root_test_interval(x_lo, x_hi,
-			0, 0.0001);
-	} while (status == GSL_CONTINUE && iter < max_iter);
-
-	gsl_root_fsolver_free(s);
-
-	//2.Interation: lr*P(lr)
-	F.function = &Func_WeightedPath;
-	F.params = pathHist;
-
-	gsl_integration_workspace * w
-		= gsl_integration_workspace_alloc(1000);
-	double integralWeightedPath, error;
-	double *pts = pathHist->range;
+		//1.Resolve LAImax
+		LAI_PROFILE_SCOPE("LAImax Brent");
+		LaiPathCounterScope rootCounter(COUNTER_ROOT);
+		int status;
+		int iter = 0, max_iter = 100;
+
+		double f_lo = Func_GapBiasFromLAImax(x_lo, &params);
+		double f_hi = Func_GapBiasFromLAImax(x_hi, &params);
+		info->iter = 0;
+		info->nEval = 2;
+		if ((f_lo < 0.0 && f_hi < 0.0) || (f_lo > 0.0 && f_hi > 0.0))
+		{
+			info->status = GSL_EINVAL;		//endpoints do not straddle y=0
+			return;
+		}
+
+		gsl_function F;
+		F.function = &Func_GapBiasFromLAImax;
+
+		F.params = &params;
+
+		status = gsl_root_fsolver_set(s, &F, x_lo, x_hi);
+		info->nEval += 2;
+
+		do
+		{
+			iter++;
+			status = gsl_root_fsolver_iterate(s);
+			r_LAImax = gsl_root_fsolver_root(s);
+			x_lo = gsl_root_fsolver_x_lower(s);
+			x_hi = gsl_root_fsolver_x_upper(s);
+			status = gsl_root_test_interval(x_lo, x_hi,
+				0, g_tolerance.epsabs);
+		} while (status == GSL_CONTINUE && iter < max_iter);
+
+		info->iter = iter;
+		info->nEval += iter;
+		info->status = (status == GSL_CONTINUE) ? GSL_EMAXITER : status;
+		info->LAImax = r_LAImax;
+		rootCounter.Stop();
+
+		//2.Interation: lr*P(lr)
+		F.function = &Func_WeightedPath;
+		F.params = pathHist;
+
+		double error;
+		double *pts = pathHist->range;
+
+		LAI_PROFILE_SCOPE("weighted path qagp");
+		LaiPathCounterScope integralCounter(COUNTER_INTEGRAL);
+		gsl_integration_qagp(&F, pts, pathHist->n + 1, 0, g_tolerance.epsrel, 1000,
+			w, &integralWeightedPath, &error);
+		Work_Quadrature(w);
+		info->meanPath = integralWeightedPath / mass;
+	}
+	else
+	{
+		//2.Interation: lr*P(lr), needed first: effLAI / mean path length is a lower bound of LAImax (Jensen)
+		{
+			LAI_PROFILE_SCOPE("weighted path");
+			LaiPathCounterScope counter(COUNTER_INTEGRAL);
+			integralWeightedPath = Hist_WeightedPath(pathHist);
+		}
+		info->meanPath = integralWeightedPath / mass;
+
+		//1.Resolve LAImax, Halley iterations started from the seed or the lower bound
+		LAI_PROFILE_SCOPE("LAImax Halley");
+		LaiPathCounterScope rootCounter(COUNTER_ROOT);
+		double x0 = (seed > 0) ? seed : GSL_MAX(x_lo, effLAI / info->meanPath);
+		Solve_LAImax(&Func_GapBiasFromLAImax_fdf, &params, x_lo, x_hi, x0, g_tolerance.epsabs, 100, info);
+		rootCounter.Stop();
+
+		if (integration == LAI_PATH_COMPARE && info->status != GSL_EINVAL)
+			Hist_CompareQuadrature(pathHist, info->LAImax, stderr, w);
+	}
+}
 
-	gsl_integration_qagp(&F, pts, pathHist->n + 1, 0, 1e-7, 1000,
-		w, &integralWeightedPath, &error);
+//************************************
+// Method:    LAI_PATH_Workspace	LAI_PATH with caller-owned workspaces (no allocation)
+// FullName:  LAI_PATH_Workspace
+// Access:    public 
+// Returns:   double					True LAI of Path length distribution model
+// Qualifier:
+// Parameter: gsl_histogram * pathHist	Path length distribution (Histrgram format)
+// Parameter: double gapFraction		Total gap fraction
+// Parameter: double zenith				Zenith angle (degree) of data 
+// Parameter: double G					Leaf projection function G
+// Parameter: int integration			LAI_PATH_ANALYTIC, LAI_PATH_QUADRATURE or LAI_PATH_COMPARE
+// Parameter: solver_info * info		Iterations, evaluations and status of the LAImax solve (optional)
+// Parameter: gsl_integration_workspace * w	Workspace of the quadrature (LAI_PATH_QUADRATURE, LAI_PATH_COMPARE)
+// Parameter: gsl_root_fsolver * s		Brent solver (LAI_PATH_QUADRATURE)
+// Parameter: double seed				Initial guess of LAImax, e.g. of the previous plot (0: none)
+//************************************
+double LAI_PATH_Workspace(gsl_histogram *pathHist, double gapFraction, double zenith, double G, int integration, struct solver_info *info,
+	gsl_integration_workspace *w, gsl_root_fsolver *s, double seed)
+{
+	LAI_PROFILE_SCOPE("LAI_PATH");
+	struct solver_info _info = {};			//GSL_SUCCESS (0), no work
+	double mass = 1;
+	const struct work_counters work = t_work;
+	t_work.maxIntervals = 0;
+
+	Hist_LAImax(pathHist, gapFraction, mass, integration, seed, w, s, &_info);
+	_info.nBracketFail = (_info.status == GSL_EINVAL);
+
+	//Fix 2023-03-12 (formerly a second solve in example.cpp): too much path lengths close to 0 leave no root,
+	//the first bin is taken as large gaps and the rest of the distribution is solved
+	if (_info.status == GSL_EINVAL && pathHist->n > 1 && pathHist->bin[0] > 0)
+	{
+		gsl_histogram rest = { pathHist->n - 1, pathHist->range + 1, pathHist->bin + 1 };
+		int iter = _info.iter, nEval = _info.nEval;
+
+		_info.zeroPath = pathHist->bin[0] * (pathHist->range[1] - pathHist->range[0]);
+		mass = 1 - _info.zeroPath;
+		Hist_LAImax(&rest, gapFraction, mass, integration, 0, w, s, &_info);
+		_info.iter += iter;
+		_info.nEval += nEval;
+		_info.nBracketFail += (_info.status == GSL_EINVAL);
+		if (_info.status != GSL_EINVAL)
+			_info.status = (_info.status == GSL_SUCCESS) ? LAI_PATH_ZERO_PATH : _info.status;
+	}
 
-	gsl_integration_workspace_free(w);
+	_info.nPathProb = t_work.nPathProb - work.nPathProb;
+	_info.nIntervals = (int)(t_work.nIntervals - work.nIntervals);
+	_info.maxIntervals = t_work.maxIntervals;
+	if (_info.status == GSL_EINVAL)
+	{
+		_info.LAImax = LAI_MAX;
+		_info.fallback = 1;
+		if (info) *info = _info;
+		return LAI_MAX;
+	}
+	if (info) *info = _info;
 
-	//Return true LAI
-	return r_LAImax * integralWeightedPath / G * cos(zenith*M_PI / 180);
+	//Return true LAI, path lengths close to 0 are gaps
+	return _info.LAImax * _info.meanPath * mass / G * cos(zenith*M_PI / 180);
 }
 
 //************************************
@@ -110,72 +261,41 @@ double LAI_PATH(gsl_histogram *pathHist, double gapFraction, double zenith, doub
 // Parameter: double gapFraction	Total gap fraction
 // Parameter: double zenith			Zenith angle (degree) of data 
 // Parameter: double G				Leaf projection function G
+// Parameter: solver_info * info	Iterations, evaluations and status of the LAImax solve (optional)
 //************************************
-double LAI_PATH_Circle(double gapFraction, double zenith, double G)
+double LAI_PATH_Circle(double gapFraction, double zenith, double G, struct solver_info *info)
 {
 	double effLAI = -log(gapFraction) / G * cos(zenith*M_PI / 180);
+	struct solver_info _info = {};			//GSL_SUCCESS (0), no work
 
-	//calculate the normalization coefficient
-	gsl_function F;
-	F.function = &Func_PathProb_Circle;
-
-	gsl_integration_workspace * w
-		= gsl_integration_workspace_alloc(1000);
-	double normalizedScale, error;
+	//normalization coefficient int P(lr) = 1 and int lr*P(lr) = pi/4 are exact (no quadrature)
+	double normalizedScale = 1;
+	double integralWeightedPath = M_PI_4;
 
-	gsl_integration_qags(&F, 0, 1, 0, 1e-7, 1000,
-		w, &normalizedScale, &error);
-
-	gsl_integration_workspace_free(w);
-
-	//1.Resolve LAImax
-	int status;
-	int iter = 0, max_iter = 100;
-	const gsl_root_fsolver_type *T;
-	gsl_root_fsolver *s;
-	double r_LAImax = 0, r_expected = effLAI;
+	//1.Resolve LAImax, Halley iterations started from the lower bound effLAI / mean path length
 	double x_lo = effLAI * G / cos(zenith*M_PI / 180), x_hi = x_lo * 20;
 
-	F.function = &Func_GapBiasFromLAImax_Circle;
-
 	struct dualParams params = { gapFraction,normalizedScale };
-	F.params = &params;
-
-	T = gsl_root_fsolver_brent;
-	s = gsl_root_fsolver_alloc(T);
-	gsl_root_fsolver_set(s, &F, x_lo, x_hi);
 
-	do
+	double x0 = GSL_MAX(x_lo, x_lo / integralWeightedPath);
+	LAI_PROFILE_SCOPE("LAImax circle");
+	LaiPathCounterScope rootCounter(COUNTER_ROOT);
+	Solve_LAImax(&Func_GapBiasFromLAImax_Circle_fdf, &params, x_lo, x_hi, x0, g_tolerance.epsabs, 100, &_info);
+	rootCounter.Stop();
+	if (_info.status == GSL_EINVAL)
 	{
-		iter++;
-		status = gsl_root_fsolver_iterate(s);
-		r_LAImax = gsl_root_fsolver_root(s);
-		x_lo = gsl_root_fsolver_x_lower(s);
-		x_hi = gsl_root_fsolver_x_upper(s);
-		status = gsl_root_test_interval(x_lo, x_hi,
-			0, 0.0001);
-
-	} while (status == GSL_CONTINUE && iter < max_iter);
-
-	gsl_root_fsolver_free(s);
-
-
-	//2.Interation: lr*P(lr)
-	F.function = &Func_WeightedPath_Circle;
-
-	gsl_integration_workspace * w2
-		= gsl_integration_workspace_alloc(1000);
-	double integralWeightedPath;
-
-	gsl_integration_qags(&F, 0, 1, 0, 1e-7, 1000,
-		w2, &integralWeightedPath, &error);
-
-	gsl_integration_workspace_free(w2);
+		_info.LAImax = LAI_MAX;
+		_info.nBracketFail = 1;
+		_info.fallback = 1;
+		if (info) *info = _info;
+		return LAI_MAX;
+	}
 
-	integralWeightedPath /= normalizedScale;
+	_info.meanPath = integralWeightedPath;
+	if (info) *info = _info;
 
 	//Return true LAI
-	return r_LAImax * integralWeightedPath / G * cos(zenith*M_PI / 180);
+	return _info.LAImax * integralWeightedPath / G * cos(zenith*M_PI / 180);
 }
 
 
@@ -189,12 +309,13 @@ double LAI_PATH_Circle(double gapFraction, double zenith, double G)
 // Parameter: double effLAI			Effective LAI (LAIe)
 // Parameter: double zenith			Zenith angle (degree) of data 
 // Parameter: double G				Leaf projection function G
+// Parameter: solver_info * info	Iterations, evaluations and status of the LAImax solve (optional)
 //************************************
-double LAIe2LAI_PATH_Circle(double effLAI, double zenith, double G)
+double LAIe2LAI_PATH_Circle(double effLAI, double zenith, double G, struct solver_info *info)
 {
 	double gapFraction = exp(-effLAI * G / cos(zenith*M_PI / 180));
 	
-	return LAI_PATH_Circle(gapFraction, zenith, G);
+	return LAI_PATH_Circle(gapFraction, zenith, G, info);
 }
 
 //************************************
@@ -202,26 +323,23 @@ double LAIe2LAI_PATH_Circle(double effLAI, double zenith, double G)
 // FullName:  Stat_hist	
 // Access:    public 
 // Qualifier:
-// Parameter: double* data			path length distribution 
+// Parameter: double* data			path length distribution (normalized to [0,1] in place, see Stat_hist_View)
 // Parameter: DWORD ndata,			Number of path length distribution (size of path_length_data)
 // Parameter: gsl_histogram *		path length distribution histogram (for return)
 //************************************
 void Stat_hist( double * path_length_data, unsigned long ndata, gsl_histogram *out_hist)
 {
+	LAI_PROFILE_SCOPE("Stat_hist");
+	// obtain path length distribution, normalized to total probability 1
+	Stat_hist_View(path_length_data, 1, ndata, out_hist);
+
 	// normalize path length to [0,1]
-	double maxPathLen = gsl_stats_max(path_length_data, 1, ndata);
+	double maxPathLen = PathHist_Max(path_length_data, 1, ndata);
 	for (unsigned long i = 0; i < ndata; i++)  path_length_data[i] /= maxPathLen;
 
-	// obtain path length distribution
-	gsl_histogram_set_ranges_uniform (out_hist, 0, 1);
-	out_hist->range[out_hist->n] = 1 + 1e-6;
-	for(unsigned long i = 0; i < ndata; i++)
-		gsl_histogram_increment(out_hist, path_length_data[i]);
-
-	// normalize total probability to 1
-	gsl_histogram_scale(out_hist, static_cast<double>(out_hist->n) / ndata);
-
 	//Modified: 2016-03-24 by rhhu  improve speed
+	//Modified: 2026-10-17 bins computed by Stat_hist_View (PathHist.h), path lengths are still normalized in place for the callers
+	//Modified: 2026-10-17 NaN path lengths are skipped by the maximum (gsl_stats_max returned NaN: no bin counted)
 }
 
 
@@ -236,6 +354,7 @@ void Stat_hist( double * path_length_data, unsigned long ndata, gsl_histogram *o
 //************************************
 double Func_PathProb(double _pathLen, void *params)  
 {
+	t_work.nPathProb++;
 	gsl_histogram h = *(gsl_histogram*) params;
 	size_t i;
 	gsl_histogram_find(&h, _pathLen, &i);	//find the bin of _pathLen in histogram
@@ -286,7 +405,7 @@ double Func_WeightedPath(double _pathLen, void *params)
 //											Eq(13) in (Hu et al., 2014)  - measured gap fraction
 // Qualifier:
 // Parameter: double LAImax					LAImax
-// Parameter: void * params					Path length distribution histogram
+// Parameter: void * params					params_GapBiasFromLAImax: histogram, gap fraction, workspace (NULL: allocated per call)
 //************************************
 double Func_GapBiasFromLAImax(double LAImax, void* params)
 {
@@ -300,15 +419,18 @@ double Func_GapBiasFromLAImax(double LAImax, void* params)
 	F.params = &par_F;
 
 	//Interation: Equation(13) (Hu et al., 2014, RSE)
-	gsl_integration_workspace * w 
-		= gsl_integration_workspace_alloc (1000);
+	gsl_integration_workspace * w = _params.w;
+	if (w == 0)
+		w = gsl_integration_workspace_alloc (1000);
 	double resGap, error;
 	double *pts = _params.pathHist->range;
 
-	gsl_integration_qagp(&F,pts,_params.pathHist->n + 1,0, 1e-7, 1000,
+	gsl_integration_qagp(&F,pts,_params.pathHist->n + 1,0, g_tolerance.epsrel, 1000,
 		w, &resGap, &error);
+	Work_Quadrature(w);
 
-	gsl_integration_workspace_free (w);
+	if (w != _params.w)
+		gsl_integration_workspace_free (w);
 
 	//ؼ϶ʲֵ
 	return resGap - gapF;
@@ -342,6 +464,7 @@ double Func_GapBiasFromLAImax_Circle(double LAImax, void* params)
 
 	gsl_integration_qags (&F, 0, 1, 0, 1e-7, 1000,
 		w, &resGap, &error); 
+	Work_Quadrature(w);
 
 	gsl_integration_workspace_free (w);
 
@@ -351,5 +474,555 @@ double Func_GapBiasFromLAImax_Circle(double LAImax, void* params)
 }
 
 
+//************************************
+// Method:    Hist_GapFraction	Closed form of Eq(13) for a piecewise-constant path length distribution
+// FullName:  Hist_GapFraction
+// Access:    public 
+// Returns:   double					Simulated gap fraction: sum_i P_i * int_{r_i}^{r_i+1} exp(-LAImax*x) dx
+// Qualifier:
+// Parameter: const gsl_histogram * pathHist	Path length distribution histogram (probability density)
+// Parameter: double LAImax					LAImax
+//************************************
+double Hist_GapFraction(const gsl_histogram *pathHist, double LAImax)
+{
+	const size_t n = pathHist->n;
+	const double *range = pathHist->range;
+	const double *bin = pathHist->bin;
+
+	if (LAImax == 0)
+	{
+		double sum = 0;
+		for (size_t i = 0; i < n; i++)
+			sum += bin[i] * (range[i + 1] - range[i]);
+		return sum;
+	}
+
+	//exp(-L*r_i) is carried from bin to bin, one expm1 per bin keeps narrow bins exact
+	double expLo = exp(-LAImax * range[0]);
+	double sum = 0;
+	for (size_t i = 0; i < n; i++)
+	{
+		double oneMinusExpW = -expm1(-LAImax * (range[i + 1] - range[i]));
+		sum += bin[i] * expLo * oneMinusExpW;
+		expLo -= expLo * oneMinusExpW;
+	}
+
+	return sum / LAImax;
+}
+
+
+//************************************
+// Method:    Hist_WeightedPath	Closed form of int lr*P(lr) for a piecewise-constant path length distribution
+// FullName:  Hist_WeightedPath
+// Access:    public 
+// Returns:   double					Mean (relative) path length: sum_i P_i * (r_i+1^2 - r_i^2) / 2
+// Qualifier:
+// Parameter: const gsl_histogram * pathHist	Path length distribution histogram (probability density)
+//************************************
+double Hist_WeightedPath(const gsl_histogram *pathHist)
+{
+	const double *range = pathHist->range;
+	double sum = 0;
+	for (size_t i = 0; i < pathHist->n; i++)
+		sum += pathHist->bin[i] * (range[i + 1] - range[i]) * (range[i + 1] + range[i]);
+
+	return sum / 2;
+}
+
+
+//************************************
+// Method:    Func_GapBiasFromLAImax_Analytic	cost function of a specific LAImax (closed form)
+// FullName:  Func_GapBiasFromLAImax_Analytic
+// Access:    public 
+// Returns:   double						Same as Func_GapBiasFromLAImax, without quadrature
+// Qualifier:
+// Parameter: double LAImax					LAImax
+// Parameter: void * params					params_GapBiasFromLAImax
+//************************************
+double Func_GapBiasFromLAImax_Analytic(double LAImax, void* params)
+{
+	struct params_GapBiasFromLAImax *_params = (struct params_GapBiasFromLAImax*) params;
+
+	return Hist_GapFraction(_params->pathHist, LAImax) - _params->gapF;
+}
+
+
+//************************************
+// Method:    Hist_CompareQuadrature	Check the closed forms against adaptive quadrature (gsl_integration_qagp)
+// FullName:  Hist_CompareQuadrature
+// Access:    public 
+// Returns:   double					max absolute difference of gap fraction and mean path length
+// Qualifier:
+// Parameter: gsl_histogram * pathHist	Path length distribution histogram
+// Parameter: double LAImax				LAImax at which Eq(13) is compared
+// Parameter: FILE * report				print both results if not NULL
+// Parameter: gsl_integration_workspace * w	workspace of the quadrature (NULL: allocated here)
+//************************************
+double Hist_CompareQuadrature(gsl_histogram *pathHist, double LAImax, FILE *report, gsl_integration_workspace *w)
+{
+	struct params_GapBiasFromLAImax params = { pathHist, 0, w };
+	double gapQuad = Func_GapBiasFromLAImax(LAImax, &params);
+	double gapAnalytic = Hist_GapFraction(pathHist, LAImax);
+
+	gsl_function F;
+	F.function = &Func_WeightedPath;
+	F.params = pathHist;
+
+	gsl_integration_workspace * ws = w ? w : gsl_integration_workspace_alloc(1000);
+	double pathQuad, error;
+
+	gsl_integration_qagp(&F, pathHist->range, pathHist->n + 1, 0, 1e-7, 1000,
+		ws, &pathQuad, &error);
+	Work_Quadrature(ws);
+
+	if (ws != w)
+		gsl_integration_workspace_free(ws);
+
+	double pathAnalytic = Hist_WeightedPath(pathHist);
+
+	if (report)
+	{
+		fprintf(report, "Eq(13) at LAImax = %.6f:\tquadrature %.10f\tclosed form %.10f\n", LAImax, gapQuad, gapAnalytic);
+		fprintf(report, "Mean path length:\tquadrature %.10f\tclosed form %.10f\n", pathQuad, pathAnalytic);
+	}
+
+	return GSL_MAX(fabs(gapQuad - gapAnalytic), fabs(pathQuad - pathAnalytic));
+}
+
+//************************************
+// Method:    Hist_GapFraction_fdf	Eq(13) and its first two derivatives in LAImax (closed form)
+// FullName:  Hist_GapFraction_fdf
+// Access:    public 
+// Returns:   void
+// Qualifier:
+// Parameter: const gsl_histogram * pathHist	Path length distribution histogram (probability density)
+// Parameter: double LAImax					LAImax
+// Parameter: double * g					sum_i P_i * int exp(-LAImax*x) dx
+// Parameter: double * dg					dg/dLAImax = -sum_i P_i * int x*exp(-LAImax*x) dx
+// Parameter: double * d2g					d2g/dLAImax2 = sum_i P_i * int x^2*exp(-LAImax*x) dx
+//************************************
+void Hist_GapFraction_fdf(const gsl_histogram *pathHist, double LAImax, double *g, double *dg, double *d2g)
+{
+	const size_t n = pathHist->n;
+	const double *range = pathHist->range;
+
+	// with x = r_i + w*s and z = LAImax*w, each bin moment is exp(-LAImax*r_i) times
+	// combinations of phi_k(z) = int_0^1 s^(k-1) exp(-z*s) ds, all terms positive
+	double expLo = exp(-LAImax * range[0]);
+	double s0 = 0, s1 = 0, s2 = 0;
+	for (size_t i = 0; i < n; i++)
+	{
+		double a = range[i];
+		double w = range[i + 1] - a;
+		double z = LAImax * w;
+		double phi1, phi2, phi3, expZ;
+
+		if (z < 1)
+		{
+			// alternating series, 1/18! < 1e-15
+			double term = 1;
+			phi1 = 1; phi2 = 0.5; phi3 = 1.0 / 3;
+			for (int k = 1; k < 18; k++)
+			{
+				term *= -z / k;
+				phi1 += term / (k + 1);
+				phi2 += term / (k + 2);
+				phi3 += term / (k + 3);
+			}
+			expZ = exp(-z);
+		}
+		else
+		{
+			expZ = exp(-z);
+			phi1 = (1 - expZ) / z;
+			phi2 = (1 - expZ * (1 + z)) / (z * z);
+			phi3 = (2 - expZ * (z * z + 2 * z + 2)) / (z * z * z);
+		}
+
+		double m0 = w * phi1, m1 = w * w * phi2, m2 = w * w * w * phi3;
+		double p = pathHist->bin[i] * expLo;
+		s0 += p * m0;
+		s1 += p * (a * m0 + m1);
+		s2 += p * (a * a * m0 + 2 * a * m1 + m2);
+
+		expLo *= expZ;
+	}
+
+	*g = s0;
+	*dg = -s1;
+	*d2g = s2;
+}
+
+
+//************************************
+// Method:    Func_GapBiasFromLAImax_fdf	cost function of a specific LAImax and its derivatives (closed form)
+// FullName:  Func_GapBiasFromLAImax_fdf
+// Access:    public 
+// Returns:   void
+// Qualifier:
+// Parameter: double LAImax					LAImax
+// Parameter: void * params					params_GapBiasFromLAImax
+// Parameter: double * f, * df, * d2f		Simulated - measured gap fraction, and its derivatives in LAImax
+//************************************
+void Func_GapBiasFromLAImax_fdf(double LAImax, void* params, double *f, double *df, double *d2f)
+{
+	struct params_GapBiasFromLAImax *_params = (struct params_GapBiasFromLAImax*) params;
+
+	Hist_GapFraction_fdf(_params->pathHist, LAImax, f, df, d2f);
+	*f -= _params->gapF;
+}
+
+
+//branches of the ellipse section kernel (relative error < 1e-12 for T_0..T_3)
+#define CIRCLE_SERIES_MAX		3.0		//Maclaurin series below
+#define CIRCLE_SERIES_TERMS		36
+#define CIRCLE_ASYMPTOTIC_MIN	40.0	//asymptotic series above, exponentially weighted series between
+#define CIRCLE_KUMMER_TERMS		140
+#define CIRCLE_ASYMPTOTIC_TERMS	40
+
+//************************************
+// Method:    Circle_Moments	T_m(L) = int_0^1 exp(-L*x) * x^m / sqrt(1 - x^2) dx, m = 0..3
+// FullName:  Circle_Moments
+// Access:    private 
+// Returns:   void
+// Qualifier:
+// Parameter: double L				LAImax (>= 0)
+// Parameter: double * T			T_0..T_3 (for return)
+//************************************
+static void Circle_Moments(double L, double T[4])
+{
+	if (L < CIRCLE_SERIES_MAX)
+	{
+		//Maclaurin series: T_m = sum_n (-L)^n / n! * mu_(n+m), mu_k = int_0^1 x^k / sqrt(1 - x^2) dx
+		double mu[CIRCLE_SERIES_TERMS + 4];
+		mu[0] = M_PI_2;
+		mu[1] = 1;
+		for (int k = 2; k < CIRCLE_SERIES_TERMS + 4; k++)
+			mu[k] = mu[k - 2] * (k - 1) / k;
+
+		double term = 1;
+		T[0] = T[1] = T[2] = T[3] = 0;
+		for (int n = 0; n < CIRCLE_SERIES_TERMS; n++)
+		{
+			T[0] += term * mu[n];
+			T[1] += term * mu[n + 1];
+			T[2] += term * mu[n + 2];
+			T[3] += term * mu[n + 3];
+			term *= -L / (n + 1);
+		}
+	}
+	else if (L < CIRCLE_ASYMPTOTIC_MIN)
+	{
+		//x = 1 - s: T_0 = exp(-L) * sum_k L^k / k! * J_k, J_k = int_0^1 s^(k-1/2) (2-s)^(-1/2) ds,
+		//all terms positive. J_k by backward recurrence J_k = ((k+1) J_(k+1) + 1) / (2k+1)
+		double J[CIRCLE_KUMMER_TERMS + 1];
+		int K = CIRCLE_KUMMER_TERMS + 60;
+		double Jk = 1.0 / (K + 0.5);
+		for (int k = K - 1; k >= 0; k--)
+		{
+			Jk = ((k + 1) * Jk + 1) / (2 * k + 1);
+			if (k <= CIRCLE_KUMMER_TERMS)
+				J[k] = Jk;
+		}
+
+		//J_k - J_(k+1) = (1 - k J_k) / (k+1) is the moment of (1-s)
+		double w = exp(-L);
+		T[0] = T[1] = 0;
+		for (int k = 0; k < CIRCLE_KUMMER_TERMS; k++)
+		{
+			T[0] += w * J[k];
+			T[1] += w * (1 - k * J[k]) / (k + 1);
+			w *= L / (k + 1);
+		}
+
+		//recurrences from integrating d/dx[x^k sqrt(1 - x^2) exp(-L*x)] over [0, 1]
+		T[2] = T[0] - (1 - T[1]) / L;
+		T[3] = T[1] - (T[0] - 2 * T[2]) / L;
+	}
+	else
+	{
+		//Watson's lemma: x^m / sqrt(1 - x^2) = sum_k c_k x^(2k+m), c_k = C(2k,k) / 4^k,
+		//T_m ~ sum_k c_k (2k+m)! / L^(2k+m+1), truncated at the smallest term
+		for (int m = 0; m < 4; m++)
+		{
+			double term = 1 / L;				// c_0 * 0! / L
+			for (int j = 1; j <= m; j++)
+				term *= j / L;					// m! / L^(m+1)
+			double sum = 0;
+			for (int k = 0; k < CIRCLE_ASYMPTOTIC_TERMS; k++)
+			{
+				sum += term;
+				double next = term * (2 * k + 1) / (2 * k + 2)
+					* (2 * k + m + 1) * (2 * k + m + 2) / (L * L);
+				if (next >= term || next < 1e-17 * sum)
+					break;
+				term = next;
+			}
+			T[m] = sum;
+		}
+	}
+}
+
+
+//************************************
+// Method:    Bessel_IL0	I0(x) - L0(x), modified Bessel minus modified Struve function of order 0
+// FullName:  Bessel_IL0
+// Access:    public 
+// Returns:   double				(2/pi) * int_0^1 exp(-x*t) / sqrt(1 - t^2) dt
+// Qualifier:
+// Parameter: double x				x >= 0
+//************************************
+double Bessel_IL0(double x)
+{
+	double T[4];
+	Circle_Moments(x, T);
+	return M_2_PI * T[0];
+}
+
+
+//************************************
+// Method:    Bessel_IL1	I1(x) - L1(x), modified Bessel minus modified Struve function of order 1
+// FullName:  Bessel_IL1
+// Access:    public 
+// Returns:   double				(2/pi) * (1 - int_0^1 exp(-x*t) * t / sqrt(1 - t^2) dt)
+// Qualifier:
+// Parameter: double x				x >= 0
+//************************************
+double Bessel_IL1(double x)
+{
+	double T[4];
+	Circle_Moments(x, T);
+	return M_2_PI * (1 - T[1]);
+}
+
+
+//************************************
+// Method:    Circle_GapFraction_fdf	Gap fraction of the ellipse section assumption and its derivatives in LAImax
+// FullName:  Circle_GapFraction_fdf
+// Access:    public 
+// Returns:   void
+// Qualifier:
+// Parameter: double LAImax			LAImax
+// Parameter: double * g			int_0^1 exp(-LAImax*x) * x / sqrt(1 - x^2) dx = 1 - pi/2 * (I1 - L1)(LAImax)
+// Parameter: double * dg			dg/dLAImax = -pi/2 * ((I0 - L0) - (I1 - L1) / LAImax)
+// Parameter: double * d2g			d2g/dLAImax2
+//************************************
+void Circle_GapFraction_fdf(double LAImax, double *g, double *dg, double *d2g)
+{
+	double T[4];
+	Circle_Moments(LAImax, T);
+	*g = T[1];
+	*dg = -T[2];
+	*d2g = T[3];
+}
+
+
+//************************************
+// Method:    Func_GapBiasFromLAImax_Circle_fdf	cost function of a specific LAImax and its derivatives (ellipse section assumption)
+// FullName:  Func_GapBiasFromLAImax_Circle_fdf
+// Access:    public 
+// Returns:   void
+// Qualifier:
+// Parameter: double LAImax					LAImax
+// Parameter: void * params					dualParams: measured gap fraction, normalization coefficient
+// Parameter: double * f, * df, * d2f		Simulated - measured gap fraction, and its derivatives in LAImax
+//************************************
+void Func_GapBiasFromLAImax_Circle_fdf(double LAImax, void* params, double *f, double *df, double *d2f)
+{
+	struct dualParams *_params = (struct dualParams*) params;
+
+	Circle_GapFraction_fdf(LAImax, f, df, d2f);
+	*f = *f / _params->normalizedScale - _params->par;
+	*df /= _params->normalizedScale;
+	*d2f /= _params->normalizedScale;
+}
+
+
+//************************************
+// Method:    Solve_LAImax		Safeguarded Halley/Newton root finding of a decreasing cost function
+// FullName:  Solve_LAImax
+// Access:    public 
+// Returns:   int						GSL_SUCCESS, GSL_EMAXITER, or GSL_EINVAL (no root in [x_min, x_max])
+// Qualifier:
+// Parameter: fdf						cost function, its first and second derivatives (d2f = 0 gives Newton)
+// Parameter: void * params				parameters of fdf
+// Parameter: double x_min, x_max		limits of the root, f(x_min) >= 0 is expected
+// Parameter: double x0					initial guess (e.g. LAImax of the previous plot), the bracket
+//										[x0 / LAI_PATH_GROWTH, x0 * LAI_PATH_GROWTH] grows or shrinks
+//										geometrically within the limits until it holds the root
+// Parameter: double epsabs				absolute tolerance of LAImax
+// Parameter: int max_iter				maximum evaluations of fdf
+// Parameter: solver_info * info		LAImax, iterations and evaluations (for return)
+//************************************
+int Solve_LAImax(void (*fdf)(double, void*, double*, double*, double*), void *params,
+	double x_min, double x_max, double x0, double epsabs, int max_iter, struct solver_info *info)
+{
+	double x = GSL_MIN(GSL_MAX(x0, x_min), x_max);
+	double x_lo = GSL_MAX(x / LAI_PATH_GROWTH, x_min), x_hi = GSL_MIN(x * LAI_PATH_GROWTH, x_max);
+	double f, df, d2f;
+	bool loChecked = false, hiChecked = false;		//sign of f known at the end of the bracket
+	int iter = 0, nEval = 0;
+	int status = GSL_CONTINUE;
+
+	while (status == GSL_CONTINUE && iter < max_iter)
+	{
+		iter++;
+		fdf(x, params, &f, &df, &d2f);
+		nEval++;
+
+		if (f == 0)
+		{
+			status = GSL_SUCCESS;
+			break;
+		}
+
+		//shrink the bracket, f decreases with LAImax. At an unchecked end of the same sign
+		//the root lies beyond it: grow the bracket geometrically, up to the limits
+		if (f > 0)
+		{
+			x_lo = x;
+			loChecked = true;
+			if (x >= x_hi)
+			{
+				if (x >= x_max)
+				{
+					status = GSL_EINVAL;
+					break;
+				}
+				x_hi = GSL_MIN(x_hi * LAI_PATH_GROWTH, x_max);
+			}
+		}
+		else
+		{
+			x_hi = x;
+			hiChecked = true;
+			if (x <= x_lo)
+			{
+				if (x <= x_min)
+				{
+					status = GSL_EINVAL;
+					break;
+				}
+				x_lo = GSL_MAX(x_lo / LAI_PATH_GROWTH, x_min);
+			}
+		}
+
+		//Halley step, Newton step if Halley leaves the bracket, bisection otherwise.
+		//Newton beyond an unchecked end: that end is evaluated next. A step below epsabs has
+		//converged, also if it rounds to x, which is then an end of the bracket
+		double x_new = 0.5 * (x_lo + x_hi);
+		bool toEnd = false;
+		if (df < 0)
+		{
+			double den = 2 * df * df - f * d2f;
+			double x_halley = (den > 0) ? x - 2 * f * df / den : x;
+			double x_newton = x - f / df;
+			if ((x_halley > x_lo && x_halley < x_hi) || (den > 0 && fabs(x_halley - x) < epsabs))
+				x_new = x_halley;
+			else if ((x_newton > x_lo && x_newton < x_hi) || fabs(x_newton - x) < epsabs)
+				x_new = x_newton;
+			else if (!hiChecked && x_newton >= x_hi)
+			{
+				x_new = x_hi;
+				toEnd = true;
+			}
+			else if (!loChecked && x_newton <= x_lo)
+			{
+				x_new = x_lo;
+				toEnd = true;
+			}
+		}
+
+		if (!toEnd && fabs(x_new - x) < epsabs)
+			status = GSL_SUCCESS;
+		x = x_new;
+	}
+
+	if (status == GSL_CONTINUE)
+		status = GSL_EMAXITER;
+
+	info->status = status;
+	info->iter = iter;
+	info->nEval = nEval;
+	info->LAImax = x;
+
+	return status;
+}
+
+
+//************************************
+// Method:    LAI_PATH_AddWork	Add the numerical work of one solve to the work of a batch
+// FullName:  LAI_PATH_AddWork
+// Access:    public 
+// Returns:   void
+// Qualifier:
+// Parameter: solver_work * work			batch
+// Parameter: const solver_info * info		one solve
+//************************************
+void LAI_PATH_AddWork(struct solver_work *work, const struct solver_info *info)
+{
+	work->nSolves++;
+	work->iter += info->iter;
+	work->nEval += info->nEval;
+	work->nPathProb += info->nPathProb;
+	work->nIntervals += info->nIntervals;
+	work->maxIntervals = GSL_MAX(work->maxIntervals, info->maxIntervals);
+	work->maxIter = GSL_MAX(work->maxIter, info->iter);
+	work->nMaxIter += (info->status == GSL_EMAXITER);
+	work->nBracketFail += info->nBracketFail;
+	work->nFallback += info->fallback;
+}
+
+
+//************************************
+// Method:    LAI_PATH_SetTolerance	Tolerances of LAI_PATH and LAI_PATH_Circle, before solving (not while other threads solve)
+// FullName:  LAI_PATH_SetTolerance
+// Access:    public 
+// Returns:   void
+// Qualifier:
+// Parameter: const lai_path_tolerance * tolerance	0: LAI_PATH_EPSABS, LAI_PATH_EPSREL
+//************************************
+void LAI_PATH_SetTolerance(const struct lai_path_tolerance *tolerance)
+{
+	struct lai_path_tolerance defaults = { LAI_PATH_EPSABS, LAI_PATH_EPSREL };
+	g_tolerance = tolerance ? *tolerance : defaults;
+}
+
+struct lai_path_tolerance LAI_PATH_Tolerance()
+{
+	return g_tolerance;
+}
+
 
+//GSL error of each thread, the GSL default handler aborts the program
+static thread_local struct gsl_error_state t_errorState = { GSL_SUCCESS, 0, 0, 0 };
 
+//************************************
+// Method:    LAI_PATH_ErrorHandler	GSL error handler keeping the first error of the calling thread
+// FullName:  LAI_PATH_ErrorHandler
+// Access:    public 
+// Returns:   void
+// Qualifier:
+// Parameter: const char * reason, const char * file, int line, int gsl_errno	see gsl_error_handler_t
+//************************************
+void LAI_PATH_ErrorHandler(const char *reason, const char *file, int line, int gsl_errno)
+{
+	if (t_errorState.gsl_errno != GSL_SUCCESS)
+		return;
+	t_errorState.gsl_errno = gsl_errno;
+	t_errorState.reason = reason;
+	t_errorState.file = file;
+	t_errorState.line = line;
+}
+
+//************************************
+// Method:    LAI_PATH_ErrorState	GSL error of the calling thread, set gsl_errno = GSL_SUCCESS to clear
+// FullName:  LAI_PATH_ErrorState
+// Access:    public 
+// Returns:   gsl_error_state *
+// Qualifier:
+//************************************
+struct gsl_error_state *LAI_PATH_ErrorState()
+{
+	return &t_errorState;
+}
@@ -6,6 +6,13 @@
 *			2013/06/23 (GSL version)		Rewrite: Migrate to GSL library to improve speed
 *			2016/12/13 (GSL version)		Modify for distribute
 * 			2023/03/12 (GSL version)		Fix the too high estimates when too much path lengths close to 0 observed in path length distribution
+*			2026/10/16 (GSL version)		New : Closed form of Eq(13) for histogram path length distribution (no quadrature)
+*			2026/10/16 (GSL version)		New : Halley/Newton solver of LAImax with analytic derivatives
+*			2026/10/17 (GSL version)		New : Ellipse section assumption in closed form (modified Bessel and Struve functions)
+*			2026/10/17 (GSL version)		New : GSL error state per thread (reentrant LAI_PATH)
+*			2026/10/17 (GSL version)		New : Geometric bracketing with warm start, path lengths close to 0 handled in LAI_PATH
+*			2026/10/17 (GSL version)		New : Numerical work of the solves (integrand evaluations, quadrature subintervals, bracket failures)
+*			2026/10/17 (GSL version)		New : Root and quadrature tolerances settable (accuracy / speed benchmark)
 *
 * \author Ronghai Hu
 * Contact: huronghai@ucas.ac.cn
@@ -26,6 +33,8 @@
 *
 */
 
+#pragma once
+
 #include <gsl/gsl_histogram.h>
 #include <gsl/gsl_errno.h>
 #include <gsl/gsl_math.h>
@@ -37,6 +46,22 @@ using namespace std;
 
 #define LAI_MAX		10
 #define NUM_BINS	25			//number of bins in histogram (not sensitive)
+#define LAI_PATH_VERSION	20261018	//changes when results of LAI_PATH / LAI_PATH_Circle change (cached results, ResultCache.h)
+
+//integration method of Eq(13) used by LAI_PATH
+#define LAI_PATH_ANALYTIC	0	//closed form over histogram bins (default)
+#define LAI_PATH_QUADRATURE	1	//adaptive quadrature (gsl_integration_qagp)
+#define LAI_PATH_COMPARE	2	//closed form, and report its difference to quadrature on stderr
+
+#define LAI_PATH_BRACKET	10	//LAImax is searched in [effLAI, LAI_PATH_BRACKET * effLAI]
+#define LAI_PATH_GROWTH		2	//geometric growth of the bracket around the initial guess (Solve_LAImax)
+
+//default tolerances of LAI_PATH and LAI_PATH_Circle (LAI_PATH_SetTolerance)
+#define LAI_PATH_EPSABS		0.0001	//absolute tolerance of LAImax
+#define LAI_PATH_EPSREL		1e-7	//relative tolerance of the quadratures (LAI_PATH_QUADRATURE)
+
+//status of LAI_PATH besides GSL_SUCCESS, GSL_EMAXITER and GSL_EINVAL (no root, LAI_MAX returned)
+#define LAI_PATH_ZERO_PATH	1000	//no root, solved again with the first bin taken as large gaps (solver_info::zeroPath)
 
 struct params_PathLen2GapF
 {
@@ -48,6 +73,7 @@ struct params_GapBiasFromLAImax
 {
 	gsl_histogram *pathHist;
 	double gapF;
+	gsl_integration_workspace *w;		//quadrature workspace, NULL: allocated per evaluation
 };
 
 struct dualParams 
@@ -56,26 +82,104 @@ struct dualParams
 	double normalizedScale;
 };
 
+//LAImax solve of LAI_PATH and LAI_PATH_Circle
+struct solver_info
+{
+	int status;			//GSL_SUCCESS, GSL_EMAXITER, GSL_EINVAL (no root in bracket, LAI_MAX returned), LAI_PATH_ZERO_PATH
+	int iter;			//root iterations
+	int nEval;			//cost function evaluations
+	double LAImax;		//resolved LAImax
+	double meanPath;	//int lr*P(lr), mean relative path length
+	double zeroPath;	//fraction of path lengths close to 0 taken as large gaps (LAI_PATH_ZERO_PATH)
+
+	//numerical work of the solve (expensive plots, e.g. a spike in the first or last bin)
+	long long nPathProb;	//Func_PathProb calls of the quadratures (integrand evaluations)
+	int nIntervals;			//quadrature subintervals, over all quadratures
+	int maxIntervals;		//subintervals of the largest quadrature (limit 1000)
+	int nBracketFail;		//solves without root in the bracket (first try and zero-path retry)
+	int fallback;			//1: no root, LAI_MAX returned
+};
+
+//numerical work of a batch of solves, summed by LAI_PATH_AddWork (zero it first)
+struct solver_work
+{
+	size_t nSolves;
+	long long iter;
+	long long nEval;
+	long long nPathProb;
+	long long nIntervals;
+	int maxIntervals;
+	int maxIter;			//most root iterations of one solve
+	size_t nMaxIter;		//GSL_EMAXITER
+	size_t nBracketFail;
+	size_t nFallback;
+};
+
+//tolerances of the solves of all threads, set before solving (results differ from the cached ones, ResultCache.h)
+struct lai_path_tolerance
+{
+	double epsabs;		//LAImax
+	double epsrel;		//quadratures
+};
+
+//GSL error of the calling thread, recorded by LAI_PATH_ErrorHandler
+struct gsl_error_state
+{
+	int gsl_errno;			//GSL_SUCCESS: no error since cleared
+	const char *reason;
+	const char *file;
+	int line;
+};
+
 
 inline double neglog(double x) { return -log(x);};
 
 void Stat_hist( double * data , unsigned long ndata, gsl_histogram *out_hist);
 
 //·Ϊʵֱͼ
-double LAI_PATH(gsl_histogram *pathHist, double gapFraction, double zenith = 0, double G = 0.5);
+double LAI_PATH(gsl_histogram *pathHist, double gapFraction, double zenith = 0, double G = 0.5, int integration = LAI_PATH_ANALYTIC, struct solver_info *info = 0);
+double LAI_PATH_Workspace(gsl_histogram *pathHist, double gapFraction, double zenith, double G, int integration, struct solver_info *info,
+	gsl_integration_workspace *w, gsl_root_fsolver *s, double seed = 0);
 double Func_PathProb(double _pathLen, void *params);
 double Func_PathLen2GapF(double _pathLen, void *params);
 double Func_WeightedPath(double _pathLen, void *params);
 double Func_GapBiasFromLAImax(double x, void* params);
 
+//closed form of the integrals over a piecewise-constant path length distribution
+double Hist_GapFraction(const gsl_histogram *pathHist, double LAImax);
+double Hist_WeightedPath(const gsl_histogram *pathHist);
+double Func_GapBiasFromLAImax_Analytic(double LAImax, void* params);
+double Hist_CompareQuadrature(gsl_histogram *pathHist, double LAImax, FILE *report = 0, gsl_integration_workspace *w = 0);
+void Hist_GapFraction_fdf(const gsl_histogram *pathHist, double LAImax, double *g, double *dg, double *d2g);
+void Func_GapBiasFromLAImax_fdf(double LAImax, void* params, double *f, double *df, double *d2f);
+
+//safeguarded Halley/Newton solver of LAImax (cost function decreasing in LAImax)
+int Solve_LAImax(void (*fdf)(double, void*, double*, double*, double*), void *params,
+	double x_min, double x_max, double x0, double epsabs, int max_iter, struct solver_info *info);
+
 //·ΪĬԲ
-double LAI_PATH_Circle(double gapFraction, double zenith = 0, double G = 0.5);
-double LAIe2LAI_PATH_Circle(double effLAI, double zenith = 0, double G = 0.5);
+double LAI_PATH_Circle(double gapFraction, double zenith = 0, double G = 0.5, struct solver_info *info = 0);
+double LAIe2LAI_PATH_Circle(double effLAI, double zenith = 0, double G = 0.5, struct solver_info *info = 0);
 
 inline double Func_PathProb_Circle(double _pathLen, void *params = 0) {return _pathLen / sqrt( 1- _pathLen * _pathLen );};
 inline double Func_PathLen2GapF_Circle(double _pathLen, void *params){ return exp(-*(double *)params * _pathLen) * Func_PathProb_Circle(_pathLen);};
 inline double Func_WeightedPath_Circle(double _pathLen, void *params = 0) {return _pathLen * Func_PathProb_Circle(_pathLen);};
 double Func_GapBiasFromLAImax_Circle(double LAImax, void* params);
+void Func_GapBiasFromLAImax_Circle_fdf(double LAImax, void* params, double *f, double *df, double *d2f);
+
+//closed form of the ellipse section kernel: I - L, modified Bessel minus modified Struve functions
+double Bessel_IL0(double x);
+double Bessel_IL1(double x);
+void Circle_GapFraction_fdf(double LAImax, double *g, double *dg, double *d2g);
+
+void LAI_PATH_AddWork(struct solver_work *work, const struct solver_info *info);
+
+void LAI_PATH_SetTolerance(const struct lai_path_tolerance *tolerance);
+struct lai_path_tolerance LAI_PATH_Tolerance();
+
+//reentrant GSL error handling: gsl_set_error_handler(&LAI_PATH_ErrorHandler) keeps the first error per thread
+void LAI_PATH_ErrorHandler(const char *reason, const char *file, int line, int gsl_errno);
+struct gsl_error_state *LAI_PATH_ErrorState();
 
 
 
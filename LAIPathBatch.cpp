@@ -0,0 +1,327 @@
+/*!
+* \file LAIPathBatch.cpp
+* \date
+*			2026/10/17	Structure-of-arrays LAI_PATH for many plots at once
+*			2026/10/17	Scalar lanes and run time dispatch to AVX2 / AVX-512 lanes
+*			2026/10/17	Step below BATCH_EPSABS converges also if it rounds to an end of the bracket, as Solve_LAImax
+*
+* \brief
+*		Same closed form and safeguarded Halley iteration as LAI_PATH (Hist_GapFraction_fdf,
+*		Solve_LAImax), with the loops turned inside out: bins outside, plots inside.
+*		The lanes keep the fixed bracket [effLAI, LAI_PATH_BRACKET * effLAI] started from the
+*		lower bound; plots without a root there go to LAI_PATH for LAI_PATH_ZERO_PATH.
+*
+*/
+
+#include <vector>
+
+#include "LAIPathBatchSimd.h"
+
+const double batch_recip[BATCH_SERIES_TERMS + 3] = { 0,
+	1.0 / 1, 1.0 / 2, 1.0 / 3, 1.0 / 4, 1.0 / 5, 1.0 / 6, 1.0 / 7, 1.0 / 8, 1.0 / 9, 1.0 / 10,
+	1.0 / 11, 1.0 / 12, 1.0 / 13, 1.0 / 14, 1.0 / 15, 1.0 / 16, 1.0 / 17, 1.0 / 18, 1.0 / 19, 1.0 / 20 };
+
+
+//************************************
+// Method:    Batch_fdf_Scalar	Eq(13) and its derivatives for plots [p0, p1), each at its own LAImax
+// FullName:  Batch_fdf_Scalar
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: const batch_lanes * l		x of the lanes, f, df and d2f are returned
+// Parameter: size_t p0, p1				range of plots
+//************************************
+void Batch_fdf_Scalar(const struct batch_lanes *l, size_t p0, size_t p1)
+{
+	const size_t n = l->nplots;
+	const double w = 1.0 / l->nbins, ww = w * w, www = ww * w;
+
+	//with z = LAImax * w, the moments of a bin relative to its lower edge are the same
+	//for every bin of a plot (see Hist_GapFraction_fdf)
+	for (size_t p = p0; p < p1; p++)
+		l->expZ[p] = exp(-(l->x[p] * w));
+	for (size_t p = p0; p < p1; p++)
+	{
+		double z = l->x[p] * w;
+		double e = l->expZ[p];
+		double phi1, phi2, phi3;
+		if (z < 1)
+		{
+			double term = 1;
+			phi1 = 1; phi2 = batch_recip[2]; phi3 = batch_recip[3];
+			for (int k = 1; k < BATCH_SERIES_TERMS; k++)
+			{
+				term *= -z * batch_recip[k];
+				phi1 += term * batch_recip[k + 1];
+				phi2 += term * batch_recip[k + 2];
+				phi3 += term * batch_recip[k + 3];
+			}
+		}
+		else
+		{
+			double zz = z * z;
+			phi1 = (1 - e) / z;
+			phi2 = (1 - e * (1 + z)) / zz;
+			phi3 = (2 - e * (zz + 2 * z + 2)) / (zz * z);
+		}
+		l->m0[p] = w * phi1;
+		l->m1[p] = ww * phi2;
+		l->m2[p] = www * phi3;
+		l->expLo[p] = 1;
+		l->f[p] = l->df[p] = l->d2f[p] = 0;
+	}
+
+	//bins outside, plots inside: unit stride over binProb and all per-plot arrays
+	for (size_t b = 0; b < l->nbins; b++)
+	{
+		const double a = b * w, aa = a * a, a2 = 2 * a;
+		const double *prob = l->binProb + b * n;
+		for (size_t p = p0; p < p1; p++)
+		{
+			double pe = prob[p] * l->expLo[p];
+			l->f[p] += pe * l->m0[p];
+			l->df[p] += pe * (a * l->m0[p] + l->m1[p]);
+			l->d2f[p] += pe * (aa * l->m0[p] + a2 * l->m1[p] + l->m2[p]);
+			l->expLo[p] *= l->expZ[p];
+		}
+	}
+
+	for (size_t p = p0; p < p1; p++)
+	{
+		l->f[p] *= l->density[p];
+		l->df[p] *= -l->density[p];
+		l->d2f[p] *= l->density[p];
+	}
+}
+
+
+//************************************
+// Method:    Batch_Step_Scalar		One safeguarded Halley step (Solve_LAImax) of plots [p0, p1)
+// FullName:  Batch_Step_Scalar
+// Access:    public
+// Returns:   size_t				number of lanes not done
+// Qualifier:
+// Parameter: batch_lanes * l		lanes, f, df and d2f evaluated at x
+// Parameter: size_t p0, p1			range of plots
+//************************************
+size_t Batch_Step_Scalar(struct batch_lanes *l, size_t p0, size_t p1)
+{
+	size_t nActive = 0;
+
+	for (size_t p = p0; p < p1; p++)
+	{
+		if (l->phase[p] == BATCH_DONE)
+			continue;
+
+		double x = l->x[p];
+		double f = l->f[p] - l->gapFraction[p], df = l->df[p], d2f = l->d2f[p];
+		double x_new;
+
+		if (l->phase[p] == BATCH_CHECK_HI)
+		{
+			//f(x_hi) of the bracket check, x_prev is the iterate that asked for it
+			l->hiChecked[p] = 1;
+			if (f > 0)
+			{
+				l->status[p] = GSL_EINVAL;
+				l->phase[p] = BATCH_DONE;
+				continue;
+			}
+			x_new = 0.5 * (l->x_lo[p] + l->x_hi[p]);
+			l->phase[p] = BATCH_ACTIVE;
+		}
+		else
+		{
+			l->iter[p]++;
+			l->x_prev[p] = x;
+
+			if (f == 0)
+			{
+				l->status[p] = GSL_SUCCESS;
+				l->phase[p] = BATCH_DONE;
+				continue;
+			}
+
+			if (f > 0)
+				l->x_lo[p] = x;
+			else
+			{
+				l->x_hi[p] = x;
+				l->hiChecked[p] = 1;
+			}
+
+			double x_lo = l->x_lo[p], x_hi = l->x_hi[p];
+			x_new = 0.5 * (x_lo + x_hi);
+			if (df < 0)
+			{
+				double den = 2 * df * df - f * d2f;
+				double x_halley = (den > 0) ? x - 2 * f * df / den : x;
+				double x_newton = x - f / df;
+				//a step below BATCH_EPSABS has converged, also if it rounds to x (an end of the bracket)
+				if ((x_halley > x_lo && x_halley < x_hi) || (den > 0 && fabs(x_halley - x) < BATCH_EPSABS))
+					x_new = x_halley;
+				else if ((x_newton > x_lo && x_newton < x_hi) || fabs(x_newton - x) < BATCH_EPSABS)
+					x_new = x_newton;
+				else if (l->hiChecked[p] == 0 && x_newton >= x_hi)
+				{
+					//the root may lie beyond x_hi: evaluated with the next round
+					l->x[p] = x_hi;
+					l->phase[p] = BATCH_CHECK_HI;
+					nActive++;
+					continue;
+				}
+			}
+		}
+
+		l->x[p] = x_new;
+		if (fabs(x_new - l->x_prev[p]) < BATCH_EPSABS)
+		{
+			l->status[p] = GSL_SUCCESS;
+			l->phase[p] = BATCH_DONE;
+		}
+		else if (l->iter[p] >= BATCH_MAX_ITER)
+		{
+			l->status[p] = GSL_EMAXITER;
+			l->phase[p] = BATCH_DONE;
+		}
+		else
+			nActive++;
+	}
+
+	return nActive;
+}
+
+
+//************************************
+// Method:    LAI_PATH_Batch	LAI_PATH of N plots in structure-of-arrays layout
+// FullName:  LAI_PATH_Batch
+// Access:    public
+// Returns:   size_t							number of plots whose status is neither GSL_SUCCESS nor LAI_PATH_ZERO_PATH
+// Qualifier:
+// Parameter: const lai_path_batch * in			histograms and observations of N plots
+// Parameter: lai_path_batch_result * out		LAI, clumping index, status, ... of N plots
+// Parameter: int isa							BATCH_ISA_AUTO, or BATCH_ISA_SCALAR, _AVX2, _AVX512 (limited to the CPU)
+//************************************
+size_t LAI_PATH_Batch(const struct lai_path_batch *in, struct lai_path_batch_result *out, int isa)
+{
+	const size_t n = in->nplots, nbins = in->nbins;
+	if (n == 0)
+		return 0;
+
+	int supported = Batch_SupportedIsa();
+	if (isa == BATCH_ISA_AUTO || isa > supported)
+		isa = supported;
+	const size_t width = (isa == BATCH_ISA_AVX512) ? 8 : (isa == BATCH_ISA_AVX2) ? 4 : 1;
+
+	std::vector<double> buffer(17 * n);
+	std::vector<int> status(n, GSL_CONTINUE);
+	double *density = &buffer[0], *meanPath = density + n;
+	struct batch_lanes l;
+	l.nplots = n;
+	l.nbins = nbins;
+	l.binProb = in->binProb;
+	l.gapFraction = in->gapFraction;
+	l.density = density;
+	l.x = meanPath + n;
+	l.x_prev = l.x + n;	l.x_lo = l.x_prev + n;	l.x_hi = l.x_lo + n;
+	l.f = l.x_hi + n;	l.df = l.f + n;			l.d2f = l.df + n;
+	l.expZ = l.d2f + n;	l.m0 = l.expZ + n;		l.m1 = l.m0 + n;		l.m2 = l.m1 + n;	l.expLo = l.m2 + n;
+	l.phase = l.expLo + n;	l.hiChecked = l.phase + n;	l.iter = l.hiChecked + n;
+	l.status = &status[0];
+
+	//normalization and mean path length: sum_b P_b * (r_b+1^2 - r_b^2) / 2 = sum_b P_b * (2b+1) / (2 nbins^2)
+	for (size_t p = 0; p < n; p++)
+		density[p] = meanPath[p] = 0;
+	for (size_t b = 0; b < nbins; b++)
+	{
+		const double *prob = in->binProb + b * n;
+		const double r = (2.0 * b + 1) / (2.0 * nbins);
+		for (size_t p = 0; p < n; p++)
+		{
+			density[p] += prob[p];
+			meanPath[p] += prob[p] * r;
+		}
+	}
+	for (size_t p = 0; p < n; p++)
+	{
+		meanPath[p] /= density[p];
+		density[p] = nbins / density[p];
+
+		//bracket and start of LAI_PATH: effLAI / mean path length is a lower bound of LAImax
+		double effLAI = -log(in->gapFraction[p]);
+		l.x_lo[p] = effLAI;
+		l.x_hi[p] = effLAI * LAI_PATH_BRACKET;
+		l.x[p] = GSL_MIN(GSL_MAX(effLAI, effLAI / meanPath[p]), l.x_hi[p]);
+		l.x_prev[p] = l.x[p];
+		l.phase[p] = BATCH_ACTIVE;
+		l.hiChecked[p] = 0;
+		l.iter[p] = 0;
+	}
+
+	//safeguarded Halley iterations in lockstep, block by block (binProb of a block stays in cache),
+	//vectors of plots first, the rest in scalar lanes
+	for (size_t q0 = 0; q0 < n; q0 += BATCH_BLOCK)
+	{
+		const size_t q1 = GSL_MIN(q0 + BATCH_BLOCK, n);
+		const size_t qVector = (isa == BATCH_ISA_SCALAR) ? q0 : q1 - (q1 - q0) % width;
+		size_t nActive = q1 - q0;
+		while (nActive > 0)
+		{
+			nActive = 0;
+			if (isa == BATCH_ISA_AVX512)
+			{
+				Batch_fdf_Avx512(&l, q0, qVector);
+				nActive += Batch_Step_Avx512(&l, q0, qVector);
+			}
+			else if (isa == BATCH_ISA_AVX2)
+			{
+				Batch_fdf_Avx2(&l, q0, qVector);
+				nActive += Batch_Step_Avx2(&l, q0, qVector);
+			}
+			Batch_fdf_Scalar(&l, qVector, q1);
+			nActive += Batch_Step_Scalar(&l, qVector, q1);
+		}
+	}
+
+	size_t nFailed = 0;
+	gsl_histogram *hist = 0;
+	for (size_t p = 0; p < n; p++)
+	{
+		double cosZenith = cos(in->zenith[p] * M_PI / 180);
+		double largeGap = in->largeGapFraction ? in->largeGapFraction[p] : 0;
+		double totalGap = largeGap + (1 - largeGap) * in->gapFraction[p];
+		double LAImax = (status[p] == GSL_EINVAL) ? LAI_MAX : l.x[p];
+		double LAI = (status[p] == GSL_EINVAL) ? LAI_MAX :
+			LAImax * meanPath[p] / in->G[p] * cosZenith;
+
+		//no root with path lengths close to 0 (rare): LAI_PATH takes the first bin as large gaps
+		if (status[p] == GSL_EINVAL && in->binProb[p] > 0)
+		{
+			struct solver_info info;
+			if (!hist)
+				hist = gsl_histogram_alloc(nbins);
+			gsl_histogram_set_ranges_uniform(hist, 0, 1);
+			for (size_t b = 0; b < nbins; b++)
+				hist->bin[b] = in->binProb[b * n + p] * density[p];
+			LAI = LAI_PATH(hist, in->gapFraction[p], in->zenith[p], in->G[p], LAI_PATH_ANALYTIC, &info);
+			status[p] = info.status;
+			LAImax = info.LAImax;
+			meanPath[p] = info.meanPath;
+			l.iter[p] += info.iter;
+		}
+		LAI *= 1 - largeGap;
+
+		out->LAI[p] = LAI;
+		out->CI[p] = -log(totalGap) / in->G[p] * cosZenith / LAI;
+		out->status[p] = status[p];
+		if (out->LAImax) out->LAImax[p] = LAImax;
+		if (out->meanPath) out->meanPath[p] = meanPath[p];
+		if (out->iter) out->iter[p] = (int)l.iter[p];
+		if (status[p] != GSL_SUCCESS && status[p] != LAI_PATH_ZERO_PATH)
+			nFailed++;
+	}
+	if (hist)
+		gsl_histogram_free(hist);
+
+	return nFailed;
+}
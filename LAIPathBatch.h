@@ -0,0 +1,53 @@
+/*!
+* \file LAIPathBatch.h
+* \date
+*			2026/10/17	Structure-of-arrays LAI_PATH for many plots at once
+*			2026/10/17	AVX2 / AVX-512 lanes with runtime dispatch
+*
+* \brief
+*		N plots share one bin count. Histograms are stored as a bins-by-plots matrix,
+*		binProb[b * nplots + p], so every kernel walks the plots with unit stride and the
+*		Halley iterations of all plots advance in lockstep (converged plots are masked out),
+*		4 (AVX2) or 8 (AVX-512) plots per vector, the instruction set is chosen at run time.
+*
+*		Per plot the result equals input mode > 0 of the example:
+*		LAI = LAI_PATH(histogram, gap fraction inside canopy, zenith, G) * (1 - large gap fraction)
+*		CI  = LAIe / LAI, with LAIe from the total gap fraction.
+*
+*/
+
+#pragma once
+
+#include "LAIPath.h"
+
+//instruction set of LAI_PATH_Batch
+#define BATCH_ISA_AUTO		-1		//best supported by the CPU
+#define BATCH_ISA_SCALAR	0
+#define BATCH_ISA_AVX2		1		//4 plots per vector
+#define BATCH_ISA_AVX512	2		//8 plots per vector
+
+//inputs of N plots, arrays of length nplots unless noted
+struct lai_path_batch
+{
+	size_t nplots;
+	size_t nbins;					//uniform bins on [0, 1]
+	const double *binProb;			//nbins x nplots, relative frequencies (normalized per plot)
+	const double *gapFraction;		//gap fraction inside canopy
+	const double *largeGapFraction;	//gap fraction of large gaps (NULL: 0)
+	const double *zenith;			//observing zenith angle (degree)
+	const double *G;				//leaf projection function G
+};
+
+//outputs of N plots, optional arrays may be NULL
+struct lai_path_batch_result
+{
+	double *LAI;
+	double *CI;
+	int *status;					//GSL_SUCCESS, GSL_EMAXITER, GSL_EINVAL (no root, LAI_MAX returned), LAI_PATH_ZERO_PATH
+	double *LAImax;					//optional
+	double *meanPath;				//optional, mean relative path length
+	int *iter;						//optional, Halley iterations
+};
+
+//returns the number of plots whose status is neither GSL_SUCCESS nor LAI_PATH_ZERO_PATH
+size_t LAI_PATH_Batch(const struct lai_path_batch *in, struct lai_path_batch_result *out, int isa = BATCH_ISA_AUTO);
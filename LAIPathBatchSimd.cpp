@@ -0,0 +1,434 @@
+/*!
+* \file LAIPathBatchSimd.cpp
+* \date
+*			2026/10/17	AVX2 / AVX-512 lanes of LAI_PATH_Batch
+*			2026/10/17	Passed bracket checks bisect as Batch_Step_Scalar (were moved by Halley / Newton from x_hi)
+*			2026/10/17	Step below BATCH_EPSABS converges also if it rounds to an end of the bracket, as Batch_Step_Scalar
+*
+* \brief
+*		The functions are compiled for AVX2 or AVX-512 individually (target attribute with
+*		GCC / Clang, intrinsics with MSVC), the rest of the program keeps the baseline
+*		instruction set. LAI_PATH_Batch only calls them when Batch_SupportedIsa allows.
+*
+*		exp is evaluated in scalar (one per plot and round), the bin loop and the Halley
+*		step are vectorized. FMA is not used, so results equal the scalar lanes.
+*
+*/
+
+#include "LAIPathBatchSimd.h"
+
+
+//************************************
+// Method:    Batch_SupportedIsa	Best instruction set of the lanes supported by CPU and OS
+// FullName:  Batch_SupportedIsa
+// Access:    public
+// Returns:   int				BATCH_ISA_SCALAR, BATCH_ISA_AVX2 or BATCH_ISA_AVX512
+// Qualifier:
+//************************************
+int Batch_SupportedIsa()
+{
+#if defined(BATCH_X86) && defined(_MSC_VER)
+	static int isa = -1;
+	if (isa < 0)
+	{
+		int info[4];
+		isa = BATCH_ISA_SCALAR;
+		__cpuid(info, 0);
+		if (info[0] >= 7)
+		{
+			__cpuid(info, 1);
+			bool osxsave = (info[2] & (1 << 27)) != 0, avx = (info[2] & (1 << 28)) != 0;
+			unsigned long long xcr0 = (osxsave && avx) ? _xgetbv(0) : 0;
+			__cpuidex(info, 7, 0);
+			if ((xcr0 & 0x6) == 0x6 && (info[1] & (1 << 5)))
+				isa = BATCH_ISA_AVX2;
+			if ((xcr0 & 0xe6) == 0xe6 && (info[1] & (1 << 16)))
+				isa = BATCH_ISA_AVX512;
+		}
+	}
+	return isa;
+#elif defined(BATCH_X86)
+	//checks the OS support of the registers as well
+	static int isa = __builtin_cpu_supports("avx512f") ? BATCH_ISA_AVX512 :
+		__builtin_cpu_supports("avx2") ? BATCH_ISA_AVX2 : BATCH_ISA_SCALAR;
+	return isa;
+#else
+	return BATCH_ISA_SCALAR;
+#endif
+}
+
+
+#ifdef BATCH_X86
+
+//************************************
+// Method:    Batch_fdf_Avx2	Batch_fdf_Scalar, 4 plots per vector
+// FullName:  Batch_fdf_Avx2
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: const batch_lanes * l		x of the lanes, f, df and d2f are returned
+// Parameter: size_t p0, p1				range of plots, p1 - p0 multiple of 4
+//************************************
+BATCH_TARGET_AVX2 void Batch_fdf_Avx2(const struct batch_lanes *l, size_t p0, size_t p1)
+{
+	const size_t n = l->nplots;
+	const double w = 1.0 / l->nbins, ww = w * w, www = ww * w;
+	const __m256d one = _mm256_set1_pd(1), two = _mm256_set1_pd(2), zero = _mm256_setzero_pd();
+	const __m256d signMask = _mm256_set1_pd(-0.0);
+
+	for (size_t p = p0; p < p1; p++)
+		l->expZ[p] = exp(-(l->x[p] * w));
+
+	for (size_t p = p0; p < p1; p += 4)
+	{
+		if (_mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(l->phase + p), _mm256_set1_pd(BATCH_DONE), _CMP_EQ_OQ)) == 0xf)
+			continue;
+
+		__m256d z = _mm256_mul_pd(_mm256_loadu_pd(l->x + p), _mm256_set1_pd(w));
+		__m256d e = _mm256_loadu_pd(l->expZ + p);
+
+		//series for z < 1
+		__m256d nz = _mm256_xor_pd(z, signMask);
+		__m256d term = one;
+		__m256d phi1 = one, phi2 = _mm256_set1_pd(batch_recip[2]), phi3 = _mm256_set1_pd(batch_recip[3]);
+		for (int k = 1; k < BATCH_SERIES_TERMS; k++)
+		{
+			term = _mm256_mul_pd(term, _mm256_mul_pd(nz, _mm256_set1_pd(batch_recip[k])));
+			phi1 = _mm256_add_pd(phi1, _mm256_mul_pd(term, _mm256_set1_pd(batch_recip[k + 1])));
+			phi2 = _mm256_add_pd(phi2, _mm256_mul_pd(term, _mm256_set1_pd(batch_recip[k + 2])));
+			phi3 = _mm256_add_pd(phi3, _mm256_mul_pd(term, _mm256_set1_pd(batch_recip[k + 3])));
+		}
+
+		//closed form for z >= 1
+		__m256d zz = _mm256_mul_pd(z, z);
+		__m256d c1 = _mm256_div_pd(_mm256_sub_pd(one, e), z);
+		__m256d c2 = _mm256_div_pd(_mm256_sub_pd(one, _mm256_mul_pd(e, _mm256_add_pd(one, z))), zz);
+		__m256d poly = _mm256_add_pd(_mm256_add_pd(zz, _mm256_mul_pd(two, z)), two);
+		__m256d c3 = _mm256_div_pd(_mm256_sub_pd(two, _mm256_mul_pd(e, poly)), _mm256_mul_pd(zz, z));
+
+		__m256d small = _mm256_cmp_pd(z, one, _CMP_LT_OQ);
+		phi1 = _mm256_blendv_pd(c1, phi1, small);
+		phi2 = _mm256_blendv_pd(c2, phi2, small);
+		phi3 = _mm256_blendv_pd(c3, phi3, small);
+
+		__m256d m0 = _mm256_mul_pd(_mm256_set1_pd(w), phi1);
+		__m256d m1 = _mm256_mul_pd(_mm256_set1_pd(ww), phi2);
+		__m256d m2 = _mm256_mul_pd(_mm256_set1_pd(www), phi3);
+
+		__m256d expLo = one, g = zero, dg = zero, d2g = zero;
+		for (size_t b = 0; b < l->nbins; b++)
+		{
+			const double a = b * w;
+			__m256d va = _mm256_set1_pd(a), vaa = _mm256_set1_pd(a * a), va2 = _mm256_set1_pd(2 * a);
+			__m256d pe = _mm256_mul_pd(_mm256_loadu_pd(l->binProb + b * n + p), expLo);
+			g = _mm256_add_pd(g, _mm256_mul_pd(pe, m0));
+			dg = _mm256_add_pd(dg, _mm256_mul_pd(pe, _mm256_add_pd(_mm256_mul_pd(va, m0), m1)));
+			d2g = _mm256_add_pd(d2g, _mm256_mul_pd(pe,
+				_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(vaa, m0), _mm256_mul_pd(va2, m1)), m2)));
+			expLo = _mm256_mul_pd(expLo, e);
+		}
+
+		__m256d density = _mm256_loadu_pd(l->density + p);
+		_mm256_storeu_pd(l->f + p, _mm256_mul_pd(g, density));
+		_mm256_storeu_pd(l->df + p, _mm256_mul_pd(dg, _mm256_xor_pd(density, signMask)));
+		_mm256_storeu_pd(l->d2f + p, _mm256_mul_pd(d2g, density));
+	}
+}
+
+
+//************************************
+// Method:    Batch_Step_Avx2	Batch_Step_Scalar, branch-free, 4 plots per vector
+// FullName:  Batch_Step_Avx2
+// Access:    public
+// Returns:   size_t				number of lanes not done
+// Qualifier:
+// Parameter: batch_lanes * l		lanes, f, df and d2f evaluated at x
+// Parameter: size_t p0, p1			range of plots, p1 - p0 multiple of 4
+//************************************
+BATCH_TARGET_AVX2 size_t Batch_Step_Avx2(struct batch_lanes *l, size_t p0, size_t p1)
+{
+	const __m256d one = _mm256_set1_pd(1), two = _mm256_set1_pd(2), half = _mm256_set1_pd(0.5);
+	const __m256d zero = _mm256_setzero_pd();
+	const __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+	size_t nActive = 0;
+
+	for (size_t p = p0; p < p1; p += 4)
+	{
+		__m256d phase = _mm256_loadu_pd(l->phase + p);
+		__m256d done = _mm256_cmp_pd(phase, _mm256_set1_pd(BATCH_DONE), _CMP_EQ_OQ);
+		if (_mm256_movemask_pd(done) == 0xf)
+			continue;
+
+		__m256d chk = _mm256_cmp_pd(phase, _mm256_set1_pd(BATCH_CHECK_HI), _CMP_EQ_OQ);
+		__m256d act = _mm256_cmp_pd(phase, _mm256_set1_pd(BATCH_ACTIVE), _CMP_EQ_OQ);
+		__m256d x = _mm256_loadu_pd(l->x + p), x_prev = _mm256_loadu_pd(l->x_prev + p);
+		__m256d x_lo = _mm256_loadu_pd(l->x_lo + p), x_hi = _mm256_loadu_pd(l->x_hi + p);
+		__m256d hiChecked = _mm256_cmp_pd(_mm256_loadu_pd(l->hiChecked + p), zero, _CMP_NEQ_OQ);
+		__m256d iter = _mm256_loadu_pd(l->iter + p);
+		__m256d f = _mm256_sub_pd(_mm256_loadu_pd(l->f + p), _mm256_loadu_pd(l->gapFraction + p));
+		__m256d df = _mm256_loadu_pd(l->df + p), d2f = _mm256_loadu_pd(l->d2f + p);
+
+		//bracket check lanes
+		__m256d fPos = _mm256_cmp_pd(f, zero, _CMP_GT_OQ);
+		__m256d einval = _mm256_and_pd(chk, fPos);
+		__m256d chkOk = _mm256_andnot_pd(fPos, chk);
+
+		//iterating lanes: shrink the bracket
+		iter = _mm256_blendv_pd(iter, _mm256_add_pd(iter, one), act);
+		x_prev = _mm256_blendv_pd(x_prev, x, act);
+		__m256d root = _mm256_and_pd(act, _mm256_cmp_pd(f, zero, _CMP_EQ_OQ));
+		__m256d upd = _mm256_andnot_pd(root, act);
+		__m256d toHi = _mm256_andnot_pd(fPos, upd);
+		x_lo = _mm256_blendv_pd(x_lo, x, _mm256_and_pd(upd, fPos));
+		x_hi = _mm256_blendv_pd(x_hi, x, toHi);
+		hiChecked = _mm256_or_pd(hiChecked, _mm256_or_pd(toHi, chk));
+
+		//Halley, Newton and bisection candidates
+		__m256d mid = _mm256_mul_pd(half, _mm256_add_pd(x_lo, x_hi));
+		__m256d den = _mm256_sub_pd(_mm256_mul_pd(_mm256_mul_pd(two, df), df), _mm256_mul_pd(f, d2f));
+		__m256d denPos = _mm256_cmp_pd(den, zero, _CMP_GT_OQ);
+		__m256d x_halley = _mm256_sub_pd(x, _mm256_div_pd(_mm256_mul_pd(_mm256_mul_pd(two, f), df), den));
+		x_halley = _mm256_blendv_pd(x, x_halley, denPos);
+		__m256d x_newton = _mm256_sub_pd(x, _mm256_div_pd(f, df));
+		//bracket check lanes take the midpoint, as Batch_Step_Scalar
+		__m256d dfNeg = _mm256_andnot_pd(chk, _mm256_cmp_pd(df, zero, _CMP_LT_OQ));
+		//a step below BATCH_EPSABS has converged, also if it rounds to x (an end of the bracket)
+		const __m256d eps = _mm256_set1_pd(BATCH_EPSABS);
+		__m256d halleyDone = _mm256_and_pd(denPos, _mm256_cmp_pd(_mm256_and_pd(_mm256_sub_pd(x_halley, x), absMask), eps, _CMP_LT_OQ));
+		__m256d newtonDone = _mm256_cmp_pd(_mm256_and_pd(_mm256_sub_pd(x_newton, x), absMask), eps, _CMP_LT_OQ);
+		__m256d inHalley = _mm256_and_pd(dfNeg, _mm256_or_pd(halleyDone,
+			_mm256_and_pd(_mm256_cmp_pd(x_halley, x_lo, _CMP_GT_OQ), _mm256_cmp_pd(x_halley, x_hi, _CMP_LT_OQ))));
+		__m256d inNewton = _mm256_and_pd(dfNeg, _mm256_or_pd(newtonDone,
+			_mm256_and_pd(_mm256_cmp_pd(x_newton, x_lo, _CMP_GT_OQ), _mm256_cmp_pd(x_newton, x_hi, _CMP_LT_OQ))));
+		__m256d x_new = _mm256_blendv_pd(mid, x_newton, inNewton);
+		x_new = _mm256_blendv_pd(x_new, x_halley, inHalley);
+
+		//the root may lie beyond x_hi: evaluated with the next round
+		__m256d needChk = _mm256_andnot_pd(_mm256_or_pd(inHalley, inNewton), _mm256_and_pd(upd, dfNeg));
+		needChk = _mm256_andnot_pd(hiChecked, _mm256_and_pd(needChk, _mm256_cmp_pd(x_newton, x_hi, _CMP_GE_OQ)));
+
+		__m256d move = _mm256_or_pd(_mm256_andnot_pd(needChk, upd), chkOk);
+		x = _mm256_blendv_pd(x, x_hi, needChk);
+		x = _mm256_blendv_pd(x, x_new, move);
+		__m256d conv = _mm256_and_pd(move,
+			_mm256_cmp_pd(_mm256_and_pd(_mm256_sub_pd(x_new, x_prev), absMask), _mm256_set1_pd(BATCH_EPSABS), _CMP_LT_OQ));
+		__m256d maxIter = _mm256_andnot_pd(conv, _mm256_and_pd(move,
+			_mm256_cmp_pd(iter, _mm256_set1_pd(BATCH_MAX_ITER), _CMP_GE_OQ)));
+
+		__m256d success = _mm256_or_pd(root, conv);
+		__m256d finished = _mm256_or_pd(_mm256_or_pd(success, einval), maxIter);
+		phase = _mm256_blendv_pd(phase, _mm256_set1_pd(BATCH_ACTIVE), chkOk);
+		phase = _mm256_blendv_pd(phase, _mm256_set1_pd(BATCH_CHECK_HI), needChk);
+		phase = _mm256_blendv_pd(phase, _mm256_set1_pd(BATCH_DONE), finished);
+
+		_mm256_storeu_pd(l->phase + p, phase);
+		_mm256_storeu_pd(l->x + p, x);
+		_mm256_storeu_pd(l->x_prev + p, x_prev);
+		_mm256_storeu_pd(l->x_lo + p, x_lo);
+		_mm256_storeu_pd(l->x_hi + p, x_hi);
+		_mm256_storeu_pd(l->hiChecked + p, _mm256_and_pd(hiChecked, one));
+		_mm256_storeu_pd(l->iter + p, iter);
+
+		//status of the lanes finished in this step (rare)
+		int bits = _mm256_movemask_pd(finished);
+		int bitsSuccess = _mm256_movemask_pd(success), bitsEinval = _mm256_movemask_pd(einval);
+		for (int k = 0; k < 4; k++)
+			if (bits & (1 << k))
+				l->status[p + k] = (bitsSuccess & (1 << k)) ? GSL_SUCCESS :
+					(bitsEinval & (1 << k)) ? GSL_EINVAL : GSL_EMAXITER;
+
+		int bitsActive = ~_mm256_movemask_pd(_mm256_or_pd(done, finished)) & 0xf;
+		for (; bitsActive; bitsActive &= bitsActive - 1)
+			nActive++;
+	}
+
+	return nActive;
+}
+
+
+//************************************
+// Method:    Batch_fdf_Avx512	Batch_fdf_Scalar, 8 plots per vector
+// FullName:  Batch_fdf_Avx512
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: const batch_lanes * l		x of the lanes, f, df and d2f are returned
+// Parameter: size_t p0, p1				range of plots, p1 - p0 multiple of 8
+//************************************
+BATCH_TARGET_AVX512 void Batch_fdf_Avx512(const struct batch_lanes *l, size_t p0, size_t p1)
+{
+	const size_t n = l->nplots;
+	const double w = 1.0 / l->nbins, ww = w * w, www = ww * w;
+	const __m512d one = _mm512_set1_pd(1), two = _mm512_set1_pd(2), zero = _mm512_setzero_pd();
+
+	for (size_t p = p0; p < p1; p++)
+		l->expZ[p] = exp(-(l->x[p] * w));
+
+	for (size_t p = p0; p < p1; p += 8)
+	{
+		if (_mm512_cmp_pd_mask(_mm512_loadu_pd(l->phase + p), _mm512_set1_pd(BATCH_DONE), _CMP_EQ_OQ) == 0xff)
+			continue;
+
+		__m512d z = _mm512_mul_pd(_mm512_loadu_pd(l->x + p), _mm512_set1_pd(w));
+		__m512d e = _mm512_loadu_pd(l->expZ + p);
+
+		//series for z < 1
+		__m512d nz = _mm512_sub_pd(zero, z);
+		__m512d term = one;
+		__m512d phi1 = one, phi2 = _mm512_set1_pd(batch_recip[2]), phi3 = _mm512_set1_pd(batch_recip[3]);
+		for (int k = 1; k < BATCH_SERIES_TERMS; k++)
+		{
+			term = _mm512_mul_pd(term, _mm512_mul_pd(nz, _mm512_set1_pd(batch_recip[k])));
+			phi1 = _mm512_add_pd(phi1, _mm512_mul_pd(term, _mm512_set1_pd(batch_recip[k + 1])));
+			phi2 = _mm512_add_pd(phi2, _mm512_mul_pd(term, _mm512_set1_pd(batch_recip[k + 2])));
+			phi3 = _mm512_add_pd(phi3, _mm512_mul_pd(term, _mm512_set1_pd(batch_recip[k + 3])));
+		}
+
+		//closed form for z >= 1
+		__m512d zz = _mm512_mul_pd(z, z);
+		__m512d c1 = _mm512_div_pd(_mm512_sub_pd(one, e), z);
+		__m512d c2 = _mm512_div_pd(_mm512_sub_pd(one, _mm512_mul_pd(e, _mm512_add_pd(one, z))), zz);
+		__m512d poly = _mm512_add_pd(_mm512_add_pd(zz, _mm512_mul_pd(two, z)), two);
+		__m512d c3 = _mm512_div_pd(_mm512_sub_pd(two, _mm512_mul_pd(e, poly)), _mm512_mul_pd(zz, z));
+
+		__mmask8 small = _mm512_cmp_pd_mask(z, one, _CMP_LT_OQ);
+		phi1 = _mm512_mask_blend_pd(small, c1, phi1);
+		phi2 = _mm512_mask_blend_pd(small, c2, phi2);
+		phi3 = _mm512_mask_blend_pd(small, c3, phi3);
+
+		__m512d m0 = _mm512_mul_pd(_mm512_set1_pd(w), phi1);
+		__m512d m1 = _mm512_mul_pd(_mm512_set1_pd(ww), phi2);
+		__m512d m2 = _mm512_mul_pd(_mm512_set1_pd(www), phi3);
+
+		__m512d expLo = one, g = zero, dg = zero, d2g = zero;
+		for (size_t b = 0; b < l->nbins; b++)
+		{
+			const double a = b * w;
+			__m512d va = _mm512_set1_pd(a), vaa = _mm512_set1_pd(a * a), va2 = _mm512_set1_pd(2 * a);
+			__m512d pe = _mm512_mul_pd(_mm512_loadu_pd(l->binProb + b * n + p), expLo);
+			g = _mm512_add_pd(g, _mm512_mul_pd(pe, m0));
+			dg = _mm512_add_pd(dg, _mm512_mul_pd(pe, _mm512_add_pd(_mm512_mul_pd(va, m0), m1)));
+			d2g = _mm512_add_pd(d2g, _mm512_mul_pd(pe,
+				_mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(vaa, m0), _mm512_mul_pd(va2, m1)), m2)));
+			expLo = _mm512_mul_pd(expLo, e);
+		}
+
+		__m512d density = _mm512_loadu_pd(l->density + p);
+		_mm512_storeu_pd(l->f + p, _mm512_mul_pd(g, density));
+		_mm512_storeu_pd(l->df + p, _mm512_mul_pd(dg, _mm512_sub_pd(zero, density)));
+		_mm512_storeu_pd(l->d2f + p, _mm512_mul_pd(d2g, density));
+	}
+}
+
+
+//************************************
+// Method:    Batch_Step_Avx512	Batch_Step_Scalar, branch-free with mask registers, 8 plots per vector
+// FullName:  Batch_Step_Avx512
+// Access:    public
+// Returns:   size_t				number of lanes not done
+// Qualifier:
+// Parameter: batch_lanes * l		lanes, f, df and d2f evaluated at x
+// Parameter: size_t p0, p1			range of plots, p1 - p0 multiple of 8
+//************************************
+BATCH_TARGET_AVX512 size_t Batch_Step_Avx512(struct batch_lanes *l, size_t p0, size_t p1)
+{
+	const __m512d one = _mm512_set1_pd(1), two = _mm512_set1_pd(2), half = _mm512_set1_pd(0.5);
+	const __m512d zero = _mm512_setzero_pd();
+	size_t nActive = 0;
+
+	for (size_t p = p0; p < p1; p += 8)
+	{
+		__m512d phase = _mm512_loadu_pd(l->phase + p);
+		__mmask8 done = _mm512_cmp_pd_mask(phase, _mm512_set1_pd(BATCH_DONE), _CMP_EQ_OQ);
+		if (done == 0xff)
+			continue;
+
+		__mmask8 chk = _mm512_cmp_pd_mask(phase, _mm512_set1_pd(BATCH_CHECK_HI), _CMP_EQ_OQ);
+		__mmask8 act = _mm512_cmp_pd_mask(phase, _mm512_set1_pd(BATCH_ACTIVE), _CMP_EQ_OQ);
+		__m512d x = _mm512_loadu_pd(l->x + p), x_prev = _mm512_loadu_pd(l->x_prev + p);
+		__m512d x_lo = _mm512_loadu_pd(l->x_lo + p), x_hi = _mm512_loadu_pd(l->x_hi + p);
+		__mmask8 hiChecked = _mm512_cmp_pd_mask(_mm512_loadu_pd(l->hiChecked + p), zero, _CMP_NEQ_OQ);
+		__m512d iter = _mm512_loadu_pd(l->iter + p);
+		__m512d f = _mm512_sub_pd(_mm512_loadu_pd(l->f + p), _mm512_loadu_pd(l->gapFraction + p));
+		__m512d df = _mm512_loadu_pd(l->df + p), d2f = _mm512_loadu_pd(l->d2f + p);
+
+		//bracket check lanes
+		__mmask8 fPos = _mm512_cmp_pd_mask(f, zero, _CMP_GT_OQ);
+		__mmask8 einval = chk & fPos;
+		__mmask8 chkOk = chk & ~fPos;
+
+		//iterating lanes: shrink the bracket
+		iter = _mm512_mask_add_pd(iter, act, iter, one);
+		x_prev = _mm512_mask_blend_pd(act, x_prev, x);
+		__mmask8 root = act & _mm512_cmp_pd_mask(f, zero, _CMP_EQ_OQ);
+		__mmask8 upd = act & ~root;
+		__mmask8 toHi = upd & ~fPos;
+		x_lo = _mm512_mask_blend_pd(upd & fPos, x_lo, x);
+		x_hi = _mm512_mask_blend_pd(toHi, x_hi, x);
+		hiChecked |= toHi | chk;
+
+		//Halley, Newton and bisection candidates
+		__m512d mid = _mm512_mul_pd(half, _mm512_add_pd(x_lo, x_hi));
+		__m512d den = _mm512_sub_pd(_mm512_mul_pd(_mm512_mul_pd(two, df), df), _mm512_mul_pd(f, d2f));
+		__mmask8 denPos = _mm512_cmp_pd_mask(den, zero, _CMP_GT_OQ);
+		__m512d x_halley = _mm512_sub_pd(x, _mm512_div_pd(_mm512_mul_pd(_mm512_mul_pd(two, f), df), den));
+		x_halley = _mm512_mask_blend_pd(denPos, x, x_halley);
+		__m512d x_newton = _mm512_sub_pd(x, _mm512_div_pd(f, df));
+		//bracket check lanes take the midpoint, as Batch_Step_Scalar
+		__mmask8 dfNeg = _mm512_cmp_pd_mask(df, zero, _CMP_LT_OQ) & ~chk;
+		//a step below BATCH_EPSABS has converged, also if it rounds to x (an end of the bracket)
+		const __m512d eps = _mm512_set1_pd(BATCH_EPSABS);
+		__mmask8 halleyDone = denPos & _mm512_cmp_pd_mask(_mm512_abs_pd(_mm512_sub_pd(x_halley, x)), eps, _CMP_LT_OQ);
+		__mmask8 newtonDone = _mm512_cmp_pd_mask(_mm512_abs_pd(_mm512_sub_pd(x_newton, x)), eps, _CMP_LT_OQ);
+		__mmask8 inHalley = dfNeg & (halleyDone | (_mm512_cmp_pd_mask(x_halley, x_lo, _CMP_GT_OQ) & _mm512_cmp_pd_mask(x_halley, x_hi, _CMP_LT_OQ)));
+		__mmask8 inNewton = dfNeg & (newtonDone | (_mm512_cmp_pd_mask(x_newton, x_lo, _CMP_GT_OQ) & _mm512_cmp_pd_mask(x_newton, x_hi, _CMP_LT_OQ)));
+		__m512d x_new = _mm512_mask_blend_pd(inNewton, mid, x_newton);
+		x_new = _mm512_mask_blend_pd(inHalley, x_new, x_halley);
+
+		//the root may lie beyond x_hi: evaluated with the next round
+		__mmask8 needChk = upd & dfNeg & ~(inHalley | inNewton) & ~hiChecked
+			& _mm512_cmp_pd_mask(x_newton, x_hi, _CMP_GE_OQ);
+
+		__mmask8 move = (upd & ~needChk) | chkOk;
+		x = _mm512_mask_blend_pd(needChk, x, x_hi);
+		x = _mm512_mask_blend_pd(move, x, x_new);
+		__mmask8 conv = move & _mm512_cmp_pd_mask(_mm512_abs_pd(_mm512_sub_pd(x_new, x_prev)), _mm512_set1_pd(BATCH_EPSABS), _CMP_LT_OQ);
+		__mmask8 maxIter = move & ~conv & _mm512_cmp_pd_mask(iter, _mm512_set1_pd(BATCH_MAX_ITER), _CMP_GE_OQ);
+
+		__mmask8 success = root | conv;
+		__mmask8 finished = success | einval | maxIter;
+		phase = _mm512_mask_blend_pd(chkOk, phase, _mm512_set1_pd(BATCH_ACTIVE));
+		phase = _mm512_mask_blend_pd(needChk, phase, _mm512_set1_pd(BATCH_CHECK_HI));
+		phase = _mm512_mask_blend_pd(finished, phase, _mm512_set1_pd(BATCH_DONE));
+
+		_mm512_storeu_pd(l->phase + p, phase);
+		_mm512_storeu_pd(l->x + p, x);
+		_mm512_storeu_pd(l->x_prev + p, x_prev);
+		_mm512_storeu_pd(l->x_lo + p, x_lo);
+		_mm512_storeu_pd(l->x_hi + p, x_hi);
+		_mm512_storeu_pd(l->hiChecked + p, _mm512_maskz_mov_pd(hiChecked, one));
+		_mm512_storeu_pd(l->iter + p, iter);
+
+		//status of the lanes finished in this step (rare)
+		for (int k = 0; k < 8; k++)
+			if (finished & (1 << k))
+				l->status[p + k] = (success & (1 << k)) ? GSL_SUCCESS :
+					(einval & (1 << k)) ? GSL_EINVAL : GSL_EMAXITER;
+
+		unsigned int bitsActive = ~(unsigned int)(done | finished) & 0xff;
+		for (; bitsActive; bitsActive &= bitsActive - 1)
+			nActive++;
+	}
+
+	return nActive;
+}
+
+#else
+
+//no x86: LAI_PATH_Batch never selects these, defined for the linker
+void Batch_fdf_Avx2(const struct batch_lanes *l, size_t p0, size_t p1) { Batch_fdf_Scalar(l, p0, p1); }
+size_t Batch_Step_Avx2(struct batch_lanes *l, size_t p0, size_t p1) { return Batch_Step_Scalar(l, p0, p1); }
+void Batch_fdf_Avx512(const struct batch_lanes *l, size_t p0, size_t p1) { Batch_fdf_Scalar(l, p0, p1); }
+size_t Batch_Step_Avx512(struct batch_lanes *l, size_t p0, size_t p1) { return Batch_Step_Scalar(l, p0, p1); }
+
+#endif
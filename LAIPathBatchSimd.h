@@ -0,0 +1,79 @@
+/*!
+* \file LAIPathBatchSimd.h
+* \date
+*			2026/10/17	Lanes of the lockstep LAImax solve of LAI_PATH_Batch, AVX2 / AVX-512 kernels
+*
+* \brief
+*		One lane per plot. A round evaluates Eq(13) and its derivatives at x of every lane
+*		(Batch_fdf_*), then advances every lane by one safeguarded Halley step (Batch_Step_*).
+*		The step is branch-free: Halley, Newton and bisection candidates are all computed and
+*		selected by masks, lanes that are done keep their values.
+*
+*		Scalar, AVX2 and AVX-512 versions perform the same operations in the same order,
+*		results are identical. SIMD versions require (p1 - p0) to be a multiple of the width.
+*
+*/
+
+#pragma once
+
+#include "LAIPathBatch.h"
+
+//kernels are compiled for AVX2 or AVX-512 individually
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define BATCH_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define BATCH_TARGET_AVX2
+#define BATCH_TARGET_AVX512
+#elif defined(__clang__)
+#define BATCH_TARGET_AVX2	__attribute__((target("avx2")))
+#define BATCH_TARGET_AVX512	__attribute__((target("avx512f")))
+#else
+//avx512f enables FMA, GCC would contract the intrinsics
+#define BATCH_TARGET_AVX2	__attribute__((target("avx2")))
+#define BATCH_TARGET_AVX512	__attribute__((target("avx512f"), optimize("fp-contract=off")))
+#endif
+#endif
+
+//phase of the LAImax solve of one lane
+#define BATCH_ACTIVE		0
+#define BATCH_CHECK_HI		1		//x = x_hi is evaluated to check the bracket
+#define BATCH_DONE			2
+
+#define BATCH_MAX_ITER		100
+#define BATCH_EPSABS		0.0001
+#define BATCH_BLOCK			512		//plots solved together, multiple of the vector widths
+#define BATCH_SERIES_TERMS	18		//terms of the series of the bin moments for z < 1
+
+struct batch_lanes
+{
+	size_t nplots;
+	size_t nbins;
+	const double *binProb;		//nbins x nplots
+	const double *gapFraction;
+	const double *density;		//nbins / sum of frequencies of each plot
+
+	double *x, *x_prev, *x_lo, *x_hi;
+	double *f, *df, *d2f;		//gap fraction and derivatives at x
+	double *expZ;				//scratch, exp(-x / nbins)
+	double *m0, *m1, *m2, *expLo;	//scratch of Batch_fdf_Scalar
+	double *phase;				//BATCH_ACTIVE, BATCH_CHECK_HI, BATCH_DONE
+	double *hiChecked;			//1: f(x_hi) <= 0 is known
+	double *iter;
+	int *status;				//GSL_CONTINUE until done
+};
+
+//1 / k for the series of the bin moments
+extern const double batch_recip[BATCH_SERIES_TERMS + 3];
+
+void Batch_fdf_Scalar(const struct batch_lanes *l, size_t p0, size_t p1);
+size_t Batch_Step_Scalar(struct batch_lanes *l, size_t p0, size_t p1);
+
+void Batch_fdf_Avx2(const struct batch_lanes *l, size_t p0, size_t p1);
+size_t Batch_Step_Avx2(struct batch_lanes *l, size_t p0, size_t p1);
+
+void Batch_fdf_Avx512(const struct batch_lanes *l, size_t p0, size_t p1);
+size_t Batch_Step_Avx512(struct batch_lanes *l, size_t p0, size_t p1);
+
+int Batch_SupportedIsa();
@@ -0,0 +1,465 @@
+/*!
+* \file LAIPathBench.cpp
+* \date
+*			2026/10/17	Microbenchmarks of the numerical kernels, JSON results (LAI_PATH_bench)
+*			2026/10/17	-pareto: accuracy / speed of the solver configurations (LAIPathPareto.cpp)
+*			2026/10/17	LAI_PATH_Exact by samples and instruction set
+*
+* \brief
+*		Time per call of Stat_hist, Func_GapBiasFromLAImax (quadrature and closed form),
+*		LAI_PATH (closed form and quadrature), LAI_PATH_Exact (scalar and SIMD sums, LaiPathPool)
+*		and LAI_PATH_Circle, swept over
+*			samples		10^2 ... -max_samples (10^9 needs 8 GB)
+*			bins		8 ... 4096
+*			gap			0.01 ... 0.9
+*			shape		uniform, skewed (as input_example1.txt: max of 3 uniforms), spike (25% at 0)
+*		Every case is repeated -reps times, each repetition calls the kernel until -min_time
+*		seconds have passed; the minimum and the median ns per call are written as JSON with
+*		the CPU, compiler and LAI_PATH_VERSION, to compare commits and machines.
+*
+*		LAI_PATH_bench -o results.json
+*		LAI_PATH_bench -kernel LAI_PATH -min_time 0.2 -reps 9
+*		LAI_PATH_bench -pareto -plots 500 -golden . -o pareto.json
+*
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <new>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#include "LAIPath.h"
+#include "LAIPathCompat.h"
+#include "LAIPathBatch.h"
+#include "LAIPathBatchSimd.h"
+#include "LAIPathBench.h"
+#include "LAIPathExact.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+#define BENCH_SHAPES		3
+#define BENCH_HIST_SAMPLES	100000		//samples of the histograms solved by the LAI_PATH kernels
+#define BENCH_ZENITH		0
+#define BENCH_G				0.5
+
+static const char *const bench_shapes[BENCH_SHAPES] = { "uniform", "skewed", "spike" };
+static const size_t bench_bins[] = { 8, 25, 64, 256, 1024, 4096 };
+static const double bench_gaps[] = { 0.01, 0.05, 0.1, 0.3, 0.6, 0.9 };
+
+struct bench_options
+{
+	double minTime;			//seconds per repetition
+	int reps;
+	double maxSamples;
+	const char *kernel;		//0: all
+};
+
+struct bench_case
+{
+	const char *kernel;
+	const char *shape;		//0: not swept
+	size_t samples;			//0: not swept
+	size_t bins;			//0: not swept
+	double gap;				//0: not swept
+	const char *integration;	//0: not swept
+};
+
+static volatile double g_sink;		//results of the calls, not optimized away
+
+
+//path lengths of a shape, in (0, 1] except the spike
+static void Bench_Sample(int shape, size_t n, double *out)
+{
+	uint64_t state = 20261017;
+	for (size_t i = 0; i < n; i++)
+	{
+		double u = Bench_Uniform(&state);
+		if (shape == 1)
+			u = GSL_MAX(u, GSL_MAX(Bench_Uniform(&state), Bench_Uniform(&state)));
+		else if (shape == 2 && Bench_Uniform(&state) < 0.25)
+			u = 0;
+		out[i] = u;
+	}
+}
+
+
+static void Bench_CpuName(char *name, size_t size)
+{
+	snprintf(name, size, "unknown");
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+	unsigned int brand[12];
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 0x80000000);
+	if ((unsigned int)info[0] < 0x80000004)
+		return;
+	for (int k = 0; k < 3; k++)
+	{
+		__cpuid(info, 0x80000002 + k);
+		memcpy(brand + 4 * k, info, sizeof(info));
+	}
+#else
+	if (__get_cpuid_max(0x80000000, 0) < 0x80000004)
+		return;
+	for (unsigned int k = 0; k < 3; k++)
+		__get_cpuid(0x80000002 + k, &brand[4 * k], &brand[4 * k + 1], &brand[4 * k + 2], &brand[4 * k + 3]);
+#endif
+	char text[sizeof(brand) + 1];
+	memcpy(text, brand, sizeof(brand));
+	text[sizeof(brand)] = '\0';
+	const char *p = text;
+	while (*p == ' ')
+		p++;
+	snprintf(name, size, "%s", p);
+	for (char *q = name; *q; q++)
+		if (*q == '"' || *q == '\\')
+			*q = ' ';
+#endif
+}
+
+
+//************************************
+// Method:    Bench_Run			Time a kernel: reps repetitions of at least minTime seconds
+// FullName:  Bench_Run
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: FILE * out			JSON
+// Parameter: const bench_options * options
+// Parameter: const bench_case * c	fields of the result
+// Parameter: bool * first			no comma before the first result
+// Parameter: F call				one call of the kernel, returns a value for g_sink
+//************************************
+template <class F>
+static void Bench_Run(FILE *out, const struct bench_options *options, const struct bench_case *c, bool *first, F call)
+{
+	typedef std::chrono::steady_clock clock;
+
+	gsl_error_state *error = LAI_PATH_ErrorState();
+	error->gsl_errno = GSL_SUCCESS;
+	g_sink = call();						//warm up: caches, workspaces, page faults
+	const int gsl_errno = error->gsl_errno;
+
+	std::vector<double> ns(options->reps);
+	size_t calls = 1;
+	for (int r = 0; r < options->reps; r++)
+	{
+		size_t n = 0;
+		double sum = 0;
+		clock::time_point t0 = clock::now(), t1;
+		for (;;)
+		{
+			for (size_t i = 0; i < calls; i++)
+				sum += call();
+			n += calls;
+			t1 = clock::now();
+			if (std::chrono::duration<double>(t1 - t0).count() >= options->minTime)
+				break;
+			calls *= 2;
+		}
+		g_sink = sum;
+		ns[r] = std::chrono::duration<double, std::nano>(t1 - t0).count() / n;
+		calls = GSL_MAX(n / 2, (size_t)1);	//next repetition: about minTime in one or two rounds
+	}
+	std::sort(ns.begin(), ns.end());
+
+	fprintf(out, "%s\n    {\"kernel\": \"%s\"", *first ? "" : ",", c->kernel);
+	if (c->shape)
+		fprintf(out, ", \"shape\": \"%s\"", c->shape);
+	if (c->samples)
+		fprintf(out, ", \"samples\": %zu", c->samples);
+	if (c->bins)
+		fprintf(out, ", \"bins\": %zu", c->bins);
+	if (c->gap > 0)
+		fprintf(out, ", \"gap_fraction\": %g", c->gap);
+	if (c->integration)
+		fprintf(out, ", \"integration\": \"%s\"", c->integration);
+	fprintf(out, ", \"ns_min\": %.1f, \"ns_median\": %.1f", ns[0], ns[ns.size() / 2]);
+	if (c->samples)
+		fprintf(out, ", \"ns_per_sample\": %.4f", ns[0] / c->samples);
+	fprintf(out, ", \"gsl_errno\": %d}", gsl_errno);
+	fflush(out);
+	*first = false;
+
+	fprintf(stderr, "%-32s %-8s %10zu %5zu %5g %-10s %14.1f ns\n", c->kernel, c->shape ? c->shape : "", c->samples, c->bins,
+		c->gap, c->integration ? c->integration : "", ns[0]);
+}
+
+
+static bool Bench_Selected(const struct bench_options *options, const char *kernel)
+{
+	return options->kernel == 0 || strcmp(options->kernel, kernel) == 0;
+}
+
+
+//histogram path length distribution of a shape (the input of the LAI_PATH kernels)
+static gsl_histogram *Bench_Histogram(int shape, size_t bins)
+{
+	std::vector<double> data(BENCH_HIST_SAMPLES);
+	Bench_Sample(shape, data.size(), data.data());
+	gsl_histogram *h = gsl_histogram_alloc(bins);
+	Stat_hist(data.data(), (unsigned long)data.size(), h);
+	return h;
+}
+
+
+static void Bench_StatHist(FILE *out, const struct bench_options *options, bool *first)
+{
+	for (double samples = 100; samples <= options->maxSamples; samples *= 10)
+		for (int shape = 0; shape < BENCH_SHAPES; shape++)
+		{
+			std::vector<double> data;
+			try
+			{
+				data.resize((size_t)samples);
+			}
+			catch (const std::bad_alloc &)
+			{
+				fprintf(stderr, "WARNING: no memory for %.0f path lengths, skipped\n", samples);
+				return;
+			}
+			Bench_Sample(shape, data.size(), data.data());
+			for (size_t b = 0; b < sizeof(bench_bins) / sizeof(bench_bins[0]); b++)
+			{
+				struct bench_case c = { "Stat_hist", bench_shapes[shape], data.size(), bench_bins[b], 0, 0 };
+				gsl_histogram *h = gsl_histogram_alloc(bench_bins[b]);
+				//path lengths are normalized in place by the first call, the later calls see the same shape
+				Bench_Run(out, options, &c, first, [&]() { Stat_hist(data.data(), (unsigned long)data.size(), h); return h->bin[0]; });
+				gsl_histogram_free(h);
+			}
+		}
+}
+
+
+static void Bench_GapBias(FILE *out, const struct bench_options *options, bool *first)
+{
+	gsl_integration_workspace *w = gsl_integration_workspace_alloc(1000);
+	for (int shape = 0; shape < BENCH_SHAPES; shape++)
+		for (size_t b = 0; b < sizeof(bench_bins) / sizeof(bench_bins[0]); b++)
+		{
+			gsl_histogram *h = Bench_Histogram(shape, bench_bins[b]);
+			for (size_t g = 0; g < sizeof(bench_gaps) / sizeof(bench_gaps[0]); g++)
+			{
+				//cost function in the middle of the bracket [effLAI, LAI_PATH_BRACKET * effLAI]
+				const double LAImax = -log(bench_gaps[g]) * (1 + LAI_PATH_BRACKET) / 2;
+				struct params_GapBiasFromLAImax params = { h, bench_gaps[g], w };
+
+				struct bench_case c = { "Func_GapBiasFromLAImax", bench_shapes[shape], 0, bench_bins[b], bench_gaps[g], "quadrature" };
+				if (Bench_Selected(options, c.kernel))
+					Bench_Run(out, options, &c, first, [&]() { return Func_GapBiasFromLAImax(LAImax, &params); });
+
+				c.kernel = "Func_GapBiasFromLAImax_Analytic";
+				c.integration = "analytic";
+				if (Bench_Selected(options, c.kernel))
+					Bench_Run(out, options, &c, first, [&]() { return Func_GapBiasFromLAImax_Analytic(LAImax, &params); });
+			}
+			gsl_histogram_free(h);
+		}
+	gsl_integration_workspace_free(w);
+}
+
+
+static void Bench_LAIPath(FILE *out, const struct bench_options *options, bool *first)
+{
+	for (int shape = 0; shape < BENCH_SHAPES; shape++)
+		for (size_t b = 0; b < sizeof(bench_bins) / sizeof(bench_bins[0]); b++)
+		{
+			gsl_histogram *h = Bench_Histogram(shape, bench_bins[b]);
+			for (size_t g = 0; g < sizeof(bench_gaps) / sizeof(bench_gaps[0]); g++)
+			{
+				const double gap = bench_gaps[g];
+				struct bench_case c = { "LAI_PATH", bench_shapes[shape], 0, bench_bins[b], gap, "analytic" };
+				Bench_Run(out, options, &c, first, [&]() { return LAI_PATH(h, gap, BENCH_ZENITH, BENCH_G, LAI_PATH_ANALYTIC); });
+				c.integration = "quadrature";
+				Bench_Run(out, options, &c, first, [&]() { return LAI_PATH(h, gap, BENCH_ZENITH, BENCH_G, LAI_PATH_QUADRATURE); });
+			}
+			gsl_histogram_free(h);
+		}
+}
+
+
+//exact-sample mode: the path lengths instead of their histogram, scalar and the best SIMD sums
+static void Bench_Exact(FILE *out, const struct bench_options *options, bool *first)
+{
+	static const char *const exact_isa[] = { "exact scalar", "exact avx2", "exact avx512" };
+	const int isas[2] = { BATCH_ISA_SCALAR, Batch_SupportedIsa() };
+	const int nIsas = (isas[1] != BATCH_ISA_SCALAR) ? 2 : 1;
+	LaiPathPool pool;
+	for (double samples = 100; samples <= options->maxSamples; samples *= 10)
+		for (int shape = 0; shape < BENCH_SHAPES; shape++)
+		{
+			std::vector<double> data;
+			try
+			{
+				data.resize((size_t)samples);
+			}
+			catch (const std::bad_alloc &)
+			{
+				fprintf(stderr, "WARNING: no memory for %.0f path lengths, skipped\n", samples);
+				return;
+			}
+			Bench_Sample(shape, data.size(), data.data());
+			for (int i = 0; i < nIsas; i++)
+			{
+				struct path_samples s;
+				Exact_Samples(data.data(), data.size(), &s, isas[i]);
+				for (size_t g = 0; g < sizeof(bench_gaps) / sizeof(bench_gaps[0]); g++)
+				{
+					const double gap = bench_gaps[g];
+					struct bench_case c = { "LAI_PATH_Exact", bench_shapes[shape], data.size(), 0, gap, exact_isa[isas[i]] };
+					Bench_Run(out, options, &c, first, [&]() { return LAI_PATH_Exact(&s, gap, BENCH_ZENITH, BENCH_G, 0, &pool); });
+				}
+			}
+		}
+}
+
+
+static void Bench_Circle(FILE *out, const struct bench_options *options, bool *first)
+{
+	for (size_t g = 0; g < sizeof(bench_gaps) / sizeof(bench_gaps[0]); g++)
+	{
+		const double gap = bench_gaps[g];
+		struct bench_case c = { "LAI_PATH_Circle", 0, 0, 0, gap, 0 };
+		Bench_Run(out, options, &c, first, [&]() { return LAI_PATH_Circle(gap, BENCH_ZENITH, BENCH_G); });
+	}
+}
+
+
+void usage()
+{
+	fprintf(stderr, "LAI_PATH_bench -o results.json    (all kernels, JSON on stdout without -o)\n");
+	fprintf(stderr, "LAI_PATH_bench -kernel Stat_hist    (Stat_hist, Func_GapBiasFromLAImax, Func_GapBiasFromLAImax_Analytic, LAI_PATH, LAI_PATH_Exact, LAI_PATH_Circle)\n");
+	fprintf(stderr, "LAI_PATH_bench -min_time 0.05 -reps 5    (seconds per repetition, repetitions)\n");
+	fprintf(stderr, "LAI_PATH_bench -max_samples 1e7    (largest Stat_hist and LAI_PATH_Exact input, 1e9: 8 GB)\n");
+	fprintf(stderr, "LAI_PATH_bench -pareto -plots 500 -golden .    (error against a reference and plots/s of the configurations, example outputs checked)\n");
+	exit(1);
+}
+
+
+int main(int argc, char *argv[])
+{
+	struct bench_options options = { 0.05, 5, 1e7, 0 };
+	const char *fname_out = 0;
+	bool pareto = false;
+	size_t nPlots = 500;						// -pareto corpus
+	const char *golden = ".";					// -pareto: input_example1..3.txt, _out.txt
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "-help") == 0)
+		{
+			usage();
+		}
+		else if (strcmp(argv[i], "-pareto") == 0)
+		{
+			pareto = true;
+		}
+		else if ((i + 1) >= argc)
+		{
+			fprintf(stderr, "ERROR: '%s' needs 1 argument: stop\n", argv[i]);
+			return 1;
+		}
+		else if (strcmp(argv[i], "-o") == 0)
+		{
+			fname_out = argv[++i];
+		}
+		else if (strcmp(argv[i], "-kernel") == 0)
+		{
+			options.kernel = argv[++i];
+		}
+		else if (strcmp(argv[i], "-min_time") == 0)
+		{
+			options.minTime = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-reps") == 0)
+		{
+			options.reps = atoi(argv[++i]);
+			if (options.reps < 1)
+				options.reps = 1;
+		}
+		else if (strcmp(argv[i], "-max_samples") == 0)
+		{
+			options.maxSamples = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-plots") == 0)
+		{
+			nPlots = (size_t)atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-golden") == 0)
+		{
+			golden = argv[++i];
+		}
+		else
+		{
+			fprintf(stderr, "ERROR: cannot understand argument '%s'\n", argv[i]);
+			usage();
+		}
+	}
+
+	FILE *out = stdout;
+	if (fname_out && fopen_s(&out, fname_out, "w") != 0)
+	{
+		fprintf(stderr, "ERROR: could not open '%s' for writing\n", fname_out);
+		return 1;
+	}
+	gsl_set_error_handler(&LAI_PATH_ErrorHandler);			//GSL errors are reported per case, not fatal
+
+	if (pareto)
+	{
+		int status = Pareto_Run(nPlots, golden, out);
+		if (out != stdout)
+			fclose(out);
+		return status;
+	}
+
+	char cpu[64];
+	Bench_CpuName(cpu, sizeof(cpu));
+	static const char *const isa_names[] = { "scalar", "avx2", "avx512" };
+	const int isa = Batch_SupportedIsa();
+	char date[32];
+	time_t now = time(0);
+	struct tm utc;
+	gmtime_s(&utc, &now);
+	strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", &utc);
+#if defined(_MSC_VER)
+	char compiler[32];
+	snprintf(compiler, sizeof(compiler), "MSVC %d", _MSC_FULL_VER);
+#elif defined(__clang__)
+	const char *compiler = "clang " __clang_version__;
+#elif defined(__GNUC__)
+	const char *compiler = "gcc " __VERSION__;
+#else
+	const char *compiler = "unknown";
+#endif
+
+	fprintf(out, "{\n  \"version\": %d,\n  \"date\": \"%s\",\n  \"cpu\": \"%s\",\n  \"isa\": \"%s\",\n  \"threads\": %u,\n"
+		"  \"compiler\": \"%s\",\n  \"min_time\": %g,\n  \"reps\": %d,\n  \"results\": [",
+		LAI_PATH_VERSION, date, cpu, (isa >= BATCH_ISA_SCALAR && isa <= BATCH_ISA_AVX512) ? isa_names[isa] : "unknown", std::thread::hardware_concurrency(),
+		compiler, options.minTime, options.reps);
+
+	bool first = true;
+	if (Bench_Selected(&options, "Stat_hist"))
+		Bench_StatHist(out, &options, &first);
+	if (Bench_Selected(&options, "Func_GapBiasFromLAImax") || Bench_Selected(&options, "Func_GapBiasFromLAImax_Analytic"))
+		Bench_GapBias(out, &options, &first);
+	if (Bench_Selected(&options, "LAI_PATH"))
+		Bench_LAIPath(out, &options, &first);
+	if (Bench_Selected(&options, "LAI_PATH_Exact"))
+		Bench_Exact(out, &options, &first);
+	if (Bench_Selected(&options, "LAI_PATH_Circle"))
+		Bench_Circle(out, &options, &first);
+
+	fprintf(out, "\n  ]\n}\n");
+	if (out != stdout)
+		fclose(out);
+	return 0;
+}
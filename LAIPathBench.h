@@ -0,0 +1,25 @@
+/*!
+* \file LAIPathBench.h
+* \date
+*			2026/10/17	Shared by the sources of LAI_PATH_bench
+*			2026/10/17	Accuracy / speed of the solver configurations (LAIPathPareto.cpp)
+*
+*/
+
+#pragma once
+
+#include <cstdio>
+#include <stdint.h>
+
+//splitmix64, the same path lengths on every machine
+static inline double Bench_Uniform(uint64_t *state)
+{
+	uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	z ^= z >> 31;
+	return (z >> 11) * (1.0 / 9007199254740992.0);
+}
+
+//returns 1 if the example outputs in goldenDir are not reproduced
+int Pareto_Run(size_t nPlots, const char *goldenDir, FILE *out);
@@ -0,0 +1,328 @@
+/*!
+* \file LAIPathBinary.cpp
+* \date
+*			2026/10/17	Binary path lengths (NPY, raw float32 / float64), read in place
+*
+*/
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "LAIPathBinary.h"
+#include "PathHist.h"
+#include "LAIPathProfile.h"
+#include "LAIPathCounters.h"
+
+#define NPY_MAGIC		"\x93NUMPY"
+#define NPY_MAGIC_LEN	6
+
+
+//file name extension, case-insensitive
+static bool Binary_IsExt(const char *ext, const char *expected)
+{
+	for (; *ext && tolower((unsigned char)*ext) == *expected; ext++, expected++)
+		;
+	return *ext == '\0' && *expected == '\0';
+}
+
+
+//************************************
+// Method:    LAIPathBinary_Format	Format of an input file by its extension
+// FullName:  LAIPathBinary_Format
+// Access:    public
+// Returns:   int					INPUT_FLOAT32 (.npy: format of the array is read later, .f32), INPUT_FLOAT64 (.f64), INPUT_TEXT
+// Qualifier:
+// Parameter: const char * fname
+//************************************
+int LAIPathBinary_Format(const char *fname)
+{
+	const char *ext = strrchr(fname, '.');
+	if (ext == 0 || strpbrk(ext, "/\\") != 0)
+		return INPUT_TEXT;
+	if (Binary_IsExt(ext, ".npy") || Binary_IsExt(ext, ".f32"))
+		return INPUT_FLOAT32;
+	if (Binary_IsExt(ext, ".f64"))
+		return INPUT_FLOAT64;
+	return INPUT_TEXT;
+}
+
+
+//file name with extension .npy, case-insensitive as LAIPathBinary_Format
+bool LAIPathBinary_IsNpy(const char *fname)
+{
+	const char *ext = strrchr(fname, '.');
+	return ext != 0 && Binary_IsExt(ext, ".npy");
+}
+
+
+//value of key in the header dictionary of a NPY file, e.g. 'descr': '<f4' or 'shape': (100, 3)
+static const char *Npy_Value(const std::string &dict, const char *key)
+{
+	size_t pos = dict.find(key);
+	if (pos == std::string::npos)
+		return 0;
+	pos = dict.find(':', pos + strlen(key));
+	if (pos == std::string::npos)
+		return 0;
+	pos = dict.find_first_not_of(" ", pos + 1);
+	return (pos == std::string::npos) ? 0 : dict.c_str() + pos;
+}
+
+
+//data type, first value and number of values of a NPY file (format 1.0 - 3.0)
+static int Npy_Header(const char *p, size_t size, int *format, size_t *offset, size_t *nValues)
+{
+	if (size < 10 || memcmp(p, NPY_MAGIC, NPY_MAGIC_LEN) != 0)
+		return GSL_EINVAL;
+
+	const unsigned char *u = reinterpret_cast<const unsigned char *>(p);
+	size_t dictStart, dictLen;
+	if (u[6] == 1)
+	{
+		dictStart = 10;
+		dictLen = u[8] | (size_t)u[9] << 8;
+	}
+	else if ((u[6] == 2 || u[6] == 3) && size >= 12)
+	{
+		dictStart = 12;
+		dictLen = u[8] | (size_t)u[9] << 8 | (size_t)u[10] << 16 | (size_t)u[11] << 24;
+	}
+	else
+		return GSL_EINVAL;
+	if (dictStart + dictLen > size)
+		return GSL_EINVAL;
+	std::string dict(p + dictStart, dictLen);
+	*offset = dictStart + dictLen;
+
+	//'<f4' or '<f8', little-endian
+	const char *descr = Npy_Value(dict, "'descr'");
+	if (descr == 0 || (*descr != '\'' && *descr != '"'))
+		return GSL_EINVAL;
+	if (strncmp(descr + 1, "<f4", 3) == 0)
+		*format = INPUT_FLOAT32;
+	else if (strncmp(descr + 1, "<f8", 3) == 0)
+		*format = INPUT_FLOAT64;
+	else
+		return GSL_EINVAL;
+
+	//product of the dimensions, () is a single value; fortran_order does not matter
+	const char *shape = Npy_Value(dict, "'shape'");
+	if (shape == 0 || *shape != '(')
+		return GSL_EINVAL;
+	*nValues = 1;
+	for (const char *s = shape + 1; *s != ')'; )
+	{
+		char *next;
+		unsigned long long dim = strtoull(s, &next, 10);
+		if (next == s)
+			return GSL_EINVAL;
+		*nValues *= (size_t)dim;
+		s = next + strspn(next, ", ");
+	}
+	return GSL_SUCCESS;
+}
+
+
+//************************************
+// Method:    LAIPathBinary_Open	Map a binary input file, header from the sidecar file
+// FullName:  LAIPathBinary_Open
+// Access:    public
+// Returns:   int					GSL_SUCCESS, GSL_EFAILED (file or sidecar cannot be opened), GSL_EINVAL (header incomplete, not a float array)
+// Qualifier:
+// Parameter: lai_path_input * in	in->format: LAIPathBinary_Format of fname
+// Parameter: const char * fname
+// Parameter: const char * fnameHeader	sidecar header, 0: fname with extension BINARY_HEADER_EXT, "": none (header NaN)
+//************************************
+int LAIPathBinary_Open(struct lai_path_input *in, const char *fname, const char *fnameHeader)
+{
+	//header lines of the sidecar, as a text input file
+	std::string sidecar;
+	if (fnameHeader == 0)
+	{
+		sidecar.assign(fname, strrchr(fname, '.'));
+		sidecar += BINARY_HEADER_EXT;
+		fnameHeader = sidecar.c_str();
+	}
+	if (fnameHeader[0] == '\0')
+	{
+		for (int i = 0; i < INPUT_HEADER_LINES; i++)
+			in->header[i] = GSL_NAN;				//given by the caller
+	}
+	else
+	{
+		struct lai_path_input header;
+		int status = LAIPathInput_Open(&header, fnameHeader);
+		memcpy(in->header, header.header, sizeof(in->header));
+		LAIPathInput_Close(&header);
+		if (status != GSL_SUCCESS)
+			return status;
+	}
+
+	if (MappedFile_Open(&in->file, fname) != 0)
+		return GSL_EFAILED;
+
+	size_t offset = 0;
+	if (LAIPathBinary_IsNpy(fname))
+	{
+		if (Npy_Header(in->file.data, in->file.size, &in->format, &offset, &in->nValues) != GSL_SUCCESS
+			|| offset % in->format != 0 || in->nValues > (in->file.size - offset) / in->format)
+			return GSL_EINVAL;
+	}
+	else
+		in->nValues = in->file.size / in->format;		//a partial value at the end is ignored
+	in->data = in->file.data + offset;
+
+	//chunks of INPUT_CHUNK_BYTES, nothing to scan
+	const size_t perChunk = INPUT_CHUNK_BYTES / in->format;
+	const size_t nChunks = GSL_MAX((in->nValues + perChunk - 1) / perChunk, (size_t)1);
+	in->chunk.resize(nChunks + 1);
+	in->chunkLines.resize(nChunks);
+	for (size_t k = 0; k < nChunks; k++)
+	{
+		in->chunk[k] = in->data + k * perChunk * in->format;
+		in->chunkLines[k] = GSL_MIN(in->nValues - k * perChunk, perChunk);
+	}
+	in->chunk[nChunks] = in->data + in->nValues * in->format;
+	in->scanned = true;
+	return GSL_SUCCESS;
+}
+
+
+template <class T>
+static void Binary_ParseChunk(const T *values, size_t n, bool dropNegative, double *out, struct input_values_info *info)
+{
+	memset(info, 0, sizeof(*info));
+	info->nLines = n;
+	for (size_t k = 0; k < n; k++)
+	{
+		double value = values[k];
+		if (value < INPUT_NEGATIVE)
+		{
+			if (info->nNegative++ == 0 || value < info->minNegative)
+				info->minNegative = value;
+			if (dropNegative)
+				continue;
+		}
+		out[info->nValues++] = value;
+	}
+}
+
+
+//************************************
+// Method:    LAIPathBinary_ParseChunk	Values of chunk k widened to double (LAIPathInput_Values)
+// FullName:  LAIPathBinary_ParseChunk
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: const lai_path_input * in
+// Parameter: size_t k
+// Parameter: bool dropNegative				values < INPUT_NEGATIVE are counted but not returned
+// Parameter: double * out					in->chunkLines[k] (for return)
+// Parameter: input_values_info * info		counts of the chunk (for return)
+//************************************
+void LAIPathBinary_ParseChunk(const struct lai_path_input *in, size_t k, bool dropNegative,
+	double *out, struct input_values_info *info)
+{
+	if (in->format == INPUT_FLOAT32)
+		Binary_ParseChunk(reinterpret_cast<const float *>(in->chunk[k]), in->chunkLines[k], dropNegative, out, info);
+	else
+		Binary_ParseChunk(reinterpret_cast<const double *>(in->chunk[k]), in->chunkLines[k], dropNegative, out, info);
+}
+
+
+//negative path lengths of a chunk, they are counted by PathHist outside the histogram
+template <class T>
+static void Binary_Negatives(const T *values, size_t n, struct input_values_info *info)
+{
+	size_t nNegative = 0;
+	T minValue = 0;
+	for (size_t k = 0; k < n; k++)
+	{
+		nNegative += (values[k] < INPUT_NEGATIVE);
+		minValue = (values[k] < minValue) ? values[k] : minValue;
+	}
+	memset(info, 0, sizeof(*info));
+	info->nLines = n;
+	info->nValues = n - nNegative;
+	info->nNegative = nNegative;
+	info->minNegative = minValue;
+}
+
+
+template <class T>
+static void Binary_Histogram(struct lai_path_input *in, LaiPathPool &pool, gsl_histogram *out_hist,
+	struct input_values_info *info)
+{
+	const size_t nChunks = in->chunkLines.size();
+	std::vector<double> chunkMax(nChunks);
+	std::vector<struct input_values_info> chunkInfo(nChunks);
+	std::vector<struct path_hist_counts> chunkCounts(nChunks);
+
+	// normalize path length to [0,1]: maximum of the maxima of the chunks
+	pool.parallelFor(0, nChunks, 1, [&](size_t k0, size_t k1)
+	{
+		for (size_t k = k0; k < k1; k++)
+		{
+			LAI_PROFILE_SCOPE("binary max chunk");
+			LaiPathCounterScope counter(COUNTER_HISTOGRAM);
+			const T *values = reinterpret_cast<const T *>(in->chunk[k]);
+			chunkMax[k] = PathHist_Max(values, 1, in->chunkLines[k]);
+			Binary_Negatives(values, in->chunkLines[k], &chunkInfo[k]);
+		}
+	});
+	double maxPathLen = chunkMax[0];
+	memset(info, 0, sizeof(*info));
+	for (size_t k = 0; k < nChunks; k++)
+	{
+		maxPathLen = GSL_MAX(maxPathLen, chunkMax[k]);
+		info->minNegative = GSL_MIN(info->minNegative, chunkInfo[k].minNegative);
+		info->nLines += chunkInfo[k].nLines;
+		info->nValues += chunkInfo[k].nValues;
+		info->nNegative += chunkInfo[k].nNegative;
+	}
+
+	// obtain path length distribution in place, counts of the chunks are integers (merged exactly)
+	pool.parallelFor(0, nChunks, 1, [&](size_t k0, size_t k1)
+	{
+		for (size_t k = k0; k < k1; k++)
+		{
+			LAI_PROFILE_SCOPE("binary count chunk");
+			LaiPathCounterScope counter(COUNTER_HISTOGRAM);
+			PathHist_Alloc(&chunkCounts[k], out_hist->n, maxPathLen);
+			PathHist_Count(&chunkCounts[k], reinterpret_cast<const T *>(in->chunk[k]), 1, in->chunkLines[k]);
+		}
+	});
+	for (size_t k = 1; k < nChunks; k++)
+	{
+		PathHist_Merge(&chunkCounts[0], &chunkCounts[k]);
+		PathHist_Free(&chunkCounts[k]);
+	}
+
+	// normalize total probability to 1, negative path lengths are dropped as by the text input
+	chunkCounts[0].ndata -= info->nNegative;
+	PathHist_Histogram(&chunkCounts[0], out_hist);
+	PathHist_Free(&chunkCounts[0]);
+}
+
+
+//************************************
+// Method:    LAIPathBinary_Histogram	Stat_hist of the path lengths, read in place
+// FullName:  LAIPathBinary_Histogram
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: lai_path_input * in
+// Parameter: LaiPathPool & pool				chunks are counted in parallel
+// Parameter: gsl_histogram * out_hist		path length distribution histogram (for return)
+// Parameter: input_values_info * info		path lengths < INPUT_NEGATIVE are dropped (for return)
+//************************************
+void LAIPathBinary_Histogram(struct lai_path_input *in, LaiPathPool &pool, gsl_histogram *out_hist,
+	struct input_values_info *info)
+{
+	if (in->format == INPUT_FLOAT32)
+		Binary_Histogram<float>(in, pool, out_hist, info);
+	else
+		Binary_Histogram<double>(in, pool, out_hist, info);
+}
@@ -0,0 +1,35 @@
+/*!
+* \file LAIPathBinary.h
+* \date
+*			2026/10/17	Binary path lengths (NPY, raw float32 / float64), read in place
+*
+* \brief
+*		Path lengths (mode < 0) or frequencies (mode > 0) as binary arrays, e.g. written by
+*		LiDAR tools, instead of one number per line:
+*			*.npy	NumPy array of '<f4' or '<f8', any shape (all values are used, in any order)
+*			*.f32	little-endian float32 without header
+*			*.f64	little-endian float64 without header
+*
+*		The 5 header lines (gap fraction inside canopy, gap fraction of large gaps, zenith, G,
+*		mode) are read from a sidecar text file in the format of the text input, by default
+*		the data file name with extension ".hdr" (plot.npy: plot.hdr). Without sidecar (fnameHeader
+*		"") the header is NaN and given by the caller, e.g. a manifest row (LAIPathManifest.h).
+*
+*		The file is mapped and the values are used in place: LAIPathBinary_Histogram counts
+*		them without copying (PathHist, float or double). Little-endian hosts only.
+*
+*/
+
+#pragma once
+
+#include "LAIPathInput.h"
+
+#define BINARY_HEADER_EXT	".hdr"		//sidecar header of binary files
+
+int LAIPathBinary_Format(const char *fname);
+bool LAIPathBinary_IsNpy(const char *fname);
+int LAIPathBinary_Open(struct lai_path_input *in, const char *fname, const char *fnameHeader);
+void LAIPathBinary_ParseChunk(const struct lai_path_input *in, size_t k, bool dropNegative,
+	double *out, struct input_values_info *info);
+void LAIPathBinary_Histogram(struct lai_path_input *in, LaiPathPool &pool, gsl_histogram *out_hist,
+	struct input_values_info *info);
@@ -0,0 +1,201 @@
+/*!
+* \file LAIPathCompat.h
+* \date
+*			2026/10/17	Secure CRT functions of MSVC on other compilers (Linux build)
+*			2026/10/17	strncpy_s
+*			2026/10/17	sscanf_s
+*
+* \brief
+*		The sources use the bounds-checked functions of the MSVC CRT (fopen_s, strcpy_s,
+*		strtok_s, _splitpath_s ...). With MSVC this header only includes the CRT headers,
+*		elsewhere it defines them with the MSVC signatures on top of the C / POSIX library:
+*		fopen_s returns errno, strtok_s is strtok_r, gmtime_s takes (struct tm *, const time_t *)
+*		as MSVC (not C11 Annex K), _splitpath_s has no drive.
+*
+*/
+
+#pragma once
+
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#ifndef _MSC_VER
+
+#define _MAX_PATH			260
+#define _MAX_DRIVE			3
+#define _MAX_DIR			256
+#define _MAX_FNAME			256
+#define _MAX_EXT			256
+
+#define _TRUNCATE			((size_t)-1)
+#define STRUNCATE			80
+
+typedef int errno_t;
+
+inline errno_t fopen_s(FILE **f, const char *fname, const char *mode)
+{
+	*f = fopen(fname, mode);
+	return (*f) ? 0 : errno;
+}
+
+
+//dst of size n gets src, "" and ERANGE if too long
+inline errno_t strcpy_s(char *dst, size_t n, const char *src)
+{
+	if (n == 0)
+		return EINVAL;
+	if (strlen(src) >= n)
+	{
+		dst[0] = '\0';
+		return ERANGE;
+	}
+	strcpy(dst, src);
+	return 0;
+}
+
+
+template <size_t N>
+inline errno_t strcpy_s(char (&dst)[N], const char *src)
+{
+	return strcpy_s(dst, N, src);
+}
+
+
+//at most count chars of src and '\0' into dst of size n, ERANGE if they do not fit;
+//count _TRUNCATE: as much of src as fits, STRUNCATE if cut
+inline errno_t strncpy_s(char *dst, size_t n, const char *src, size_t count)
+{
+	if (n == 0)
+		return EINVAL;
+	size_t len = strnlen(src, (count < n) ? count : n);
+	errno_t status = 0;
+	if (len >= n)
+	{
+		if (count != _TRUNCATE)
+		{
+			dst[0] = '\0';
+			return ERANGE;
+		}
+		len = n - 1;
+		status = STRUNCATE;
+	}
+	memcpy(dst, src, len);
+	dst[len] = '\0';
+	return status;
+}
+
+
+template <size_t N>
+inline errno_t strncpy_s(char (&dst)[N], const char *src, size_t count)
+{
+	return strncpy_s(dst, N, src, count);
+}
+
+
+inline errno_t strcat_s(char *dst, size_t n, const char *src)
+{
+	const size_t len = strnlen(dst, n);
+	if (len == n)
+		return EINVAL;
+	return strcpy_s(dst + len, n - len, src);
+}
+
+
+inline char *strtok_s(char *str, const char *delim, char **context)
+{
+	return strtok_r(str, delim, context);
+}
+
+
+//formats without %s, %c, %[ only: those take a buffer size in MSVC
+inline int sscanf_s(const char *str, const char *format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	const int n = vsscanf(str, format, args);
+	va_end(args);
+	return n;
+}
+
+
+inline errno_t gmtime_s(struct tm *t, const time_t *time)
+{
+	return gmtime_r(time, t) ? 0 : EINVAL;
+}
+
+
+//result of the XSI (int) and GNU (char *) strerror_r
+inline const char *LAIPath_StrerrorR(int status, char *buf) { return (status == 0) ? buf : "Unknown error"; }
+inline const char *LAIPath_StrerrorR(const char *msg, char *) { return msg; }
+
+inline errno_t strerror_s(char *buf, size_t n, int errnum)
+{
+	const char *msg = LAIPath_StrerrorR(strerror_r(errnum, buf, n), buf);
+	return (msg == buf) ? 0 : strcpy_s(buf, n, msg);
+}
+
+
+template <size_t N>
+inline errno_t strerror_s(char (&buf)[N], int errnum)
+{
+	return strerror_s(buf, N, errnum);
+}
+
+
+//directory with its last '/' (or '\'), name and extension with its '.', no drive
+inline errno_t _splitpath_s(const char *path, char *drive, size_t nDrive, char *dir, size_t nDir,
+	char *fname, size_t nFname, char *ext, size_t nExt)
+{
+	const char *name = path;
+	for (const char *c = path; *c; c++)
+		if (*c == '/' || *c == '\\')
+			name = c + 1;
+	const char *dot = strrchr(name, '.');
+	if (dot == 0)
+		dot = name + strlen(name);
+
+	if ((size_t)(name - path) >= nDir || (size_t)(dot - name) >= nFname || strlen(dot) >= nExt || nDrive == 0)
+		return ERANGE;
+	drive[0] = '\0';
+	memcpy(dir, path, name - path);
+	dir[name - path] = '\0';
+	memcpy(fname, name, dot - name);
+	fname[dot - name] = '\0';
+	strcpy(ext, dot);
+	return 0;
+}
+
+
+template <size_t A, size_t B, size_t C, size_t D>
+inline errno_t _splitpath_s(const char *path, char (&drive)[A], char (&dir)[B], char (&fname)[C], char (&ext)[D])
+{
+	return _splitpath_s(path, drive, A, dir, B, fname, C, ext, D);
+}
+
+
+//drive + dir + '/' (if missing) + fname + '.' (if missing) + ext
+inline errno_t _makepath_s(char *path, size_t n, const char *drive, const char *dir, const char *fname, const char *ext)
+{
+	const size_t nDir = (dir) ? strlen(dir) : 0;
+	const int len = snprintf(path, n, "%s%s%s%s%s%s", (drive) ? drive : "", (dir) ? dir : "",
+		(nDir && dir[nDir - 1] != '/' && dir[nDir - 1] != '\\') ? "/" : "", (fname) ? fname : "",
+		(ext && ext[0] && ext[0] != '.') ? "." : "", (ext) ? ext : "");
+	if (len < 0 || (size_t)len >= n)
+	{
+		if (n) path[0] = '\0';
+		return ERANGE;
+	}
+	return 0;
+}
+
+
+template <size_t N>
+inline errno_t _makepath_s(char (&path)[N], const char *drive, const char *dir, const char *fname, const char *ext)
+{
+	return _makepath_s(path, N, drive, dir, fname, ext);
+}
+
+#endif
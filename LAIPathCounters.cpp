@@ -0,0 +1,267 @@
+/*!
+* \file LAIPathCounters.cpp
+* \date
+*			2026/10/17	Hardware performance counters around the phases of LAI_PATH (Linux perf_event_open)
+*
+*/
+
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "LAIPathCounters.h"
+#include "LAIPathCompat.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+std::atomic<bool> g_laiPathCounters(false);
+
+static const char *const counter_phases[COUNTER_PHASES] = { "input parse", "histogram", "LAImax root", "integral" };
+
+//counter group of one thread, written by its thread only
+struct counter_thread
+{
+	bool open;									//group leader (cycles) opened
+	int error;									//errno of the group leader
+	char message[96];							//its strerror_s, reason of LAIPathCounters_Enable
+	int fd[COUNTER_EVENTS];						//-1: not counted
+	int slot[COUNTER_EVENTS];					//position in the group read, -1: not counted
+	uint64_t calls[COUNTER_PHASES];
+	double sum[COUNTER_PHASES][COUNTER_EVENTS];	//scaled by time enabled / running
+};
+
+static std::mutex g_countersLock;
+static std::vector<std::unique_ptr<struct counter_thread> > g_counterThreads;
+static int g_counted[COUNTER_EVENTS];			//threads counting each event
+
+
+#ifdef __linux__
+
+static int Counters_Open(uint32_t type, uint64_t config, int group)
+{
+	struct perf_event_attr attr;
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = type;
+	attr.config = config;
+	attr.exclude_kernel = 1;		//allowed with perf_event_paranoid 2
+	attr.exclude_hv = 1;
+	attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+	return (int)syscall(__NR_perf_event_open, &attr, 0, -1, group, 0);		//calling thread, any CPU
+}
+
+
+//group of the calling thread, cycles lead (required), the other events if the CPU counts them
+static void Counters_OpenThread(struct counter_thread *t)
+{
+	static const uint32_t types[COUNTER_EVENTS] = { PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+		PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE };
+	static const uint64_t configs[COUNTER_EVENTS] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_BRANCH_MISSES,
+		PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+		PERF_COUNT_HW_CACHE_MISSES };
+
+	int nSlots = 0;
+	for (int e = 0; e < COUNTER_EVENTS; e++)
+	{
+		t->fd[e] = Counters_Open(types[e], configs[e], e ? t->fd[COUNTER_CYCLES] : -1);
+		t->slot[e] = (t->fd[e] >= 0) ? nSlots++ : -1;
+		if (e == COUNTER_CYCLES && t->fd[e] < 0)
+		{
+			t->error = errno;
+			return;
+		}
+	}
+	t->open = true;
+}
+
+
+static void Counters_CloseThread(struct counter_thread *t)
+{
+	for (int e = COUNTER_EVENTS - 1; e >= 0; e--)
+		if (t->fd[e] >= 0)
+			close(t->fd[e]);
+}
+
+#else
+
+static void Counters_OpenThread(struct counter_thread *t)
+{
+	t->error = ENOSYS;
+}
+
+
+static void Counters_CloseThread(struct counter_thread *t)
+{
+}
+
+#endif
+
+
+//the counter group of the calling thread, registered for the report
+static struct counter_thread *Counters_Thread()
+{
+	//closes the group at thread exit, the sums stay registered
+	struct counter_owner
+	{
+		struct counter_thread *t;
+		~counter_owner() { if (t) Counters_CloseThread(t); }
+	};
+	static thread_local struct counter_owner t_counters = { 0 };
+
+	if (t_counters.t == 0)
+	{
+		std::unique_ptr<struct counter_thread> t(new counter_thread);
+		memset(t.get(), 0, sizeof(struct counter_thread));
+		for (int e = 0; e < COUNTER_EVENTS; e++)
+			t->fd[e] = t->slot[e] = -1;
+		Counters_OpenThread(t.get());
+
+		std::lock_guard<std::mutex> guard(g_countersLock);
+		for (int e = 0; e < COUNTER_EVENTS; e++)
+			g_counted[e] += (t->slot[e] >= 0);
+		t_counters.t = t.get();
+		g_counterThreads.push_back(std::move(t));
+	}
+	return t_counters.t;
+}
+
+
+//************************************
+// Method:    LAIPathCounters_Enable	Open the counters of the calling thread, count the phases of all threads
+// FullName:  LAIPathCounters_Enable
+// Access:    public
+// Returns:   bool					false: counters unavailable, the phases are not counted
+// Qualifier:
+// Parameter: const char * * reason	(for return) why not, 0: not needed
+//************************************
+bool LAIPathCounters_Enable(const char **reason)
+{
+	struct counter_thread *t = Counters_Thread();
+	if (!t->open)
+	{
+		if (reason)
+		{
+			strerror_s(t->message, sizeof(t->message), t->error);
+			*reason = (t->error == ENOSYS) ? "perf_event_open is not available on this system"
+				: (t->error == EACCES || t->error == EPERM) ? "perf_event_open not permitted (perf_event_paranoid, container without CAP_PERFMON)"
+				: (t->error == ENOENT || t->error == EOPNOTSUPP) ? "no hardware counters (virtual machine?)"
+				: t->message;
+		}
+		return false;
+	}
+	g_laiPathCounters = true;
+	return true;
+}
+
+
+//************************************
+// Method:    LAIPathCounters_Read	Current counter values of the calling thread
+// FullName:  LAIPathCounters_Read
+// Access:    public
+// Returns:   bool					false: no counters on this thread
+// Qualifier:
+// Parameter: counter_values * v	(for return) not counted events: 0
+//************************************
+bool LAIPathCounters_Read(struct counter_values *v)
+{
+	struct counter_thread *t = Counters_Thread();
+	if (!t->open)
+		return false;
+#ifdef __linux__
+	uint64_t buffer[3 + COUNTER_EVENTS];
+	if (read(t->fd[COUNTER_CYCLES], buffer, sizeof(buffer)) < (ssize_t)(3 * sizeof(uint64_t)))
+		return false;
+	v->enabled = buffer[1];
+	v->running = buffer[2];
+	for (int e = 0; e < COUNTER_EVENTS; e++)
+		v->value[e] = (t->slot[e] >= 0 && (uint64_t)t->slot[e] < buffer[0]) ? buffer[3 + t->slot[e]] : 0;
+	return true;
+#else
+	return false;
+#endif
+}
+
+
+//************************************
+// Method:    LAIPathCounters_Add	Count a phase of the calling thread (LaiPathCounterScope)
+// FullName:  LAIPathCounters_Add
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: int phase					COUNTER_PARSE ... COUNTER_INTEGRAL
+// Parameter: const counter_values * begin
+// Parameter: const counter_values * end
+//************************************
+void LAIPathCounters_Add(int phase, const struct counter_values *begin, const struct counter_values *end)
+{
+	struct counter_thread *t = Counters_Thread();
+	const uint64_t enabled = end->enabled - begin->enabled, running = end->running - begin->running;
+	const double scale = (running > 0 && running < enabled) ? (double)enabled / running : 1.0;
+	t->calls[phase]++;
+	for (int e = 0; e < COUNTER_EVENTS; e++)
+		t->sum[phase][e] += (double)(end->value[e] - begin->value[e]) * scale;
+}
+
+
+//************************************
+// Method:    LAIPathCounters_Report	Counters of the phases over all threads, per plot
+// FullName:  LAIPathCounters_Report
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: FILE * out
+// Parameter: size_t nPlots			plots of the run (1: one input file)
+//************************************
+void LAIPathCounters_Report(FILE *out, size_t nPlots)
+{
+	if (!g_laiPathCounters)
+		return;
+
+	std::lock_guard<std::mutex> guard(g_countersLock);
+	uint64_t calls[COUNTER_PHASES] = { 0 };
+	double sum[COUNTER_PHASES][COUNTER_EVENTS] = { { 0 } };
+	size_t nOpen = 0;
+	for (size_t i = 0; i < g_counterThreads.size(); i++)
+	{
+		const struct counter_thread *t = g_counterThreads[i].get();
+		nOpen += t->open;
+		for (int p = 0; p < COUNTER_PHASES; p++)
+		{
+			calls[p] += t->calls[p];
+			for (int e = 0; e < COUNTER_EVENTS; e++)
+				sum[p][e] += t->sum[p][e];
+		}
+	}
+
+	const double perPlot = 1.0 / (nPlots ? nPlots : 1);
+	fprintf(out, "%-14s %10s %14s %14s %6s %14s %14s %14s\n", "counters/plot", "calls",
+		"cycles", "instructions", "IPC", "branch misses", "L1D misses", "LLC misses");
+	for (int p = 0; p < COUNTER_PHASES; p++)
+	{
+		if (calls[p] == 0)
+			continue;
+		fprintf(out, "%-14s %10llu", counter_phases[p], (unsigned long long)calls[p]);
+		for (int e = 0; e < COUNTER_EVENTS; e++)
+		{
+			if (e == COUNTER_BRANCH_MISSES)
+			{
+				if (g_counted[COUNTER_INSTRUCTIONS] && sum[p][COUNTER_CYCLES] > 0)
+					fprintf(out, " %6.2f", sum[p][COUNTER_INSTRUCTIONS] / sum[p][COUNTER_CYCLES]);
+				else
+					fprintf(out, " %6s", "n/a");
+			}
+			if (g_counted[e])
+				fprintf(out, " %14.0f", sum[p][e] * perPlot);
+			else
+				fprintf(out, " %14s", "n/a");
+		}
+		fprintf(out, "\n");
+	}
+	fprintf(out, "%zu of %zu threads counted, user space only\n", nOpen, g_counterThreads.size());
+}
@@ -0,0 +1,85 @@
+/*!
+* \file LAIPathCounters.h
+* \date
+*			2026/10/17	Hardware performance counters around the phases of LAI_PATH (Linux perf_event_open)
+*
+* \brief
+*		Why a phase is slow: cycles, instructions (IPC), branch misses, L1D read misses and
+*		last level cache misses of the calling thread (user space) around
+*			COUNTER_PARSE		data lines of the input files
+*			COUNTER_HISTOGRAM	path length histograms (Stat_hist_View, histogram subtasks)
+*			COUNTER_ROOT		LAImax root (Halley, Brent), includes its Eq(13) evaluations
+*			COUNTER_INTEGRAL	mean path length int lr*P(lr)
+*		Off until LAIPathCounters_Enable; then every thread opens its own counter group on its
+*		first phase, and a phase costs two read() calls (~1-2 us, mind it for small plots).
+*		Counters multiplexed with other users are scaled by time enabled / running.
+*
+*		Counters may be unavailable (not Linux, perf_event_paranoid, containers without
+*		CAP_PERFMON, virtual machines): LAIPathCounters_Enable returns false with the reason,
+*		events the CPU does not count are reported as n/a, the results are not affected.
+*
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdio>
+#include <stdint.h>
+
+#define COUNTER_PARSE		0
+#define COUNTER_HISTOGRAM	1
+#define COUNTER_ROOT		2
+#define COUNTER_INTEGRAL	3
+#define COUNTER_PHASES		4
+
+#define COUNTER_CYCLES			0
+#define COUNTER_INSTRUCTIONS	1
+#define COUNTER_BRANCH_MISSES	2
+#define COUNTER_L1D_MISSES		3
+#define COUNTER_LLC_MISSES		4
+#define COUNTER_EVENTS			5
+
+extern std::atomic<bool> g_laiPathCounters;		//LAIPathCounters_Enable succeeded
+
+bool LAIPathCounters_Enable(const char **reason = 0);
+void LAIPathCounters_Report(FILE *out, size_t nPlots);
+
+//group values of the calling thread: time enabled, time running, COUNTER_EVENTS values
+struct counter_values
+{
+	uint64_t enabled;
+	uint64_t running;
+	uint64_t value[COUNTER_EVENTS];
+};
+
+bool LAIPathCounters_Read(struct counter_values *v);
+void LAIPathCounters_Add(int phase, const struct counter_values *begin, const struct counter_values *end);
+
+//counts its lifetime (or until Stop) as phase, if enabled
+class LaiPathCounterScope
+{
+public:
+	explicit LaiPathCounterScope(int phase) : m_phase(phase), m_on(false)
+	{
+		if (g_laiPathCounters.load(std::memory_order_relaxed))
+			m_on = LAIPathCounters_Read(&m_begin);
+	}
+	~LaiPathCounterScope() { Stop(); }
+
+	//ends the phase before the end of the scope
+	void Stop()
+	{
+		struct counter_values end;
+		if (m_on && LAIPathCounters_Read(&end))
+			LAIPathCounters_Add(m_phase, &m_begin, &end);
+		m_on = false;
+	}
+
+private:
+	LaiPathCounterScope(const LaiPathCounterScope &);
+	LaiPathCounterScope &operator=(const LaiPathCounterScope &);
+
+	int m_phase;
+	bool m_on;
+	struct counter_values m_begin;
+};
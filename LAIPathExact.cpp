@@ -0,0 +1,264 @@
+/*!
+* \file LAIPathExact.cpp
+* \date
+*			2026/10/17	Exact-sample (binless) mode: Eq(13) over the path lengths themselves, AVX2 / AVX-512 exp
+*
+*/
+
+#include <cstring>
+
+#include "LAIPathExact.h"
+#include "LAIPathBatchSimd.h"
+#include "PathHist.h"
+#include "LAIPathProfile.h"
+#include "LAIPathCounters.h"
+
+struct params_Exact
+{
+	const struct path_samples *s;
+	double threshold;			//samples below are large gaps (zero-path fix), 0: none
+	double gapF;				//measured gap fraction * mass
+	LaiPathPool *pool;
+};
+
+
+//exp(x) in float, the operations of Exact_Sums_Avx2 / Exact_Sums_Avx512 lane by lane
+static inline float Exact_Expf(float x)
+{
+	x = (x > EXACT_EXP_MIN) ? x : EXACT_EXP_MIN;
+	float v = x * EXACT_LOG2E + 0.5f;
+	int n = (int)v;
+	n -= (n > v);						//floor without libm call (no roundss before SSE4.1)
+	float fx = (float)n;
+	float r = x - fx * EXACT_LN2_HI;
+	r = r - fx * EXACT_LN2_LO;
+	float p = EXACT_P0;
+	p = p * r + EXACT_P1;
+	p = p * r + EXACT_P2;
+	p = p * r + EXACT_P3;
+	p = p * r + EXACT_P4;
+	p = p * r + EXACT_P5;
+	float y = p * (r * r);
+	y = y + r;
+	y = y + 1.0f;
+
+	//2^fx, fx in [-126, 0]
+	uint32_t bits = (uint32_t)(n + 127) << 23;
+	float scale;
+	memcpy(&scale, &bits, sizeof(scale));
+	return y * scale;
+}
+
+
+//lanes of samples l[k], k < n, from lane k % EXACT_LANES
+static void Exact_Sums_Scalar(const float *l, size_t n, float L, float threshold, double sums[3][EXACT_LANES])
+{
+	for (size_t k = 0; k < n; k++)
+	{
+		const size_t lane = k % EXACT_LANES;
+		const float e = (l[k] >= threshold) ? Exact_Expf(-(L * l[k])) : 0.0f;
+		const double ed = e, ld = l[k];
+		const double el = ed * ld;
+		sums[0][lane] += ed;
+		sums[1][lane] += el;
+		sums[2][lane] += el * ld;
+	}
+}
+
+
+//sums of one block, lanes added in order
+static void Exact_Block(const float *l, size_t n, float L, float threshold, int isa, double out[3])
+{
+	double sums[3][EXACT_LANES];
+	memset(sums, 0, sizeof(sums));
+	const size_t nVector = (isa == BATCH_ISA_SCALAR) ? 0 : n - n % EXACT_LANES;
+	if (nVector && isa == BATCH_ISA_AVX512)
+		Exact_Sums_Avx512(l, nVector, L, threshold, sums);
+	else if (nVector && isa == BATCH_ISA_AVX2)
+		Exact_Sums_Avx2(l, nVector, L, threshold, sums);
+	Exact_Sums_Scalar(l + nVector, n - nVector, L, threshold, sums);
+
+	for (int i = 0; i < 3; i++)
+	{
+		out[i] = 0;
+		for (int j = 0; j < EXACT_LANES; j++)
+			out[i] += sums[i][j];
+	}
+}
+
+
+//normalized copy of the path lengths >= 0 (negative and NaN ones are dropped)
+template <class T>
+static int Exact_Normalize(const T *data, size_t ndata, struct path_samples *s, int isa)
+{
+	int supported = Batch_SupportedIsa();
+	s->isa = (isa == BATCH_ISA_AUTO || isa > supported) ? supported : isa;
+	s->l.clear();
+	s->maxPathLen = PathHist_Max(data, 1, ndata, isa);
+	if (!(s->maxPathLen > 0 && gsl_finite(s->maxPathLen)))
+		return GSL_EDOM;
+
+	s->l.reserve(ndata);
+	for (size_t i = 0; i < ndata; i++)
+		if (data[i] >= 0)
+			s->l.push_back((float)(data[i] / s->maxPathLen));
+	return GSL_SUCCESS;
+}
+
+
+//************************************
+// Method:    Exact_Samples		Relative path lengths of the exact mode
+// FullName:  Exact_Samples
+// Access:    public
+// Returns:   int					GSL_SUCCESS, GSL_EDOM (maximum not positive and finite: no samples)
+// Qualifier:
+// Parameter: const double * data	path lengths (any unit), < 0 and NaN are ignored
+// Parameter: size_t ndata
+// Parameter: path_samples * s		(for return)
+// Parameter: int isa				kernel of the sums, BATCH_ISA_AUTO: best supported
+//************************************
+int Exact_Samples(const double *data, size_t ndata, struct path_samples *s, int isa)
+{
+	return Exact_Normalize(data, ndata, s, isa);
+}
+
+
+int Exact_Samples(const float *data, size_t ndata, struct path_samples *s, int isa)
+{
+	return Exact_Normalize(data, ndata, s, isa);
+}
+
+
+//************************************
+// Method:    Exact_GapFraction_fdf	Simulated gap fraction of the samples and its derivatives in LAImax
+// FullName:  Exact_GapFraction_fdf
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: const path_samples * s
+// Parameter: double threshold		samples below are not summed (large gaps), 0: all
+// Parameter: double LAImax			0: g is the fraction of samples summed, -dg their mean relative path length times g
+// Parameter: double * g			1/n sum exp(-LAImax * l_j)
+// Parameter: double * dg			-1/n sum l_j * exp(-LAImax * l_j)
+// Parameter: double * d2g			1/n sum l_j^2 * exp(-LAImax * l_j)
+// Parameter: LaiPathPool * pool	blocks summed in parallel from EXACT_PARALLEL samples, 0: calling thread
+//************************************
+void Exact_GapFraction_fdf(const struct path_samples *s, double threshold, double LAImax, double *g, double *dg, double *d2g,
+	LaiPathPool *pool)
+{
+	const size_t n = s->l.size();
+	const size_t nBlocks = (n + EXACT_BLOCK - 1) / EXACT_BLOCK;
+	if (n == 0)
+	{
+		*g = *dg = *d2g = 0;
+		return;
+	}
+
+	std::vector<double> blocks(3 * nBlocks);
+	const float L = (float)LAImax, t = (float)threshold;
+	auto body = [&](size_t b0, size_t b1)
+	{
+		for (size_t b = b0; b < b1; b++)
+			Exact_Block(s->l.data() + b * EXACT_BLOCK, GSL_MIN(n - b * EXACT_BLOCK, (size_t)EXACT_BLOCK), L, t, s->isa, &blocks[3 * b]);
+	};
+	if (pool && n >= EXACT_PARALLEL)
+		pool->parallelFor(0, nBlocks, 1, body);
+	else
+		body(0, nBlocks);
+
+	double sum[3] = { 0, 0, 0 };
+	for (size_t b = 0; b < nBlocks; b++)
+		for (int i = 0; i < 3; i++)
+			sum[i] += blocks[3 * b + i];
+	*g = sum[0] / n;
+	*dg = -sum[1] / n;
+	*d2g = sum[2] / n;
+}
+
+
+//cost function of Solve_LAImax: simulated - measured gap fraction, and its derivatives
+static void Exact_GapBias_fdf(double LAImax, void *params, double *f, double *df, double *d2f)
+{
+	struct params_Exact *_params = (struct params_Exact *)params;
+	Exact_GapFraction_fdf(_params->s, _params->threshold, LAImax, f, df, d2f, _params->pool);
+	*f -= _params->gapF;
+}
+
+
+//LAImax and mean path length of the samples >= threshold, returns their fraction (mass)
+static double Exact_LAImax(struct params_Exact *params, double gapFraction, struct solver_info *info)
+{
+	double mass, weightedPath, d2g;
+	{
+		LAI_PROFILE_SCOPE("weighted path exact");
+		LaiPathCounterScope counter(COUNTER_INTEGRAL);
+		Exact_GapFraction_fdf(params->s, params->threshold, 0, &mass, &weightedPath, &d2g, params->pool);
+	}
+	if (!(mass > 0))
+	{
+		info->status = GSL_EINVAL;
+		return 0;
+	}
+	info->meanPath = -weightedPath / mass;
+	params->gapF = gapFraction * mass;
+
+	//Halley iterations started from the lower bound effLAI / mean path length, as LAI_PATH
+	LAI_PROFILE_SCOPE("LAImax exact");
+	LaiPathCounterScope rootCounter(COUNTER_ROOT);
+	double effLAI = -log(gapFraction);
+	double x_lo = effLAI, x_hi = effLAI * LAI_PATH_BRACKET;
+	Solve_LAImax(&Exact_GapBias_fdf, params, x_lo, x_hi, GSL_MAX(x_lo, effLAI / info->meanPath),
+		LAI_PATH_Tolerance().epsabs, 100, info);
+	return mass;
+}
+
+
+//************************************
+// Method:    LAI_PATH_Exact		LAI_PATH over the path length samples instead of their histogram
+// FullName:  LAI_PATH_Exact
+// Access:    public
+// Returns:   double					True LAI, LAI_MAX without root
+// Qualifier:
+// Parameter: const path_samples * s	relative path lengths (Exact_Samples)
+// Parameter: double gapFraction		Total gap fraction
+// Parameter: double zenith				Zenith angle (degree) of data
+// Parameter: double G					Leaf projection function G
+// Parameter: solver_info * info		Iterations, evaluations and status of the LAImax solve (optional), as LAI_PATH
+// Parameter: LaiPathPool * pool		threads of large samples, 0: calling thread
+//************************************
+double LAI_PATH_Exact(const struct path_samples *s, double gapFraction, double zenith, double G,
+	struct solver_info *info, LaiPathPool *pool)
+{
+	LAI_PROFILE_SCOPE("LAI_PATH exact");
+	struct solver_info _info = {};			//GSL_SUCCESS (0), no work
+	struct params_Exact params = { s, 0, 0, pool };
+
+	double mass = Exact_LAImax(&params, gapFraction, &_info);
+	_info.nBracketFail = (_info.status == GSL_EINVAL);
+
+	//as LAI_PATH: without root, path lengths of the first bin of Stat_hist are large gaps
+	if (_info.status == GSL_EINVAL && mass > 0)
+	{
+		int iter = _info.iter, nEval = _info.nEval;
+		params.threshold = PATH_HIST_TOP / NUM_BINS;
+		mass = Exact_LAImax(&params, gapFraction, &_info);
+		_info.zeroPath = 1 - mass;
+		_info.iter += iter;
+		_info.nEval += nEval;
+		_info.nBracketFail += (_info.status == GSL_EINVAL);
+		if (_info.status != GSL_EINVAL)
+			_info.status = (_info.status == GSL_SUCCESS) ? LAI_PATH_ZERO_PATH : _info.status;
+	}
+
+	if (_info.status == GSL_EINVAL)
+	{
+		_info.LAImax = LAI_MAX;
+		_info.fallback = 1;
+		if (info) *info = _info;
+		return LAI_MAX;
+	}
+	if (info) *info = _info;
+
+	//Return true LAI, path lengths close to 0 are gaps
+	return _info.LAImax * _info.meanPath * mass / G * cos(zenith*M_PI / 180);
+}
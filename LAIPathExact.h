@@ -0,0 +1,65 @@
+/*!
+* \file LAIPathExact.h
+* \date
+*			2026/10/17	Exact-sample (binless) mode: Eq(13) over the path lengths themselves, AVX2 / AVX-512 exp
+*
+* \brief
+*		Instead of a histogram of NUM_BINS bins, the distribution of the relative path lengths
+*		is the empirical distribution of the samples l_j = path length / maximum (n floats):
+*			simulated gap fraction	g(LAImax) = 1/n sum_j exp(-LAImax * l_j)
+*			mean path length		1/n sum_j l_j
+*		LAImax is solved by Solve_LAImax with the derivatives of g (weights -l_j and l_j^2), with
+*		the bracket, tolerance and zero-path fix of LAI_PATH: without root, the path lengths
+*		of the first bin of Stat_hist (l_j < PATH_HIST_TOP / NUM_BINS) are taken as large gaps.
+*
+*		exp is evaluated in float (Cephes polynomial, relative error < 2e-7), the products and
+*		sums in double. Sample k of a block of EXACT_BLOCK is summed in lane k % EXACT_LANES,
+*		lanes and blocks are added in order: scalar, AVX2 and AVX-512 kernels give identical
+*		results, with any number of threads. From EXACT_PARALLEL samples the blocks are summed
+*		by LaiPathPool.
+*
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "LAIPath.h"
+#include "LAIPathBatch.h"
+#include "LaiPathPool.h"
+
+#define EXACT_LANES			16			//partial sums per block, multiple of the vector widths
+#define EXACT_BLOCK			(1 << 14)	//samples per block
+#define EXACT_PARALLEL		(1 << 17)	//samples from which the blocks are summed in parallel
+#define EXACT_EXP_MIN		-87.0f		//exp(x) of smaller x is taken at x = EXACT_EXP_MIN (2^-126 normal)
+
+//relative path lengths of the exact mode
+struct path_samples
+{
+	std::vector<float> l;		//path lengths / maxPathLen, in [0, 1]
+	double maxPathLen;
+	int isa;					//kernel of the sums, BATCH_ISA_AUTO: best supported
+};
+
+//constants of exp in float (Cephes expf), shared by the scalar and SIMD kernels
+#define EXACT_LOG2E			1.44269504088896341f
+#define EXACT_LN2_HI		0.693359375f
+#define EXACT_LN2_LO		-2.12194440e-4f
+#define EXACT_P0			1.9875691500e-4f
+#define EXACT_P1			1.3981999507e-3f
+#define EXACT_P2			8.3334519073e-3f
+#define EXACT_P3			4.1665795894e-2f
+#define EXACT_P4			1.6666665459e-1f
+#define EXACT_P5			5.0000001201e-1f
+
+int Exact_Samples(const double *data, size_t ndata, struct path_samples *s, int isa = BATCH_ISA_AUTO);
+int Exact_Samples(const float *data, size_t ndata, struct path_samples *s, int isa = BATCH_ISA_AUTO);
+void Exact_GapFraction_fdf(const struct path_samples *s, double threshold, double LAImax, double *g, double *dg, double *d2g,
+	LaiPathPool *pool = 0);
+double LAI_PATH_Exact(const struct path_samples *s, double gapFraction, double zenith = 0, double G = 0.5,
+	struct solver_info *info = 0, LaiPathPool *pool = 0);
+
+//kernels of LAIPathExactSimd.cpp: sums[0..2][k % EXACT_LANES] += e, e*l, e*l*l of e = exp(-L*l[k]), l[k] >= threshold;
+//n multiple of EXACT_LANES
+void Exact_Sums_Avx2(const float *l, size_t n, float L, float threshold, double sums[3][EXACT_LANES]);
+void Exact_Sums_Avx512(const float *l, size_t n, float L, float threshold, double sums[3][EXACT_LANES]);
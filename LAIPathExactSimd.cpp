@@ -0,0 +1,158 @@
+/*!
+* \file LAIPathExactSimd.cpp
+* \date
+*			2026/10/17	AVX2 / AVX-512 sums of the exact-sample mode
+*
+* \brief
+*		Same operations as Exact_Sums_Scalar of LAIPathExact.cpp: exp(-L*l) in float by the
+*		Cephes polynomial (floor, two-part ln2, 2^n from the exponent bits), masked by
+*		l >= threshold, then e, e*l and e*l*l added in double to lane k % EXACT_LANES.
+*		16 samples per iteration: AVX2 in 4 x 4 double lanes, AVX-512 in 2 x 8. FMA is not
+*		used, results equal the scalar kernel.
+*
+*/
+
+#include "LAIPathExact.h"
+#include "LAIPathBatchSimd.h"
+
+#ifdef BATCH_X86
+
+//exp(x) of 8 floats, x >= EXACT_EXP_MIN after the clamp
+BATCH_TARGET_AVX2 static inline __m256 Exact_Exp_Avx2(__m256 x)
+{
+	x = _mm256_max_ps(x, _mm256_set1_ps(EXACT_EXP_MIN));
+	__m256 fx = _mm256_floor_ps(_mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(EXACT_LOG2E)), _mm256_set1_ps(0.5f)));
+	__m256 r = _mm256_sub_ps(x, _mm256_mul_ps(fx, _mm256_set1_ps(EXACT_LN2_HI)));
+	r = _mm256_sub_ps(r, _mm256_mul_ps(fx, _mm256_set1_ps(EXACT_LN2_LO)));
+	__m256 p = _mm256_set1_ps(EXACT_P0);
+	p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(EXACT_P1));
+	p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(EXACT_P2));
+	p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(EXACT_P3));
+	p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(EXACT_P4));
+	p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(EXACT_P5));
+	__m256 y = _mm256_mul_ps(p, _mm256_mul_ps(r, r));
+	y = _mm256_add_ps(y, r);
+	y = _mm256_add_ps(y, _mm256_set1_ps(1.0f));
+
+	__m256i bits = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvttps_epi32(fx), _mm256_set1_epi32(127)), 23);
+	return _mm256_mul_ps(y, _mm256_castsi256_ps(bits));
+}
+
+
+//************************************
+// Method:    Exact_Sums_Avx2	Sums of the exact mode, 16 samples per iteration
+// FullName:  Exact_Sums_Avx2
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: const float * l		relative path lengths
+// Parameter: size_t n				multiple of EXACT_LANES
+// Parameter: float L				LAImax
+// Parameter: float threshold		samples below are not summed
+// Parameter: double sums[3][EXACT_LANES]	e, e*l, e*l*l by lane (added to)
+//************************************
+BATCH_TARGET_AVX2 void Exact_Sums_Avx2(const float *l, size_t n, float L, float threshold, double sums[3][EXACT_LANES])
+{
+	const __m256 Lv = _mm256_set1_ps(L), t = _mm256_set1_ps(threshold), sign = _mm256_set1_ps(-0.0f);
+	__m256d s[3][4];
+	for (int i = 0; i < 3; i++)
+		for (int j = 0; j < 4; j++)
+			s[i][j] = _mm256_loadu_pd(&sums[i][4 * j]);
+
+	for (size_t k = 0; k < n; k += EXACT_LANES)
+		for (int h = 0; h < 2; h++)
+		{
+			__m256 lf = _mm256_loadu_ps(l + k + 8 * h);
+			__m256 e = Exact_Exp_Avx2(_mm256_xor_ps(_mm256_mul_ps(Lv, lf), sign));
+			e = _mm256_and_ps(e, _mm256_cmp_ps(lf, t, _CMP_GE_OQ));
+			for (int q = 0; q < 2; q++)
+			{
+				__m256d ed = _mm256_cvtps_pd(q ? _mm256_extractf128_ps(e, 1) : _mm256_castps256_ps128(e));
+				__m256d ld = _mm256_cvtps_pd(q ? _mm256_extractf128_ps(lf, 1) : _mm256_castps256_ps128(lf));
+				__m256d el = _mm256_mul_pd(ed, ld);
+				const int j = 2 * h + q;
+				s[0][j] = _mm256_add_pd(s[0][j], ed);
+				s[1][j] = _mm256_add_pd(s[1][j], el);
+				s[2][j] = _mm256_add_pd(s[2][j], _mm256_mul_pd(el, ld));
+			}
+		}
+
+	for (int i = 0; i < 3; i++)
+		for (int j = 0; j < 4; j++)
+			_mm256_storeu_pd(&sums[i][4 * j], s[i][j]);
+}
+
+
+//exp(x) of 16 floats, as Exact_Exp_Avx2
+BATCH_TARGET_AVX512 static inline __m512 Exact_Exp_Avx512(__m512 x)
+{
+	x = _mm512_max_ps(x, _mm512_set1_ps(EXACT_EXP_MIN));
+	__m512 fx = _mm512_roundscale_ps(_mm512_add_ps(_mm512_mul_ps(x, _mm512_set1_ps(EXACT_LOG2E)), _mm512_set1_ps(0.5f)),
+		_MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+	__m512 r = _mm512_sub_ps(x, _mm512_mul_ps(fx, _mm512_set1_ps(EXACT_LN2_HI)));
+	r = _mm512_sub_ps(r, _mm512_mul_ps(fx, _mm512_set1_ps(EXACT_LN2_LO)));
+	__m512 p = _mm512_set1_ps(EXACT_P0);
+	p = _mm512_add_ps(_mm512_mul_ps(p, r), _mm512_set1_ps(EXACT_P1));
+	p = _mm512_add_ps(_mm512_mul_ps(p, r), _mm512_set1_ps(EXACT_P2));
+	p = _mm512_add_ps(_mm512_mul_ps(p, r), _mm512_set1_ps(EXACT_P3));
+	p = _mm512_add_ps(_mm512_mul_ps(p, r), _mm512_set1_ps(EXACT_P4));
+	p = _mm512_add_ps(_mm512_mul_ps(p, r), _mm512_set1_ps(EXACT_P5));
+	__m512 y = _mm512_mul_ps(p, _mm512_mul_ps(r, r));
+	y = _mm512_add_ps(y, r);
+	y = _mm512_add_ps(y, _mm512_set1_ps(1.0f));
+
+	__m512i bits = _mm512_slli_epi32(_mm512_add_epi32(_mm512_cvttps_epi32(fx), _mm512_set1_epi32(127)), 23);
+	return _mm512_mul_ps(y, _mm512_castsi512_ps(bits));
+}
+
+
+//************************************
+// Method:    Exact_Sums_Avx512	Sums of the exact mode, 16 samples per iteration
+// FullName:  Exact_Sums_Avx512
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: const float * l		relative path lengths
+// Parameter: size_t n				multiple of EXACT_LANES
+// Parameter: float L				LAImax
+// Parameter: float threshold		samples below are not summed
+// Parameter: double sums[3][EXACT_LANES]	e, e*l, e*l*l by lane (added to)
+//************************************
+BATCH_TARGET_AVX512 void Exact_Sums_Avx512(const float *l, size_t n, float L, float threshold, double sums[3][EXACT_LANES])
+{
+	const __m512 Lv = _mm512_set1_ps(L), t = _mm512_set1_ps(threshold);
+	__m512d s[3][2];
+	for (int i = 0; i < 3; i++)
+		for (int j = 0; j < 2; j++)
+			s[i][j] = _mm512_loadu_pd(&sums[i][8 * j]);
+
+	for (size_t k = 0; k < n; k += EXACT_LANES)
+	{
+		__m512 lf = _mm512_loadu_ps(l + k);
+		__m512 e = Exact_Exp_Avx512(_mm512_sub_ps(_mm512_setzero_ps(), _mm512_mul_ps(Lv, lf)));
+		e = _mm512_maskz_mov_ps(_mm512_cmp_ps_mask(lf, t, _CMP_GE_OQ), e);
+		for (int j = 0; j < 2; j++)
+		{
+			//upper 8 floats without AVX512DQ
+			__m256 eh = j ? _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(e), 1)) : _mm512_castps512_ps256(e);
+			__m256 lh = j ? _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(lf), 1)) : _mm512_castps512_ps256(lf);
+			__m512d ed = _mm512_cvtps_pd(eh), ld = _mm512_cvtps_pd(lh);
+			__m512d el = _mm512_mul_pd(ed, ld);
+			s[0][j] = _mm512_add_pd(s[0][j], ed);
+			s[1][j] = _mm512_add_pd(s[1][j], el);
+			s[2][j] = _mm512_add_pd(s[2][j], _mm512_mul_pd(el, ld));
+		}
+	}
+
+	for (int i = 0; i < 3; i++)
+		for (int j = 0; j < 2; j++)
+			_mm512_storeu_pd(&sums[i][8 * j], s[i][j]);
+}
+
+#else
+
+//not x86: never called, Batch_SupportedIsa returns BATCH_ISA_SCALAR
+void Exact_Sums_Avx2(const float *, size_t, float, float, double [3][EXACT_LANES]) {}
+void Exact_Sums_Avx512(const float *, size_t, float, float, double [3][EXACT_LANES]) {}
+
+#endif
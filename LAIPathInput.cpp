@@ -0,0 +1,346 @@
+/*!
+* \file LAIPathInput.cpp
+* \date
+*			2026/10/17	Memory mapped input files, data lines parsed in parallel
+*			2026/10/17	Binary path lengths (NPY, raw float32 / float64), LAIPathBinary.h
+*
+*/
+
+#include <charconv>
+#include <cstring>
+
+#include "LAIPathInput.h"
+#include "LAIPathBinary.h"
+#include "LAIPathParallel.h"
+#include "LAIPathProfile.h"
+#include "LAIPathCounters.h"
+
+
+//number at the start of [p, end): blanks and '+' skipped as sscanf "%lf", the rest of the line is ignored
+static bool Input_Number(const char *p, const char *end, double *value)
+{
+	while (p < end && (*p == ' ' || *p == '\t'))
+		p++;
+	if (p < end && *p == '+')
+		p++;
+	std::from_chars_result r = std::from_chars(p, end, *value);
+	return r.ec == std::errc();
+}
+
+
+//end of the line starting at p ('\n' or end)
+static inline const char *Input_LineEnd(const char *p, const char *end)
+{
+	const char *nl = static_cast<const char *>(memchr(p, '\n', end - p));
+	return nl ? nl : end;
+}
+
+
+//empty line ends the data ('\r' of Windows files ignored)
+static inline bool Input_Empty(const char *p, const char *lineEnd)
+{
+	return p == lineEnd || (lineEnd - p == 1 && *p == '\r');
+}
+
+
+static void Input_ClearInfo(struct input_values_info *info)
+{
+	memset(info, 0, sizeof(*info));
+}
+
+
+//add the counts of a chunk, chunks in file order
+static void Input_AddInfo(struct input_values_info *info, const struct input_values_info *chunk)
+{
+	if (chunk->nNegative && (info->nNegative == 0 || chunk->minNegative < info->minNegative))
+		info->minNegative = chunk->minNegative;
+	if (chunk->nInvalid && info->nInvalid == 0)
+		info->firstInvalid = chunk->firstInvalid;
+	info->nLines += chunk->nLines;
+	info->nValues += chunk->nValues;
+	info->nNegative += chunk->nNegative;
+	info->nInvalid += chunk->nInvalid;
+}
+
+
+//************************************
+// Method:    LAIPathInput_Open	Map the input file and read the header
+// FullName:  LAIPathInput_Open
+// Access:    public
+// Returns:   int					GSL_SUCCESS, GSL_EFAILED (cannot be opened), GSL_EINVAL (header incomplete, not a float array)
+// Qualifier:
+// Parameter: lai_path_input * in
+// Parameter: const char * fname		text, or binary by extension (LAIPathBinary_Format)
+// Parameter: const char * fnameHeader	sidecar header of binary files, 0: default (LAIPathBinary.h)
+//************************************
+int LAIPathInput_Open(struct lai_path_input *in, const char *fname, const char *fnameHeader)
+{
+	in->file.data = 0;
+	in->file.size = 0;
+	in->file.hFile = 0;
+	in->file.hMapping = 0;
+	in->format = LAIPathBinary_Format(fname);
+	in->data = 0;
+	in->nValues = 0;
+	in->dataLine = 1;
+	in->chunk.clear();
+	in->chunkLines.clear();
+	in->scanned = false;
+	if (in->format != INPUT_TEXT)
+		return LAIPathBinary_Open(in, fname, fnameHeader);
+
+	if (MappedFile_Open(&in->file, fname) != 0)
+		return GSL_EFAILED;
+
+	const char *p = in->file.data, *end = p + in->file.size;
+	if (end - p >= 3 && memcmp(p, "\xEF\xBB\xBF", 3) == 0)		//UTF-8 BOM
+		p += 3;
+
+	for (int i = 0; i < INPUT_HEADER_LINES; i++)
+	{
+		if (p >= end)
+			return GSL_EINVAL;
+		const char *lineEnd = Input_LineEnd(p, end);
+		if (!Input_Number(p, lineEnd, &in->header[i]))
+			return GSL_EINVAL;
+		p = (lineEnd < end) ? lineEnd + 1 : end;
+		in->dataLine++;
+	}
+	in->data = p;
+	return GSL_SUCCESS;
+}
+
+
+void LAIPathInput_Close(struct lai_path_input *in)
+{
+	MappedFile_Close(&in->file);
+	in->data = 0;
+}
+
+
+//************************************
+// Method:    LAIPathInput_Scan	Chunks of the data lines up to the first empty line
+// FullName:  LAIPathInput_Scan
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: lai_path_input * in
+// Parameter: LaiPathPool & pool
+//************************************
+void LAIPathInput_Scan(struct lai_path_input *in, LaiPathPool &pool)
+{
+	if (in->scanned)
+		return;
+	LAI_PROFILE_SCOPE("input scan");
+	in->scanned = true;
+
+	const char *end = in->file.data + in->file.size;
+	const size_t size = in->data ? end - in->data : 0;
+	const size_t nChunks = GSL_MAX((size + INPUT_CHUNK_BYTES - 1) / INPUT_CHUNK_BYTES, (size_t)1);
+
+	//boundaries at line starts
+	in->chunk.resize(nChunks + 1);
+	in->chunk[0] = in->data;
+	for (size_t k = 1; k < nChunks; k++)
+	{
+		const char *p = in->data + k * (size / nChunks);
+		p = GSL_MAX(p, in->chunk[k - 1]);
+		in->chunk[k] = (p > in->data && p < end && p[-1] != '\n') ? GSL_MIN(Input_LineEnd(p, end) + 1, end) : p;
+	}
+	in->chunk[nChunks] = end;
+
+	//lines of each chunk and its first empty line
+	std::vector<const char *> emptyLine(nChunks);
+	in->chunkLines.assign(nChunks, 0);
+	pool.parallelFor(0, nChunks, 1, [&](size_t k0, size_t k1)
+	{
+		for (size_t k = k0; k < k1; k++)
+		{
+			const char *p = in->chunk[k], *chunkEnd = in->chunk[k + 1];
+			size_t lines = 0;
+			emptyLine[k] = 0;
+			while (p < chunkEnd)
+			{
+				const char *lineEnd = Input_LineEnd(p, chunkEnd);
+				if (Input_Empty(p, lineEnd))
+				{
+					emptyLine[k] = p;
+					break;
+				}
+				lines++;
+				p = lineEnd + 1;
+			}
+			in->chunkLines[k] = lines;
+		}
+	});
+
+	for (size_t k = 0; k < nChunks; k++)
+		if (emptyLine[k])
+		{
+			in->chunk.resize(k + 2);
+			in->chunk[k + 1] = emptyLine[k];
+			in->chunkLines.resize(k + 1);
+			break;
+		}
+}
+
+
+//parse chunk k into out, returns the counts of the chunk
+static void Input_ParseChunk(const struct lai_path_input *in, size_t k, size_t firstLine, bool dropNegative,
+	double *out, struct input_values_info *info)
+{
+	LAI_PROFILE_SCOPE("input parse chunk");
+	LaiPathCounterScope counter(COUNTER_PARSE);
+	if (in->format != INPUT_TEXT)
+	{
+		LAIPathBinary_ParseChunk(in, k, dropNegative, out, info);
+		return;
+	}
+
+	const char *p = in->chunk[k], *chunkEnd = in->chunk[k + 1];
+	Input_ClearInfo(info);
+
+	for (size_t line = firstLine; p < chunkEnd; line++)
+	{
+		const char *lineEnd = Input_LineEnd(p, chunkEnd);
+		double value;
+		if (!Input_Number(p, lineEnd, &value))
+		{
+			if (info->nInvalid++ == 0)
+				info->firstInvalid = line;
+		}
+		else
+		{
+			info->nLines++;
+			if (value < INPUT_NEGATIVE)
+			{
+				if (info->nNegative++ == 0 || value < info->minNegative)
+					info->minNegative = value;
+			}
+			if (!(dropNegative && value < INPUT_NEGATIVE))
+				out[info->nValues++] = value;
+		}
+		p = lineEnd + 1;
+	}
+}
+
+
+//first line number of every chunk
+static std::vector<size_t> Input_FirstLines(const struct lai_path_input *in)
+{
+	std::vector<size_t> firstLine(in->chunkLines.size());
+	size_t line = in->dataLine;
+	for (size_t k = 0; k < firstLine.size(); k++)
+	{
+		firstLine[k] = line;
+		line += in->chunkLines[k];
+	}
+	return firstLine;
+}
+
+
+//************************************
+// Method:    LAIPathInput_Values	Numbers of the data lines in file order
+// FullName:  LAIPathInput_Values
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: lai_path_input * in
+// Parameter: LaiPathPool & pool
+// Parameter: bool dropNegative				values < INPUT_NEGATIVE are counted but not returned (path lengths)
+// Parameter: std::vector<double> & values	(for return)
+// Parameter: input_values_info * info		(for return)
+//************************************
+void LAIPathInput_Values(struct lai_path_input *in, LaiPathPool &pool, bool dropNegative,
+	std::vector<double> &values, struct input_values_info *info)
+{
+	LAIPathInput_Scan(in, pool);
+	LAI_PROFILE_SCOPE("input values");
+	const size_t nChunks = in->chunkLines.size();
+	std::vector<size_t> firstLine = Input_FirstLines(in);
+	std::vector<size_t> offset(nChunks + 1, 0);
+	for (size_t k = 0; k < nChunks; k++)
+		offset[k + 1] = offset[k] + in->chunkLines[k];
+
+	//every chunk parsed in place, then moved behind the previous chunk
+	std::vector<struct input_values_info> chunkInfo(nChunks);
+	values.resize(offset[nChunks]);
+	pool.parallelFor(0, nChunks, 1, [&](size_t k0, size_t k1)
+	{
+		for (size_t k = k0; k < k1; k++)
+			Input_ParseChunk(in, k, firstLine[k], dropNegative, values.data() + offset[k], &chunkInfo[k]);
+	});
+
+	Input_ClearInfo(info);
+	for (size_t k = 0; k < nChunks; k++)
+	{
+		if (info->nValues != offset[k])
+			memmove(values.data() + info->nValues, values.data() + offset[k], chunkInfo[k].nValues * sizeof(double));
+		Input_AddInfo(info, &chunkInfo[k]);
+	}
+	values.resize(info->nValues);
+}
+
+
+//************************************
+// Method:    LAIPathInput_ForEachChunk	Numbers of the data lines, chunk by chunk without keeping them
+// FullName:  LAIPathInput_ForEachChunk
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: lai_path_input * in
+// Parameter: LaiPathPool & pool
+// Parameter: bool dropNegative		values < INPUT_NEGATIVE are counted but not passed to fn
+// Parameter: fn					called once per chunk, by several threads at the same time, in any order
+// Parameter: input_values_info * info	(for return)
+//************************************
+void LAIPathInput_ForEachChunk(struct lai_path_input *in, LaiPathPool &pool, bool dropNegative,
+	const std::function<void(const double *values, size_t n)> &fn, struct input_values_info *info)
+{
+	LAIPathInput_Scan(in, pool);
+	const size_t nChunks = in->chunkLines.size();
+	std::vector<size_t> firstLine = Input_FirstLines(in);
+	std::vector<struct input_values_info> chunkInfo(nChunks);
+
+	pool.parallelFor(0, nChunks, 1, [&](size_t k0, size_t k1)
+	{
+		std::vector<double> buffer;
+		for (size_t k = k0; k < k1; k++)
+		{
+			buffer.resize(in->chunkLines[k]);
+			Input_ParseChunk(in, k, firstLine[k], dropNegative, buffer.data(), &chunkInfo[k]);
+			fn(buffer.data(), chunkInfo[k].nValues);
+		}
+	});
+
+	Input_ClearInfo(info);
+	for (size_t k = 0; k < nChunks; k++)
+		Input_AddInfo(info, &chunkInfo[k]);
+}
+
+
+//************************************
+// Method:    LAIPathInput_Histogram	Stat_hist of the path lengths of the data lines
+// FullName:  LAIPathInput_Histogram
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: lai_path_input * in
+// Parameter: LaiPathPool & pool
+// Parameter: gsl_histogram * out_hist		path length distribution histogram (for return)
+// Parameter: input_values_info * info		path lengths < INPUT_NEGATIVE are dropped (for return)
+//************************************
+void LAIPathInput_Histogram(struct lai_path_input *in, LaiPathPool &pool, gsl_histogram *out_hist,
+	struct input_values_info *info)
+{
+	LAI_PROFILE_SCOPE("input histogram");
+	if (in->format != INPUT_TEXT)
+	{
+		LAIPathBinary_Histogram(in, pool, out_hist, info);		//binary values are not copied
+		return;
+	}
+
+	std::vector<double> pathLengths;
+	LAIPathInput_Values(in, pool, true, pathLengths, info);
+	Stat_hist_Parallel(pool, pathLengths.data(), pathLengths.size(), out_hist);
+}
@@ -0,0 +1,82 @@
+/*!
+* \file LAIPathInput.h
+* \date
+*			2026/10/17	Memory mapped input files, data lines parsed in parallel
+*			2026/10/17	Binary path lengths (NPY, raw float32 / float64), LAIPathBinary.h
+*
+* \brief
+*		Input files of the example (input_example*.txt): 5 header lines, each a number followed
+*		by a % comment (gap fraction inside canopy, gap fraction of large gaps, zenith, G, mode),
+*		then one number per line (path lengths or frequencies) up to the first empty line.
+*
+*		The file is mapped and read in place. The data lines are split into chunks of about
+*		INPUT_CHUNK_BYTES at line boundaries, chunks are scanned (lines, first empty line) and
+*		parsed (std::from_chars) as tasks of the pool. Negative values and lines without a
+*		number are counted in input_values_info instead of a warning per line.
+*
+*		Binary files (INPUT_FLOAT32, INPUT_FLOAT64) hold the values only, the header is read
+*		from a sidecar text file of the 5 header lines (LAIPathBinary.h). The chunks are then
+*		ranges of values, parsed by widening them to double.
+*
+*/
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "MappedFile.h"
+#include "LaiPathPool.h"
+#include "LAIPath.h"
+
+#define INPUT_HEADER_LINES	5
+#define INPUT_CHUNK_BYTES	(4 << 20)
+#define INPUT_NEGATIVE		-1e-6		//path lengths below are processed as large gaps
+
+//format of the input file
+#define INPUT_TEXT			0			//header and one number per line
+#define INPUT_FLOAT32		4			//binary, bytes per value
+#define INPUT_FLOAT64		8
+
+//header line of the input file
+#define INPUT_GAP_FRACTION	0			//gap fraction inside canopy
+#define INPUT_LARGE_GAPS	1			//gap fraction of large gaps
+#define INPUT_ZENITH		2			//observing zenith angle (degree)
+#define INPUT_G				3			//leaf projection function G
+#define INPUT_MODE			4			//< 0: path lengths, > 0: number of bins, 0: ellipse assumption
+
+struct lai_path_input
+{
+	struct mapped_file file;
+	int format;						//INPUT_TEXT, INPUT_FLOAT32 or INPUT_FLOAT64
+	double header[INPUT_HEADER_LINES];
+	const char *data;				//first data line, or first value of binary files (in the mapping)
+	size_t nValues;					//values of binary files
+	size_t dataLine;				//line number of the first data line (1-based)
+
+	//chunks of the data lines, up to the first empty line (LAIPathInput_Scan)
+	std::vector<const char *> chunk;	//nChunks + 1 boundaries
+	std::vector<size_t> chunkLines;		//lines (values) of each chunk
+	bool scanned;
+};
+
+//data lines of the input file
+struct input_values_info
+{
+	size_t nLines;					//data lines with a number
+	size_t nValues;					//values returned
+	size_t nNegative;				//values < INPUT_NEGATIVE
+	double minNegative;				//smallest of them
+	size_t nInvalid;				//lines without a number (ignored)
+	size_t firstInvalid;			//line number of the first of them
+};
+
+int LAIPathInput_Open(struct lai_path_input *in, const char *fname, const char *fnameHeader = 0);
+void LAIPathInput_Close(struct lai_path_input *in);
+void LAIPathInput_Scan(struct lai_path_input *in, LaiPathPool &pool);
+void LAIPathInput_Values(struct lai_path_input *in, LaiPathPool &pool, bool dropNegative,
+	std::vector<double> &values, struct input_values_info *info);
+void LAIPathInput_ForEachChunk(struct lai_path_input *in, LaiPathPool &pool, bool dropNegative,
+	const std::function<void(const double *values, size_t n)> &fn, struct input_values_info *info);
+void LAIPathInput_Histogram(struct lai_path_input *in, LaiPathPool &pool, gsl_histogram *out_hist,
+	struct input_values_info *info);
@@ -0,0 +1,177 @@
+/*!
+* \file LAIPathLatency.cpp
+* \date
+*			2026/10/17	Log-bucketed latency histogram (HDR style), percentiles and slowest plots
+*			2026/10/17	strncpy_s for the plot id
+*
+*/
+
+#include <cmath>
+#include <cstring>
+
+#include "LAIPathLatency.h"
+#include "LAIPathCompat.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+//position of the highest set bit, v > 0
+static inline int Latency_Msb(uint64_t v)
+{
+#ifdef _MSC_VER
+	unsigned long m;
+	_BitScanReverse64(&m, v);
+	return (int)m;
+#else
+	return 63 - __builtin_clzll(v);
+#endif
+}
+
+
+static inline size_t Latency_Bucket(uint64_t ns)
+{
+	if (ns < ((uint64_t)1 << LATENCY_SUB_BITS))
+		return (size_t)ns;
+	const int m = Latency_Msb(ns);
+	if (m >= LATENCY_MAX_BITS)
+		return LATENCY_BUCKETS - 1;
+	const uint64_t sub = (ns >> (m - LATENCY_SUB_BITS + 1)) - ((uint64_t)1 << (LATENCY_SUB_BITS - 1));
+	return ((size_t)1 << LATENCY_SUB_BITS) + (size_t)(m - LATENCY_SUB_BITS) * ((size_t)1 << (LATENCY_SUB_BITS - 1)) + (size_t)sub;
+}
+
+
+//largest value of bucket k
+static inline uint64_t Latency_Upper(size_t k)
+{
+	if (k < ((size_t)1 << LATENCY_SUB_BITS))
+		return k;
+	const size_t half = (size_t)1 << (LATENCY_SUB_BITS - 1);
+	const int m = (int)((k - ((size_t)1 << LATENCY_SUB_BITS)) / half) + LATENCY_SUB_BITS;
+	const uint64_t sub = (k - ((size_t)1 << LATENCY_SUB_BITS)) % half + half;
+	const int shift = m - LATENCY_SUB_BITS + 1;
+	return ((sub + 1) << shift) - 1;
+}
+
+
+//keeps the LATENCY_SLOWEST slowest, slowest first
+static void Latency_Slowest(struct latency_hist *h, const struct latency_sample *s)
+{
+	if (s->ns <= h->slowest[LATENCY_SLOWEST - 1].ns)
+		return;
+	int i = LATENCY_SLOWEST - 1;
+	for (; i > 0 && h->slowest[i - 1].ns < s->ns; i--)
+		h->slowest[i] = h->slowest[i - 1];
+	h->slowest[i] = *s;
+}
+
+
+void LatencyHist_Clear(struct latency_hist *h)
+{
+	memset(h, 0, sizeof(*h));
+	h->min = UINT64_MAX;
+}
+
+
+//************************************
+// Method:    LatencyHist_Record	Count one latency
+// FullName:  LatencyHist_Record
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: latency_hist * h
+// Parameter: uint64_t ns
+// Parameter: const char * id		plot, kept if among the slowest (0: none)
+//************************************
+void LatencyHist_Record(struct latency_hist *h, uint64_t ns, const char *id)
+{
+	h->counts[Latency_Bucket(ns)]++;
+	h->total++;
+	if (ns < h->min)
+		h->min = ns;
+	if (ns > h->max)
+		h->max = ns;
+
+	if (ns > h->slowest[LATENCY_SLOWEST - 1].ns)
+	{
+		struct latency_sample s;
+		memset(&s, 0, sizeof(s));
+		s.ns = ns;
+		if (id)
+			strncpy_s(s.id, sizeof(s.id), id, _TRUNCATE);
+		Latency_Slowest(h, &s);
+	}
+}
+
+
+void LatencyHist_Merge(struct latency_hist *dst, const struct latency_hist *src)
+{
+	for (size_t k = 0; k < LATENCY_BUCKETS; k++)
+		dst->counts[k] += src->counts[k];
+	dst->total += src->total;
+	if (src->min < dst->min)
+		dst->min = src->min;
+	if (src->max > dst->max)
+		dst->max = src->max;
+	for (int i = 0; i < LATENCY_SLOWEST && src->slowest[i].ns; i++)
+		Latency_Slowest(dst, &src->slowest[i]);
+}
+
+
+//************************************
+// Method:    LatencyHist_Percentile	Latency not exceeded by percentile % of the counts
+// FullName:  LatencyHist_Percentile
+// Access:    public
+// Returns:   uint64_t				ns, upper limit of the bucket (at most max), 0 if empty
+// Qualifier:
+// Parameter: const latency_hist * h
+// Parameter: double percentile		0 ... 100
+//************************************
+uint64_t LatencyHist_Percentile(const struct latency_hist *h, double percentile)
+{
+	if (h->total == 0)
+		return 0;
+	uint64_t rank = (uint64_t)ceil(percentile / 100 * h->total);
+	if (rank < 1)
+		rank = 1;
+	uint64_t seen = 0;
+	for (size_t k = 0; k < LATENCY_BUCKETS; k++)
+	{
+		seen += h->counts[k];
+		if (seen >= rank)
+		{
+			uint64_t upper = Latency_Upper(k);
+			return (upper < h->max) ? upper : h->max;
+		}
+	}
+	return h->max;
+}
+
+
+//************************************
+// Method:    LatencyHist_Report	One line of percentiles (us), then the slowest plots
+// FullName:  LatencyHist_Report
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: FILE * out
+// Parameter: const char * name		row name, 0: print the column names
+// Parameter: const latency_hist * h
+//************************************
+void LatencyHist_Report(FILE *out, const char *name, const struct latency_hist *h)
+{
+	if (name == 0)
+	{
+		fprintf(out, "%-14s %10s %11s %11s %11s %11s %11s\n", "latency", "plots", "p50 us", "p90 us", "p99 us", "p99.9 us", "max us");
+		return;
+	}
+	if (h->total == 0)
+		return;
+	fprintf(out, "%-14s %10llu %11.1f %11.1f %11.1f %11.1f %11.1f\n", name, (unsigned long long)h->total,
+		LatencyHist_Percentile(h, 50) * 1e-3, LatencyHist_Percentile(h, 90) * 1e-3, LatencyHist_Percentile(h, 99) * 1e-3,
+		LatencyHist_Percentile(h, 99.9) * 1e-3, h->max * 1e-3);
+	fprintf(out, "%14s slowest:", "");
+	for (int i = 0; i < LATENCY_SLOWEST && h->slowest[i].ns; i++)
+		fprintf(out, " %s (%.1f us)", h->slowest[i].id[0] ? h->slowest[i].id : "-", h->slowest[i].ns * 1e-3);
+	fprintf(out, "\n");
+}
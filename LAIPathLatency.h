@@ -0,0 +1,46 @@
+/*!
+* \file LAIPathLatency.h
+* \date
+*			2026/10/17	Log-bucketed latency histogram (HDR style), percentiles and slowest plots
+*
+* \brief
+*		Latencies in ns are counted in buckets of relative width 1/2^(LATENCY_SUB_BITS-1)
+*		(< 1%): values below 2^LATENCY_SUB_BITS exactly, above it 2^(LATENCY_SUB_BITS-1)
+*		linear sub-buckets per power of two, up to 2^LATENCY_MAX_BITS ns (larger values
+*		are counted in the last bucket). Recording is O(1) without allocation; histograms
+*		of threads or batches are merged by adding the counts. Percentiles are the upper
+*		limit of their bucket; min, max and the LATENCY_SLOWEST slowest plots are exact.
+*
+*/
+
+#pragma once
+
+#include <cstdio>
+#include <stdint.h>
+
+#define LATENCY_SUB_BITS	8
+#define LATENCY_MAX_BITS	46			//~19.5 hours
+#define LATENCY_BUCKETS		((1 << LATENCY_SUB_BITS) + (LATENCY_MAX_BITS - LATENCY_SUB_BITS) * (1 << (LATENCY_SUB_BITS - 1)))
+#define LATENCY_SLOWEST		5
+#define LATENCY_ID_BYTES	32
+
+struct latency_sample
+{
+	uint64_t ns;
+	char id[LATENCY_ID_BYTES];			//truncated
+};
+
+struct latency_hist
+{
+	uint64_t counts[LATENCY_BUCKETS];
+	uint64_t total;
+	uint64_t min;
+	uint64_t max;
+	struct latency_sample slowest[LATENCY_SLOWEST];	//slowest first, ns = 0: empty
+};
+
+void LatencyHist_Clear(struct latency_hist *h);
+void LatencyHist_Record(struct latency_hist *h, uint64_t ns, const char *id = 0);
+void LatencyHist_Merge(struct latency_hist *dst, const struct latency_hist *src);
+uint64_t LatencyHist_Percentile(const struct latency_hist *h, double percentile);
+void LatencyHist_Report(FILE *out, const char *name, const struct latency_hist *h);
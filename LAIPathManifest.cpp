@@ -0,0 +1,615 @@
+/*!
+* \file LAIPathManifest.cpp
+* \date
+*			2026/10/17	Manifest of plots, solved in one process
+*			2026/10/17	Results as CSV or JSON lines (LAIPathOutput.h)
+*			2026/10/17	Results appended to a result_archive while solving (ResultArchive.h)
+*			2026/10/17	Unchanged plots taken from a result_cache (ResultCache.h)
+*			2026/10/17	Latency of every plot, percentiles by input mode (LAIPathLatency.h)
+*			2026/10/17	Latency without the tasks of other plots run while waiting (LaiPathPool::stolenTime)
+*
+*/
+
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+#include "LAIPathManifest.h"
+#include "LAIPathParallel.h"
+#include "LaiPathSolver.h"
+#include "LAIPathProfile.h"
+
+#define MANIFEST_WARNINGS	10		//lines not understood reported one by one
+
+//columns of the header lines, index INPUT_GAP_FRACTION ... INPUT_MODE
+static const char *const manifest_header[INPUT_HEADER_LINES] = { "gap_fraction", "large_gaps", "zenith", "G", "mode" };
+
+
+static void Manifest_Clear(struct manifest_plot *plot, size_t line)
+{
+	plot->id.clear();
+	plot->line = line;
+	for (int i = 0; i < INPUT_HEADER_LINES; i++)
+		plot->header[i] = GSL_NAN;
+	plot->path.clear();
+	plot->histogram.clear();
+
+	plot->status = GSL_SUCCESS;
+	plot->LAIe = plot->LAI = plot->CI = GSL_NAN;
+	plot->nPath = 0;
+	memset(&plot->info, 0, sizeof(plot->info));
+	memset(&plot->error, 0, sizeof(plot->error));
+	plot->solved = false;
+	plot->latency = 0;
+}
+
+
+//numbers separated by blanks, ',' or ';'
+static bool Manifest_Numbers(const std::string &text, std::vector<double> &values)
+{
+	const char *p = text.c_str();
+	values.clear();
+	for (p += strspn(p, " \t,;"); *p; p += strspn(p, " \t,;"))
+	{
+		char *next;
+		values.push_back(strtod(p, &next));
+		if (next == p)
+			return false;
+		p = next;
+	}
+	return true;
+}
+
+
+//value of a column of the row, false if it is not a number where one is needed (other columns are ignored)
+static bool Manifest_Field(struct manifest_plot *plot, const std::string &key, const std::string &text,
+	const std::vector<double> *array)
+{
+	if (key == "id")
+		plot->id = text;
+	else if (key == "path")
+		plot->path = text;
+	else if (key == "histogram")
+	{
+		if (array)
+			plot->histogram = *array;
+		else if (!Manifest_Numbers(text, plot->histogram))
+			return false;
+	}
+	else
+	{
+		for (int i = 0; i < INPUT_HEADER_LINES; i++)
+			if (key == manifest_header[i])
+			{
+				if (text.empty())
+					return true;			//not given
+				char *end;
+				plot->header[i] = strtod(text.c_str(), &end);
+				return end != text.c_str() && end[strspn(end, " \t")] == '\0';
+			}
+	}
+	return true;
+}
+
+
+//fields of a CSV line, "quoted" fields may contain ',' and "" for '"'
+static void Csv_Split(const char *p, const char *end, std::vector<std::string> &fields)
+{
+	fields.clear();
+	for (;;)
+	{
+		std::string field;
+		while (p < end && (*p == ' ' || *p == '\t'))
+			p++;
+		if (p < end && *p == '"')
+		{
+			for (p++; p < end; p++)
+			{
+				if (*p == '"' && (p + 1 == end || p[1] != '"'))
+				{
+					p++;
+					break;
+				}
+				if (*p == '"')
+					p++;
+				field += *p;
+			}
+			while (p < end && *p != ',')
+				p++;
+		}
+		else
+		{
+			const char *start = p;
+			while (p < end && *p != ',')
+				p++;
+			const char *last = p;
+			while (last > start && (last[-1] == ' ' || last[-1] == '\t'))
+				last--;
+			field.assign(start, last);
+		}
+		fields.push_back(field);
+		if (p >= end)
+			break;
+		p++;		//','
+	}
+}
+
+
+static const char *Json_Blank(const char *p, const char *end)
+{
+	while (p < end && isspace((unsigned char)*p))
+		p++;
+	return p;
+}
+
+
+//string after the opening '"', returns the character after the closing '"' (0: none)
+static const char *Json_String(const char *p, const char *end, std::string &s)
+{
+	s.clear();
+	for (; p < end && *p != '"'; p++)
+	{
+		if (*p != '\\' || p + 1 == end)
+		{
+			s += *p;
+			continue;
+		}
+		switch (*++p)
+		{
+		case 'n':	s += '\n';	break;
+		case 't':	s += '\t';	break;
+		case 'r':	s += '\r';	break;
+		case 'b':	s += '\b';	break;
+		case 'f':	s += '\f';	break;
+		case 'u':	s += '?';	p += GSL_MIN((ptrdiff_t)4, end - p - 1);	break;		//not needed in names and paths
+		default:	s += *p;	break;
+		}
+	}
+	return (p < end) ? p + 1 : 0;
+}
+
+
+//one object of a JSON line: strings, numbers, null and arrays of numbers
+static bool Json_Row(const char *p, const char *end, struct manifest_plot *plot)
+{
+	std::string key, text;
+	std::vector<double> array;
+
+	p = Json_Blank(p, end);
+	if (p == end || *p++ != '{')
+		return false;
+	for (;;)
+	{
+		p = Json_Blank(p, end);
+		if (p < end && *p == '}')
+			return true;
+		if (p == end || *p != '"' || (p = Json_String(p + 1, end, key)) == 0)
+			return false;
+		p = Json_Blank(p, end);
+		if (p == end || *p != ':')
+			return false;
+		p = Json_Blank(p + 1, end);
+
+		bool isArray = false;
+		text.clear();
+		if (p < end && *p == '"')
+		{
+			if ((p = Json_String(p + 1, end, text)) == 0)
+				return false;
+		}
+		else if (p < end && *p == '[')
+		{
+			isArray = true;
+			array.clear();
+			for (p = Json_Blank(p + 1, end); p < end && *p != ']'; p = Json_Blank(p, end))
+			{
+				double value;
+				std::from_chars_result r = std::from_chars(p, end, value);
+				if (r.ec != std::errc())
+					return false;
+				array.push_back(value);
+				p = Json_Blank(r.ptr, end);
+				if (p < end && *p == ',')
+					p++;
+			}
+			if (p == end)
+				return false;
+			p++;
+		}
+		else
+		{
+			const char *start = p;
+			while (p < end && *p != ',' && *p != '}' && !isspace((unsigned char)*p))
+				p++;
+			text.assign(start, p);
+			if (text == "null")
+				text.clear();
+		}
+		if (!Manifest_Field(plot, key, text, isArray ? &array : 0))
+			return false;
+
+		p = Json_Blank(p, end);
+		if (p < end && *p == ',')
+			p++;
+		else if (p == end || *p != '}')
+			return false;
+	}
+}
+
+
+//************************************
+// Method:    Manifest_Read	Plots of a CSV or JSON lines manifest
+// FullName:  Manifest_Read
+// Access:    public
+// Returns:   int					GSL_SUCCESS, GSL_EFAILED (cannot be opened), GSL_EINVAL (lines not understood are skipped)
+// Qualifier:
+// Parameter: const char * fname
+// Parameter: std::vector<manifest_plot> & plots	rows are appended (for return)
+// Parameter: FILE * report						lines not understood, 0: none
+//************************************
+int Manifest_Read(const char *fname, std::vector<struct manifest_plot> &plots, FILE *report)
+{
+	LAI_PROFILE_SCOPE("manifest read");
+	struct mapped_file mf;
+	if (MappedFile_Open(&mf, fname) != 0)
+		return GSL_EFAILED;
+
+	const char *p = mf.data, *end = p + mf.size;
+	if (end - p >= 3 && memcmp(p, "\xEF\xBB\xBF", 3) == 0)		//UTF-8 BOM
+		p += 3;
+
+	//paths are relative to the manifest
+	std::string dir(fname);
+	dir.erase(dir.find_last_of("/\\") + 1);		//npos + 1: empty
+
+	const char *ext = strrchr(fname, '.');
+	const char *first = Json_Blank(p, end);
+	bool json = (first < end && *first == '{') || (ext && (strcmp(ext, ".jsonl") == 0 || strcmp(ext, ".json") == 0));
+
+	std::vector<std::string> columns, fields;
+	size_t nSkipped = 0;
+	for (size_t line = 1; p < end; line++)
+	{
+		const char *lineEnd = static_cast<const char *>(memchr(p, '\n', end - p));
+		const char *next = lineEnd ? lineEnd + 1 : end;
+		if (!lineEnd)
+			lineEnd = end;
+		if (lineEnd > p && lineEnd[-1] == '\r')
+			lineEnd--;
+
+		const char *text = Json_Blank(p, lineEnd);
+		if (text == lineEnd || *text == '#')
+		{
+			p = next;		//empty line or comment
+			continue;
+		}
+		if (!json && columns.empty())
+		{
+			Csv_Split(p, lineEnd, columns);
+			p = next;
+			continue;
+		}
+
+		struct manifest_plot plot;
+		Manifest_Clear(&plot, line);
+		bool ok = true;
+		if (json)
+			ok = Json_Row(p, lineEnd, &plot);
+		else
+		{
+			Csv_Split(p, lineEnd, fields);
+			for (size_t i = 0; i < fields.size() && i < columns.size(); i++)
+				ok = Manifest_Field(&plot, columns[i], fields[i], 0) && ok;
+		}
+
+		if (!ok)
+		{
+			if (report && nSkipped < MANIFEST_WARNINGS)
+				fprintf(report, "Warning: line %zu of '%s' is not understood, skipped\n", line, fname);
+			nSkipped++;
+		}
+		else
+		{
+			if (plot.id.empty())
+				plot.id = std::to_string(line);
+			if (!plot.path.empty() && plot.path[0] != '/' && plot.path[0] != '\\' && !(plot.path.size() > 1 && plot.path[1] == ':'))
+				plot.path.insert(0, dir);
+			plots.push_back(std::move(plot));
+		}
+		p = next;
+	}
+	MappedFile_Close(&mf);
+
+	if (report && nSkipped > MANIFEST_WARNINGS)
+		fprintf(report, "Warning: %zu lines of '%s' are not understood, skipped\n", nSkipped, fname);
+	return nSkipped ? GSL_EINVAL : GSL_SUCCESS;
+}
+
+
+//results of a plot as a record, valid as long as the plot
+static void Manifest_Record(const struct manifest_plot &plot, struct lai_path_record *record)
+{
+	record->id = plot.id.c_str();
+	memcpy(record->header, plot.header, sizeof(record->header));
+	record->nPath = plot.nPath;
+	record->LAIe = plot.LAIe;
+	record->LAI = plot.LAI;
+	record->CI = plot.CI;
+	record->info = plot.info;
+	record->status = plot.status;
+	record->gsl_errno = plot.error.gsl_errno;
+}
+
+
+static void Manifest_Archive(struct result_archive *archive, const struct manifest_plot &plot, const gsl_histogram *hist)
+{
+	if (archive == 0)
+		return;
+	struct lai_path_record record;
+	Manifest_Record(plot, &record);
+	Archive_Append(archive, &record, hist);
+}
+
+
+//LAI of one plot as the example for one input file
+//key of the inputs of a plot: data of its file, or inline frequencies normalized to sum 1
+static void Manifest_Key(const struct manifest_plot &plot, const struct lai_path_input *input, int mode, int flags,
+	struct cache_entry *entry)
+{
+	if (mode != 0 && !plot.histogram.empty())
+	{
+		std::vector<double> normalized(plot.histogram);
+		double sum = 0;
+		for (size_t i = 0; i < normalized.size(); i++)
+			sum += normalized[i];
+		for (size_t i = 0; i < normalized.size(); i++)
+			normalized[i] /= sum;
+		ResultCache_Key(entry, plot.header, flags, normalized.data(), normalized.size() * sizeof(double));
+	}
+	else if (mode != 0)
+		ResultCache_Key(entry, plot.header, flags, input->data, input->file.data + input->file.size - input->data);
+	else
+		ResultCache_Key(entry, plot.header, flags, 0, 0);
+}
+
+
+//results of a plot of the same inputs
+static void Manifest_FromCache(struct manifest_plot &plot, const struct cache_entry &cached)
+{
+	plot.status = cached.status;
+	plot.nPath = (size_t)cached.nPath;
+	plot.LAIe = cached.LAIe;
+	plot.LAI = cached.LAI;
+	plot.CI = cached.CI;
+	plot.info = cached.info;
+	memset(&plot.error, 0, sizeof(plot.error));
+	plot.error.gsl_errno = cached.gsl_errno;
+}
+
+
+//plot p; plots of the same inputs that waited for it (CACHE_WAITING) get its results too
+static void Manifest_SolvePlot(LaiPathPool &pool, std::vector<struct manifest_plot> &plots, size_t p, int integration,
+	const struct circle_lut *lut, struct result_archive *archive, struct result_cache *cache)
+{
+	LAI_PROFILE_SCOPE("manifest plot");
+	struct manifest_plot &plot = plots[p];
+	double *header = plot.header;
+	const bool hasInput = !plot.path.empty();
+	struct lai_path_input input;
+	struct input_values_info valuesInfo;
+	memset(&valuesInfo, 0, sizeof(valuesInfo));
+
+	if (hasInput)
+	{
+		//binary files need no sidecar header if the row has the parameters
+		bool inRow = !gsl_isnan(header[INPUT_GAP_FRACTION]) && !gsl_isnan(header[INPUT_ZENITH]) && !gsl_isnan(header[INPUT_G]);
+		plot.status = LAIPathInput_Open(&input, plot.path.c_str(), inRow ? "" : 0);
+		if (plot.status != GSL_SUCCESS)
+		{
+			LAIPathInput_Close(&input);
+			Manifest_Archive(archive, plot, 0);
+			return;
+		}
+		for (int i = 0; i < INPUT_HEADER_LINES; i++)
+			if (gsl_isnan(header[i]))
+				header[i] = input.header[i];
+	}
+	if (gsl_isnan(header[INPUT_LARGE_GAPS]))
+		header[INPUT_LARGE_GAPS] = 0;
+	if (gsl_isnan(header[INPUT_MODE]))
+		header[INPUT_MODE] = !plot.histogram.empty() ? (double)plot.histogram.size() : hasInput ? -1 : 0;
+
+	const int mode = (int)header[INPUT_MODE];
+	const double gapFraction = header[INPUT_GAP_FRACTION], zenith = header[INPUT_ZENITH], G = header[INPUT_G];
+	double largeGaps = header[INPUT_LARGE_GAPS];
+	if (gsl_isnan(gapFraction) || gsl_isnan(zenith) || gsl_isnan(G)
+		|| (mode < 0 && !hasInput) || (mode > 0 && !hasInput && plot.histogram.empty()))
+	{
+		plot.status = GSL_EINVAL;
+		if (hasInput)
+			LAIPathInput_Close(&input);
+		Manifest_Archive(archive, plot, 0);
+		return;
+	}
+
+	gsl_histogram *hist = 0;
+	double totalGap = largeGaps + (1 - largeGaps) * gapFraction;
+	plot.LAIe = -log(totalGap) / G * cos(zenith * M_PI / 180);
+
+	//unchanged plots are neither parsed nor solved
+	struct cache_entry cached;
+	if (cache)
+	{
+		Manifest_Key(plot, &input, mode, integration | (lut ? CACHE_LUT : 0), &cached);
+		int found = ResultCache_Find(cache, &cached, p);
+		if (found != CACHE_MISS)
+		{
+			if (hasInput)
+				LAIPathInput_Close(&input);
+			if (found == CACHE_HIT)
+			{
+				Manifest_FromCache(plot, cached);
+				Manifest_Archive(archive, plot, 0);
+			}
+			return;				//CACHE_WAITING: results and archive row by the plot solving the same inputs
+		}
+	}
+
+	//input files are parsed in subtasks, in the meantime this thread may run other plots
+	//and reuse its scratch histogram: they get their own
+	gsl_histogram *ownHist = 0;
+	if (mode < 0)
+	{
+		ownHist = gsl_histogram_alloc(NUM_BINS);
+		LAIPathInput_Histogram(&input, pool, ownHist, &valuesInfo);
+		plot.nPath = valuesInfo.nValues;
+	}
+	else if (mode > 0 && plot.histogram.empty())
+		LAIPathInput_Values(&input, pool, false, plot.histogram, &valuesInfo);
+	if (hasInput)
+		LAIPathInput_Close(&input);
+
+	LaiPathSolver &solver = Parallel_Solver(integration);
+	struct gsl_error_state *error = LAI_PATH_ErrorState();
+	error->gsl_errno = GSL_SUCCESS;
+
+	if (mode < 0)
+	{
+		double LAI = solver.solve(ownHist, gapFraction, zenith, G);
+		plot.info = solver.info();
+		plot.LAI = LAI * (1 - largeGaps) / valuesInfo.nLines * (valuesInfo.nLines - valuesInfo.nNegative);
+	}
+	else if (mode > 0)
+	{
+		hist = solver.histogram(mode);
+		for (size_t i = 0; i < plot.histogram.size() && i < hist->n; i++)
+			hist->bin[i] = plot.histogram[i];
+		plot.nPath = plot.histogram.size();
+		gsl_histogram_scale(hist, static_cast<double>(hist->n) / gsl_histogram_sum(hist));
+
+		plot.LAI = solver.solve(hist, gapFraction, zenith, G) * (1 - largeGaps);
+		plot.info = solver.info();
+	}
+	else
+		plot.LAI = LAI_PATH_Circle_LUT(lut, gapFraction, zenith, G, &plot.info) * (1 - largeGaps);
+
+	plot.CI = plot.LAIe / plot.LAI;
+	plot.status = plot.info.status;
+	plot.error = *error;
+	plot.solved = true;
+	Manifest_Archive(archive, plot, ownHist ? ownHist : hist);
+	if (cache)
+	{
+		cached.status = plot.status;
+		cached.gsl_errno = plot.error.gsl_errno;
+		cached.nPath = plot.nPath;
+		cached.LAIe = plot.LAIe;
+		cached.LAI = plot.LAI;
+		cached.CI = plot.CI;
+		cached.info = plot.info;
+		std::vector<size_t> waiters;
+		ResultCache_Store(cache, &cached, &waiters);
+		for (size_t i = 0; i < waiters.size(); i++)
+		{
+			Manifest_FromCache(plots[waiters[i]], cached);
+			Manifest_Archive(archive, plots[waiters[i]], ownHist ? ownHist : hist);
+		}
+	}
+	if (ownHist)
+		gsl_histogram_free(ownHist);
+}
+
+
+//************************************
+// Method:    Manifest_Solve	LAI and clumping index of the plots of a manifest, one task per plot
+// FullName:  Manifest_Solve
+// Access:    public
+// Returns:   size_t						number of plots with GSL errors or not solved (LAI_PATH_ZERO_PATH is solved)
+// Qualifier:
+// Parameter: LaiPathPool & pool
+// Parameter: std::vector<manifest_plot> & plots	results are returned in place
+// Parameter: int integration				LAI_PATH_ANALYTIC, LAI_PATH_QUADRATURE or LAI_PATH_COMPARE
+// Parameter: const circle_lut * lut		ellipse assumption (mode 0), 0: solved directly
+// Parameter: result_archive * archive	0, or every plot is appended when solved (rows in order of completion)
+// Parameter: result_cache * cache		0, or results of plots with unchanged inputs are taken from it (path length bins of the archive: NaN),
+//										plots of the same inputs in this run are solved once
+//************************************
+size_t Manifest_Solve(LaiPathPool &pool, std::vector<struct manifest_plot> &plots, int integration, const struct circle_lut *lut,
+	struct result_archive *archive, struct result_cache *cache)
+{
+	pool.parallelFor(0, plots.size(), 1, [&](size_t p0, size_t p1)
+	{
+		for (size_t p = p0; p < p1; p++)
+		{
+			struct manifest_plot &plot = plots[p];
+			//wait() of its nested loops runs tasks of other plots too: their time is not its latency
+			const uint64_t stolen = LaiPathPool::stolenTime();
+			const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			Manifest_SolvePlot(pool, plots, p, integration, lut, archive, cache);
+			const uint64_t elapsed = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+			plot.latency = elapsed - (LaiPathPool::stolenTime() - stolen);
+		}
+	});
+
+	//after the loop: plots that waited for another one get their results when it is solved
+	size_t nFailed = 0;
+	for (size_t p = 0; p < plots.size(); p++)
+		if ((plots[p].status != GSL_SUCCESS && plots[p].status != LAI_PATH_ZERO_PATH) || plots[p].error.gsl_errno != GSL_SUCCESS)
+			nFailed++;
+	return nFailed;
+}
+
+
+//************************************
+// Method:    Manifest_Latency	Latency histograms of the plots by input mode
+// FullName:  Manifest_Latency
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: const std::vector<manifest_plot> & plots	after Manifest_Solve (plots without mode are not counted)
+// Parameter: latency_hist latency[MANIFEST_MODES]		(for return) MANIFEST_PATH_LENGTHS, MANIFEST_HISTOGRAM, MANIFEST_ELLIPSE
+//************************************
+void Manifest_Latency(const std::vector<struct manifest_plot> &plots, struct latency_hist latency[MANIFEST_MODES])
+{
+	for (int m = 0; m < MANIFEST_MODES; m++)
+		LatencyHist_Clear(&latency[m]);
+	for (size_t p = 0; p < plots.size(); p++)
+	{
+		const double mode = plots[p].header[INPUT_MODE];
+		if (gsl_isnan(mode))
+			continue;
+		int m = (mode < 0) ? MANIFEST_PATH_LENGTHS : (mode > 0) ? MANIFEST_HISTOGRAM : MANIFEST_ELLIPSE;
+		LatencyHist_Record(&latency[m], plots[p].latency, plots[p].id.c_str());
+	}
+}
+
+
+//************************************
+// Method:    Manifest_WriteTable	Results of the plots, one record per plot in manifest order
+// FullName:  Manifest_WriteTable
+// Access:    public
+// Returns:   int					GSL_SUCCESS, GSL_EFAILED (cannot be written), GSL_ENOMEM
+// Qualifier:
+// Parameter: const char * fname
+// Parameter: const std::vector<manifest_plot> & plots
+// Parameter: int format			OUTPUT_CSV or OUTPUT_JSONL
+//************************************
+int Manifest_WriteTable(const char *fname, const std::vector<struct manifest_plot> &plots, int format)
+{
+	LAI_PROFILE_SCOPE("output table");
+	struct lai_path_output out;
+	int status = LAIPathOutput_Open(&out, fname, format);
+	if (status != GSL_SUCCESS)
+		return status;
+
+	for (size_t p = 0; p < plots.size(); p++)
+	{
+		struct lai_path_record record;
+		Manifest_Record(plots[p], &record);
+		LAIPathOutput_Record(&out, &record);
+	}
+	return LAIPathOutput_Close(&out);
+}
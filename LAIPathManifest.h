@@ -0,0 +1,73 @@
+/*!
+* \file LAIPathManifest.h
+* \date
+*			2026/10/17	Manifest of plots, solved in one process
+*			2026/10/17	Results as CSV or JSON lines (LAIPathOutput.h)
+*			2026/10/17	Results appended to a result_archive while solving (ResultArchive.h)
+*			2026/10/17	Unchanged plots taken from a result_cache (ResultCache.h)
+*			2026/10/17	Latency of every plot, percentiles by input mode (LAIPathLatency.h)
+*
+* \brief
+*		One row per plot instead of one input file per run, as CSV (first line: column names)
+*		or JSON lines (one object per line, .jsonl or first character '{'):
+*			id				name of the plot (default: line of the manifest)
+*			gap_fraction	gap fraction inside canopy
+*			large_gaps		gap fraction of large gaps (default 0)
+*			zenith			observing zenith angle (degree)
+*			G				leaf projection function
+*			mode			as the input files: < 0 path lengths, > 0 number of bins, 0 ellipse assumption
+*			path			input file of the path lengths or frequencies (text or binary, LAIPathInput.h),
+*							relative to the manifest; fields missing in the row are read from its header
+*			histogram		frequencies of the bins (CSV: separated by blanks or ';', JSON: array)
+*		Without mode, a plot with histogram has mode = number of frequencies, a plot with path
+*		the mode of its header (binary files without sidecar: -1), else 0.
+*
+*		Plots are tasks of LaiPathPool solved by the LaiPathSolver of the executing thread
+*		(Parallel_Solver); large path length files are parsed in subtasks. Results are
+*		computed as by the example for one input file and kept in the rows.
+*
+*/
+
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "LAIPathInput.h"
+#include "CircleLUT.h"
+#include "ResultArchive.h"
+#include "ResultCache.h"
+#include "LAIPathLatency.h"
+
+//input modes of the latency histograms (Manifest_Latency)
+#define MANIFEST_PATH_LENGTHS	0		//mode < 0
+#define MANIFEST_HISTOGRAM		1		//mode > 0
+#define MANIFEST_ELLIPSE		2		//mode 0
+#define MANIFEST_MODES			3
+
+struct manifest_plot
+{
+	std::string id;
+	size_t line;						//line of the manifest
+	double header[INPUT_HEADER_LINES];	//INPUT_GAP_FRACTION ... INPUT_MODE, NaN: not in the row
+	std::string path;					//empty: none
+	std::vector<double> histogram;		//inline frequencies
+
+	//results
+	int status;						//GSL_SUCCESS, GSL_EFAILED (path cannot be opened), GSL_EINVAL (incomplete), or of the LAImax solve
+	double LAIe;
+	double LAI;						//LAI_PATH with large gaps
+	double CI;						//clumping index LAIe / LAI
+	size_t nPath;					//path lengths (mode < 0) or frequencies
+	struct solver_info info;
+	struct gsl_error_state error;	//first GSL error of the plot
+	bool solved;					//solved in this run: info is its work (not a cache hit, nor waiting for another plot)
+	uint64_t latency;				//ns from the start of its task to its results (parse, solve), without tasks of other plots
+};
+
+int Manifest_Read(const char *fname, std::vector<struct manifest_plot> &plots, FILE *report = stderr);
+size_t Manifest_Solve(LaiPathPool &pool, std::vector<struct manifest_plot> &plots, int integration = LAI_PATH_ANALYTIC,
+	const struct circle_lut *lut = 0, struct result_archive *archive = 0, struct result_cache *cache = 0);
+void Manifest_Latency(const std::vector<struct manifest_plot> &plots, struct latency_hist latency[MANIFEST_MODES]);
+int Manifest_WriteTable(const char *fname, const std::vector<struct manifest_plot> &plots, int format);
@@ -0,0 +1,280 @@
+/*!
+* \file LAIPathOutput.cpp
+* \date
+*			2026/10/17	Buffered results output, one CSV line or JSON object per plot
+*
+*/
+
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+
+#include "LAIPathOutput.h"
+#include "LAIPathCompat.h"
+#include "LAIPathProfile.h"
+
+//fields of a record, in order
+enum output_column
+{
+	COL_ID, COL_GAP_FRACTION, COL_LARGE_GAPS, COL_ZENITH, COL_G, COL_MODE, COL_N_PATH,
+	COL_LAIE, COL_LAI_PATH, COL_CI, COL_LAIMAX, COL_MEAN_PATH, COL_ITER, COL_N_EVAL,
+	COL_N_PATH_PROB, COL_N_INTERVALS, COL_MAX_INTERVALS, COL_BRACKET_FAIL, COL_FALLBACK, COL_STATUS, COL_GSL_ERRNO,
+	OUTPUT_COLUMNS
+};
+
+static const char *const output_columns[OUTPUT_COLUMNS] = { "id", "gap_fraction", "large_gaps", "zenith", "G", "mode", "n_path",
+	"LAIe", "LAI_PATH", "CI", "LAImax", "mean_path", "iter", "n_eval",
+	"n_path_prob", "n_intervals", "max_intervals", "bracket_fail", "fallback", "status", "gsl_errno" };
+
+
+static void Output_Flush(struct lai_path_output *out)
+{
+	if (out->used && fwrite(out->buffer, 1, out->used, out->file) != out->used)
+		out->failed = true;
+	out->used = 0;
+}
+
+
+//room for n bytes at buffer + used (n <= OUTPUT_BUFFER)
+static inline char *Output_Reserve(struct lai_path_output *out, size_t n)
+{
+	if (out->used + n > OUTPUT_BUFFER)
+		Output_Flush(out);
+	return out->buffer + out->used;
+}
+
+
+static void Output_Text(struct lai_path_output *out, const char *s, size_t len)
+{
+	if (len > OUTPUT_BUFFER / 2)
+	{
+		Output_Flush(out);
+		if (fwrite(s, 1, len, out->file) != len)
+			out->failed = true;
+		return;
+	}
+	memcpy(Output_Reserve(out, len), s, len);
+	out->used += len;
+}
+
+
+static inline void Output_Char(struct lai_path_output *out, char c)
+{
+	*Output_Reserve(out, 1) = c;
+	out->used++;
+}
+
+
+//shortest representation that reads back the same double, NaN and infinities as nan / inf (CSV) or null (JSON)
+static void Output_Double(struct lai_path_output *out, double value)
+{
+	if (!gsl_finite(value))
+	{
+		if (out->format == OUTPUT_JSONL)
+			Output_Text(out, "null", 4);
+		else if (gsl_isnan(value))
+			Output_Text(out, "nan", 3);
+		else
+			Output_Text(out, value > 0 ? "inf" : "-inf", value > 0 ? 3 : 4);
+		return;
+	}
+	char *p = Output_Reserve(out, 32);
+	out->used += std::to_chars(p, p + 32, value).ptr - p;
+}
+
+
+static void Output_Integer(struct lai_path_output *out, long long value)
+{
+	char *p = Output_Reserve(out, 24);
+	out->used += std::to_chars(p, p + 24, value).ptr - p;
+}
+
+
+//CSV: quoted if it contains ',', '"' or line breaks; JSON: escaped string
+static void Output_String(struct lai_path_output *out, const char *s)
+{
+	const size_t len = strlen(s);
+	if (out->format == OUTPUT_CSV && strpbrk(s, ",\"\r\n") == 0)
+	{
+		Output_Text(out, s, len);
+		return;
+	}
+
+	Output_Char(out, '"');
+	for (size_t i = 0; i < len; i++)
+	{
+		unsigned char c = (unsigned char)s[i];
+		if (out->format == OUTPUT_CSV)
+		{
+			if (c == '"')
+				Output_Char(out, '"');
+			Output_Char(out, c);
+		}
+		else if (c == '"' || c == '\\')
+		{
+			Output_Char(out, '\\');
+			Output_Char(out, c);
+		}
+		else if (c < 0x20)
+		{
+			char escape[8];
+			snprintf(escape, sizeof(escape), "\\u%04x", c);
+			Output_Text(out, escape, 6);
+		}
+		else
+			Output_Char(out, c);
+	}
+	Output_Char(out, '"');
+}
+
+
+//separator and, for JSON, the name of the next field
+static inline void Output_Key(struct lai_path_output *out, int column)
+{
+	if (out->format == OUTPUT_CSV)
+	{
+		if (column)
+			Output_Char(out, ',');
+		return;
+	}
+	Output_Text(out, column ? ",\"" : "{\"", 2);
+	Output_Text(out, output_columns[column], strlen(output_columns[column]));
+	Output_Text(out, "\":", 2);
+}
+
+
+//************************************
+// Method:    LAIPathOutput_Format	Format of a results file by its extension
+// FullName:  LAIPathOutput_Format
+// Access:    public
+// Returns:   int					OUTPUT_CSV (.csv), OUTPUT_JSONL (.jsonl, .json), -1: other (report of the example)
+// Qualifier:
+// Parameter: const char * fname
+//************************************
+int LAIPathOutput_Format(const char *fname)
+{
+	const char *ext = strrchr(fname, '.');
+	if (ext == 0 || strpbrk(ext, "/\\") != 0)
+		return -1;
+	if (strcmp(ext, ".csv") == 0 || strcmp(ext, ".CSV") == 0)
+		return OUTPUT_CSV;
+	if (strcmp(ext, ".jsonl") == 0 || strcmp(ext, ".json") == 0)
+		return OUTPUT_JSONL;
+	return -1;
+}
+
+
+//************************************
+// Method:    LAIPathOutput_Open	Create a results file, CSV starts with the column names
+// FullName:  LAIPathOutput_Open
+// Access:    public
+// Returns:   int					GSL_SUCCESS, GSL_EFAILED (cannot be created), GSL_ENOMEM
+// Qualifier:
+// Parameter: lai_path_output * out
+// Parameter: const char * fname
+// Parameter: int format			OUTPUT_CSV or OUTPUT_JSONL
+//************************************
+int LAIPathOutput_Open(struct lai_path_output *out, const char *fname, int format)
+{
+	out->format = format;
+	out->used = 0;
+	out->failed = false;
+	out->buffer = 0;
+	if (fopen_s(&out->file, fname, "wb") != 0)
+		return GSL_EFAILED;
+	out->buffer = (char *)malloc(OUTPUT_BUFFER);
+	if (out->buffer == 0)
+	{
+		fclose(out->file);
+		out->file = 0;
+		return GSL_ENOMEM;
+	}
+
+	if (format == OUTPUT_CSV)
+	{
+		for (int column = 0; column < OUTPUT_COLUMNS; column++)
+		{
+			Output_Key(out, column);
+			Output_Text(out, output_columns[column], strlen(output_columns[column]));
+		}
+		Output_Char(out, '\n');
+	}
+	return GSL_SUCCESS;
+}
+
+
+//************************************
+// Method:    LAIPathOutput_Record	Append the results of one plot
+// FullName:  LAIPathOutput_Record
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: lai_path_output * out
+// Parameter: const lai_path_record * r
+//************************************
+void LAIPathOutput_Record(struct lai_path_output *out, const struct lai_path_record *r)
+{
+	LAI_PROFILE_SCOPE("output record");
+	Output_Key(out, COL_ID);
+	Output_String(out, r->id);
+	for (int i = 0; i < INPUT_HEADER_LINES; i++)
+	{
+		Output_Key(out, COL_GAP_FRACTION + i);
+		Output_Double(out, r->header[i]);
+	}
+	Output_Key(out, COL_N_PATH);
+	Output_Integer(out, (long long)r->nPath);
+	Output_Key(out, COL_LAIE);
+	Output_Double(out, r->LAIe);
+	Output_Key(out, COL_LAI_PATH);
+	Output_Double(out, r->LAI);
+	Output_Key(out, COL_CI);
+	Output_Double(out, r->CI);
+	Output_Key(out, COL_LAIMAX);
+	Output_Double(out, r->info.LAImax);
+	Output_Key(out, COL_MEAN_PATH);
+	Output_Double(out, r->info.meanPath);
+	Output_Key(out, COL_ITER);
+	Output_Integer(out, r->info.iter);
+	Output_Key(out, COL_N_EVAL);
+	Output_Integer(out, r->info.nEval);
+	Output_Key(out, COL_N_PATH_PROB);
+	Output_Integer(out, r->info.nPathProb);
+	Output_Key(out, COL_N_INTERVALS);
+	Output_Integer(out, r->info.nIntervals);
+	Output_Key(out, COL_MAX_INTERVALS);
+	Output_Integer(out, r->info.maxIntervals);
+	Output_Key(out, COL_BRACKET_FAIL);
+	Output_Integer(out, r->info.nBracketFail);
+	Output_Key(out, COL_FALLBACK);
+	Output_Integer(out, r->info.fallback);
+	Output_Key(out, COL_STATUS);
+	Output_Integer(out, r->status);
+	Output_Key(out, COL_GSL_ERRNO);
+	Output_Integer(out, r->gsl_errno);
+	if (out->format == OUTPUT_JSONL)
+		Output_Char(out, '}');
+	Output_Char(out, '\n');
+}
+
+
+//************************************
+// Method:    LAIPathOutput_Close	Write the buffer and close the file
+// FullName:  LAIPathOutput_Close
+// Access:    public
+// Returns:   int					GSL_SUCCESS, GSL_EFAILED (a write failed)
+// Qualifier:
+// Parameter: lai_path_output * out
+//************************************
+int LAIPathOutput_Close(struct lai_path_output *out)
+{
+	if (out->file == 0)
+		return GSL_EFAILED;
+	Output_Flush(out);
+	if (fclose(out->file) != 0)
+		out->failed = true;
+	free(out->buffer);
+	out->file = 0;
+	out->buffer = 0;
+	return out->failed ? GSL_EFAILED : GSL_SUCCESS;
+}
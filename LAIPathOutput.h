@@ -0,0 +1,54 @@
+/*!
+* \file LAIPathOutput.h
+* \date
+*			2026/10/17	Buffered results output, one CSV line or JSON object per plot
+*			2026/10/17	Numerical work of the LAImax solve (integrand evaluations, subintervals, bracket failures)
+*
+* \brief
+*		Results for scripts instead of the report of the example: one record per plot with
+*		the inputs, LAIe, LAI_PATH, CI and the LAImax solve (LAImax, mean relative path
+*		length, iterations, numerical work, status). Records are formatted into a buffer of OUTPUT_BUFFER bytes
+*		(std::to_chars, shortest round trip) and written when it is full, lines end with '\n'.
+*
+*		CSV: first line the column names, strings quoted if needed, NaN as "nan".
+*		JSON lines: one object per line, NaN as null.
+*
+*/
+
+#pragma once
+
+#include <cstdio>
+
+#include "LAIPathInput.h"
+
+#define OUTPUT_CSV			0
+#define OUTPUT_JSONL		1
+#define OUTPUT_BUFFER		(1 << 20)
+
+//results of one plot
+struct lai_path_record
+{
+	const char *id;
+	double header[INPUT_HEADER_LINES];	//INPUT_GAP_FRACTION ... INPUT_MODE
+	size_t nPath;						//path lengths (mode < 0) or frequencies
+	double LAIe;
+	double LAI;							//LAI_PATH with large gaps
+	double CI;
+	struct solver_info info;			//LAImax solve
+	int status;							//of the plot (e.g. GSL_EFAILED: input not read), or info.status
+	int gsl_errno;
+};
+
+struct lai_path_output
+{
+	FILE *file;
+	int format;						//OUTPUT_CSV or OUTPUT_JSONL
+	char *buffer;					//OUTPUT_BUFFER
+	size_t used;
+	bool failed;					//write error
+};
+
+int LAIPathOutput_Format(const char *fname);
+int LAIPathOutput_Open(struct lai_path_output *out, const char *fname, int format);
+void LAIPathOutput_Record(struct lai_path_output *out, const struct lai_path_record *r);
+int LAIPathOutput_Close(struct lai_path_output *out);
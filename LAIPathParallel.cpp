@@ -0,0 +1,154 @@
+/*!
+* \file LAIPathParallel.cpp
+* \date
+*			2026/10/17	Plot batches on the work-stealing pool
+*			2026/10/17	Histograms by PathHist, path lengths are read only
+*			2026/10/17	NaN path lengths are skipped by the maximum (PathHist_Max), a NaN chunk maximum no longer wins
+*
+*/
+
+#include <memory>
+
+#include "LAIPathParallel.h"
+#include "LaiPathSolver.h"
+#include "LAIPathProfile.h"
+#include "LAIPathCounters.h"
+
+//solver of the calling thread for each integration method, allocated at first use
+static thread_local std::unique_ptr<LaiPathSolver> t_solver[LAI_PATH_COMPARE + 1];
+
+//************************************
+// Method:    Parallel_Solver	LaiPathSolver of the calling thread
+// FullName:  Parallel_Solver
+// Access:    public
+// Returns:   LaiPathSolver &
+// Qualifier:
+// Parameter: int integration		LAI_PATH_ANALYTIC, LAI_PATH_QUADRATURE or LAI_PATH_COMPARE
+//************************************
+LaiPathSolver &Parallel_Solver(int integration)
+{
+	if (!t_solver[integration])
+		t_solver[integration].reset(new LaiPathSolver(integration));
+	return *t_solver[integration];
+}
+
+
+//************************************
+// Method:    Stat_hist_Parallel	Stat_hist_View in subtasks of STAT_HIST_SPLIT path lengths
+// FullName:  Stat_hist_Parallel
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: LaiPathPool & pool
+// Parameter: const double * data			path lengths (not modified)
+// Parameter: size_t ndata				Number of path length distribution (size of path_length_data), 64-bit for dumps over 2^32 samples
+// Parameter: gsl_histogram * out_hist		path length distribution histogram (for return)
+//************************************
+void Stat_hist_Parallel(LaiPathPool &pool, const double *data, size_t ndata, gsl_histogram *out_hist)
+{
+	LAI_PROFILE_SCOPE("Stat_hist");
+	if (ndata <= STAT_HIST_SPLIT)
+	{
+		Stat_hist_View(data, 1, ndata, out_hist);
+		return;
+	}
+
+	const size_t nChunks = (ndata + STAT_HIST_SPLIT - 1) / STAT_HIST_SPLIT;
+	std::vector<double> chunkMax(nChunks);
+	std::vector<struct path_hist_counts> chunkCounts(nChunks);
+
+	// normalize path length to [0,1]: maximum of the maxima of the chunks
+	pool.parallelFor(0, nChunks, 1, [&](size_t c0, size_t c1)
+	{
+		LaiPathCounterScope counter(COUNTER_HISTOGRAM);
+		for (size_t c = c0; c < c1; c++)
+		{
+			size_t i0 = c * STAT_HIST_SPLIT, n = GSL_MIN(ndata - i0, (size_t)STAT_HIST_SPLIT);
+			chunkMax[c] = PathHist_Max(data + i0, 1, n);
+		}
+	});
+	double maxPathLen = chunkMax[0];
+	for (size_t c = 1; c < nChunks; c++)
+		maxPathLen = GSL_MAX(maxPathLen, chunkMax[c]);
+
+	// obtain path length distribution, counts of the chunks are integers (merged exactly)
+	pool.parallelFor(0, nChunks, 1, [&](size_t c0, size_t c1)
+	{
+		LaiPathCounterScope counter(COUNTER_HISTOGRAM);
+		for (size_t c = c0; c < c1; c++)
+		{
+			size_t i0 = c * STAT_HIST_SPLIT, n = GSL_MIN(ndata - i0, (size_t)STAT_HIST_SPLIT);
+			PathHist_Alloc(&chunkCounts[c], out_hist->n, maxPathLen);
+			PathHist_Count(&chunkCounts[c], data + i0, 1, n);
+		}
+	});
+	for (size_t c = 1; c < nChunks; c++)
+	{
+		PathHist_Merge(&chunkCounts[0], &chunkCounts[c]);
+		PathHist_Free(&chunkCounts[c]);
+	}
+
+	// normalize total probability to 1
+	PathHist_Histogram(&chunkCounts[0], out_hist);
+	PathHist_Free(&chunkCounts[0]);
+}
+
+
+//************************************
+// Method:    LAI_PATH_Parallel		LAI and clumping index of plots, one task per plot
+// FullName:  LAI_PATH_Parallel
+// Access:    public
+// Returns:   size_t						number of plots with GSL errors or not solved (LAI_PATH_ZERO_PATH is solved)
+// Qualifier:
+// Parameter: LaiPathPool & pool
+// Parameter: lai_path_plot * plots			inputs, results are returned in place
+// Parameter: size_t nplots
+// Parameter: int integration				LAI_PATH_ANALYTIC, LAI_PATH_QUADRATURE or LAI_PATH_COMPARE
+//************************************
+size_t LAI_PATH_Parallel(LaiPathPool &pool, struct lai_path_plot *plots, size_t nplots, int integration)
+{
+	std::atomic<size_t> nFailed(0);
+
+	pool.parallelFor(0, nplots, 1, [&](size_t p0, size_t p1)
+	{
+		for (size_t p = p0; p < p1; p++)
+		{
+			struct lai_path_plot &plot = plots[p];
+			size_t nbins = plot.nbins ? plot.nbins : NUM_BINS;
+			struct gsl_error_state *error = LAI_PATH_ErrorState();
+
+			//oversized plots wait for subtasks, in the meantime this thread may run other plots
+			//and reuse its scratch histogram: they get their own
+			gsl_histogram *ownHist = 0;
+			if (plot.nPath > STAT_HIST_SPLIT)
+			{
+				ownHist = gsl_histogram_alloc(nbins);
+				Stat_hist_Parallel(pool, plot.pathLength, plot.nPath, ownHist);
+			}
+
+			LaiPathSolver &solver = Parallel_Solver(integration);
+			gsl_histogram *hist = ownHist;
+			error->gsl_errno = GSL_SUCCESS;
+			if (!hist)
+			{
+				hist = solver.histogram(nbins);
+				Stat_hist_View(plot.pathLength, 1, plot.nPath, hist);
+			}
+			double LAI = solver.solve(hist, plot.gapFraction, plot.zenith, plot.G);
+			plot.error = *error;
+			plot.info = solver.info();
+			if (ownHist)
+				gsl_histogram_free(ownHist);
+
+			double totalGap = plot.largeGapFraction + (1 - plot.largeGapFraction) * plot.gapFraction;
+			double LAIe = -log(totalGap) / plot.G * cos(plot.zenith * M_PI / 180);
+			plot.LAI = LAI * (1 - plot.largeGapFraction);
+			plot.CI = LAIe / plot.LAI;
+
+			if ((plot.info.status != GSL_SUCCESS && plot.info.status != LAI_PATH_ZERO_PATH) || plot.error.gsl_errno != GSL_SUCCESS)
+				nFailed++;
+		}
+	});
+
+	return nFailed;
+}
@@ -0,0 +1,47 @@
+/*!
+* \file LAIPathParallel.h
+* \date
+*			2026/10/17	Plot batches on the work-stealing pool
+*			2026/10/17	Histograms by PathHist, path lengths are read only
+*
+* \brief
+*		One task per plot: Stat_hist_View of its path lengths, then LAI_PATH with the LaiPathSolver
+*		of the executing thread. Plots with more than STAT_HIST_SPLIT path lengths build their
+*		histogram in subtasks of STAT_HIST_SPLIT path lengths.
+*
+*		Results are bit-identical to a sequential run for any number of threads: plots are
+*		independent, and bin counts of subtasks are integers (exact in any order).
+*		Path lengths are not modified.
+*
+*/
+
+#pragma once
+
+#include "LaiPathPool.h"
+#include "PathHist.h"
+
+#define STAT_HIST_SPLIT		(1 << 16)		//path lengths per Stat_hist_View subtask
+
+//one plot of input mode 1 of the example: path lengths, gap fraction and geometry
+struct lai_path_plot
+{
+	const double *pathLength;		//relative path lengths (not modified)
+	size_t nPath;
+	size_t nbins;					//0: NUM_BINS
+	double gapFraction;				//gap fraction inside canopy
+	double largeGapFraction;
+	double zenith;
+	double G;
+
+	//results
+	double LAI;						//LAI_PATH * (1 - large gap fraction)
+	double CI;						//clumping index LAIe / LAI
+	struct solver_info info;
+	struct gsl_error_state error;	//first GSL error of the plot
+};
+
+class LaiPathSolver;
+
+LaiPathSolver &Parallel_Solver(int integration = LAI_PATH_ANALYTIC);
+void Stat_hist_Parallel(LaiPathPool &pool, const double *data, size_t ndata, gsl_histogram *out_hist);
+size_t LAI_PATH_Parallel(LaiPathPool &pool, struct lai_path_plot *plots, size_t nplots, int integration = LAI_PATH_ANALYTIC);
@@ -0,0 +1,603 @@
+/*!
+* \file LAIPathPareto.cpp
+* \date
+*			2026/10/17	Accuracy / speed of the solver configurations, Pareto front (LAI_PATH_bench -pareto)
+*			2026/10/17	Exact-sample mode (LAI_PATH_Exact) by root tolerance
+*			2026/10/17	Batch_Step_* and LAI_PATH_Batch by instruction set against the scalar lanes
+*			2026/10/17	sscanf_s for the golden results
+*
+* \brief
+*		Every configuration solves the same synthetic corpus of plots:
+*			path lengths	closed form and quadrature by bins, root (epsabs) and quadrature (epsrel)
+*							tolerances; LAI_PATH_Batch by bins and instruction set; LAI_PATH_Exact
+*							(no bins) by root tolerance
+*			ellipse			LAI_PATH_Circle by root tolerance; LAI_PATH_Circle_LUT by table nodes
+*		The reference is the closed form over PARETO_REF_BINS bins with PARETO_REF_EPSABS,
+*		i.e. the path length samples themselves, and LAI_PATH_Circle with PARETO_REF_EPSABS.
+*		Throughput includes Stat_hist of the path lengths (its cost grows with the bins), or
+*		Exact_Samples.
+*		Per input family, the configurations not beaten in both plots/s and max |dLAI| by
+*		another one are the Pareto front (marked *).
+*
+*		Before, input_example1..3.txt are solved as the example does (Manifest_Solve) and
+*		compared with the results printed in input_example1..3_out.txt, and the SIMD lanes of
+*		LAI_PATH_Batch with the scalar ones (bit for bit): one Batch_Step_* of PARETO_LANES
+*		random lane states (every phase, bracket checks passed and failed, Newton steps beyond
+*		x_hi), and the corpus solved by each instruction set.
+*
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "LAIPath.h"
+#include "LAIPathCompat.h"
+#include "LAIPathBatch.h"
+#include "LAIPathBatchSimd.h"
+#include "LaiPathSolver.h"
+#include "LaiPathPool.h"
+#include "CircleLUT.h"
+#include "LAIPathManifest.h"
+#include "LAIPathBench.h"
+#include "LAIPathExact.h"
+
+#define PARETO_REF_BINS		4096
+#define PARETO_REF_EPSABS	1e-12
+#define PARETO_SHAPES		4
+#define PARETO_GOLDEN		3
+#define PARETO_LUT_FILE		"LAI_PATH_bench_lut.tmp"
+#define PARETO_MIN_TIME		0.2			//seconds, fast configurations solve the corpus repeatedly
+#define PARETO_TIE			0.01		//max |dLAI| within 1% counts as equal (Pareto_Front)
+#define PARETO_LANES		1024		//lane states of the Batch_Step_* check, multiple of 8
+
+#define PARETO_ANALYTIC		0
+#define PARETO_QUADRATURE	1
+#define PARETO_BATCH		2
+#define PARETO_EXACT		3
+#define PARETO_CIRCLE		4			//ellipse assumption from here
+#define PARETO_CIRCLE_LUT	5
+
+static const char *const pareto_methods[] = { "closed form", "quadrature", "batch", "exact", "ellipse", "ellipse LUT" };
+
+struct pareto_plot
+{
+	std::vector<double> pathLengths;
+	double gapFraction;
+	double zenith;
+	double G;
+
+	//reference, status GSL_EINVAL: not compared
+	double LAI, CI;
+	int status;
+	double circleLAI, circleCI;
+	int circleStatus;
+};
+
+struct pareto_config
+{
+	int method;
+	size_t bins;			//path lengths
+	double epsabs;
+	double epsrel;			//quadrature
+	int isa;				//batch
+	uint32_t nodes;			//ellipse LUT
+	bool isDefault;			//as the example solves it
+
+	//results
+	double seconds;
+	size_t nCompared;
+	size_t nFallback;		//LAI_MAX returned
+	double maxLAI, meanLAI;	//|LAI - reference|
+	double maxCI, meanCI;
+	bool front;
+};
+
+
+//path lengths of plot p: shape, number, gap fraction (0.03 - 0.6) and zenith drawn from its seed
+static void Pareto_Plot(size_t p, struct pareto_plot *plot)
+{
+	uint64_t state = 20261017 + p;
+	const int shape = (int)(p % PARETO_SHAPES);
+	const size_t n = (size_t)exp(log(200.0) + Bench_Uniform(&state) * log(25.0));
+	plot->gapFraction = exp(log(0.03) + Bench_Uniform(&state) * log(20.0));
+	plot->zenith = 60 * Bench_Uniform(&state);
+	plot->G = 0.5;
+
+	plot->pathLengths.resize(n);
+	for (size_t i = 0; i < n; i++)
+	{
+		double u = Bench_Uniform(&state);
+		if (shape == 1)			//long paths as input_example1.txt
+			u = GSL_MAX(u, GSL_MAX(Bench_Uniform(&state), Bench_Uniform(&state)));
+		else if (shape == 2)	//short paths
+			u = GSL_MIN(u, Bench_Uniform(&state));
+		else if (shape == 3 && Bench_Uniform(&state) < 0.2)		//path lengths close to 0
+			u *= 0.02;
+		plot->pathLengths[i] = u;
+	}
+}
+
+
+static double Pareto_LAIe(double gapFraction, double zenith, double G)
+{
+	return -log(gapFraction) / G * cos(zenith * M_PI / 180);
+}
+
+
+static void Pareto_Reference(std::vector<struct pareto_plot> &plots)
+{
+	struct lai_path_tolerance tolerance = { PARETO_REF_EPSABS, PARETO_REF_EPSABS };
+	LAI_PATH_SetTolerance(&tolerance);
+	LaiPathSolver solver(LAI_PATH_ANALYTIC);
+	gsl_histogram *h = solver.histogram(PARETO_REF_BINS);
+	for (size_t p = 0; p < plots.size(); p++)
+	{
+		struct pareto_plot &plot = plots[p];
+		Stat_hist(plot.pathLengths.data(), (unsigned long)plot.pathLengths.size(), h);
+		plot.LAI = solver.solve(h, plot.gapFraction, plot.zenith, plot.G);
+		plot.status = solver.info().status;
+		plot.CI = Pareto_LAIe(plot.gapFraction, plot.zenith, plot.G) / plot.LAI;
+
+		plot.circleLAI = solver.solveCircle(plot.gapFraction, plot.zenith, plot.G);
+		plot.circleStatus = solver.info().status;
+		plot.circleCI = Pareto_LAIe(plot.gapFraction, plot.zenith, plot.G) / plot.circleLAI;
+	}
+	LAI_PATH_SetTolerance(0);
+}
+
+
+static void Pareto_Error(struct pareto_config *c, const struct pareto_plot &plot, double LAI, int status)
+{
+	const bool ellipse = (c->method == PARETO_CIRCLE || c->method == PARETO_CIRCLE_LUT);
+	if ((ellipse ? plot.circleStatus : plot.status) == GSL_EINVAL)
+		return;
+	const double CI = Pareto_LAIe(plot.gapFraction, plot.zenith, plot.G) / LAI;
+	const double dLAI = fabs(LAI - (ellipse ? plot.circleLAI : plot.LAI));
+	const double dCI = fabs(CI - (ellipse ? plot.circleCI : plot.CI));
+	c->maxLAI = GSL_MAX(c->maxLAI, dLAI);
+	c->maxCI = GSL_MAX(c->maxCI, dCI);
+	c->meanLAI += dLAI;
+	c->meanCI += dCI;
+	c->nCompared++;
+	c->nFallback += (status == GSL_EINVAL);
+}
+
+
+//one pass over the corpus: LAI and status of the plots (for return)
+static void Pareto_Pass(const struct pareto_config *c, std::vector<struct pareto_plot> &plots, const struct circle_lut *lut,
+	std::vector<double> &LAI, std::vector<int> &status)
+{
+	const size_t nPlots = plots.size();
+	if (c->method == PARETO_ANALYTIC || c->method == PARETO_QUADRATURE)
+	{
+		LaiPathSolver solver(c->method == PARETO_ANALYTIC ? LAI_PATH_ANALYTIC : LAI_PATH_QUADRATURE);
+		gsl_histogram *h = solver.histogram(c->bins);
+		for (size_t p = 0; p < nPlots; p++)
+		{
+			Stat_hist(plots[p].pathLengths.data(), (unsigned long)plots[p].pathLengths.size(), h);
+			LAI[p] = solver.solve(h, plots[p].gapFraction, plots[p].zenith, plots[p].G);
+			status[p] = solver.info().status;
+		}
+	}
+	else if (c->method == PARETO_BATCH)
+	{
+		std::vector<double> binProb(c->bins * nPlots), gapFraction(nPlots), zenith(nPlots), G(nPlots), CI(nPlots);
+		gsl_histogram *h = gsl_histogram_alloc(c->bins);
+		for (size_t p = 0; p < nPlots; p++)
+		{
+			Stat_hist(plots[p].pathLengths.data(), (unsigned long)plots[p].pathLengths.size(), h);
+			for (size_t b = 0; b < c->bins; b++)
+				binProb[b * nPlots + p] = h->bin[b];
+			gapFraction[p] = plots[p].gapFraction;
+			zenith[p] = plots[p].zenith;
+			G[p] = plots[p].G;
+		}
+		gsl_histogram_free(h);
+
+		struct lai_path_batch in = { nPlots, c->bins, binProb.data(), gapFraction.data(), 0, zenith.data(), G.data() };
+		struct lai_path_batch_result out;
+		memset(&out, 0, sizeof(out));
+		out.LAI = LAI.data();
+		out.CI = CI.data();
+		out.status = status.data();
+		LAI_PATH_Batch(&in, &out, c->isa);
+	}
+	else if (c->method == PARETO_EXACT)
+	{
+		struct path_samples s;
+		for (size_t p = 0; p < nPlots; p++)
+		{
+			struct solver_info info;
+			Exact_Samples(plots[p].pathLengths.data(), plots[p].pathLengths.size(), &s);
+			LAI[p] = LAI_PATH_Exact(&s, plots[p].gapFraction, plots[p].zenith, plots[p].G, &info);
+			status[p] = info.status;
+		}
+	}
+	else
+	{
+		LaiPathSolver solver(LAI_PATH_ANALYTIC);
+		for (size_t p = 0; p < nPlots; p++)
+		{
+			struct solver_info info;
+			LAI[p] = (c->method == PARETO_CIRCLE_LUT)
+				? LAI_PATH_Circle_LUT(lut, plots[p].gapFraction, plots[p].zenith, plots[p].G, &info)
+				: solver.solveCircle(plots[p].gapFraction, plots[p].zenith, plots[p].G);
+			status[p] = (c->method == PARETO_CIRCLE_LUT) ? info.status : solver.info().status;
+		}
+	}
+}
+
+
+//************************************
+// Method:    Pareto_Evaluate		Solve the corpus with one configuration
+// FullName:  Pareto_Evaluate
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: pareto_config * c		configuration, results (for return)
+// Parameter: std::vector<pareto_plot> & plots	path lengths are normalized in place by Stat_hist
+// Parameter: const circle_lut * lut	PARETO_CIRCLE_LUT: table of c->nodes
+//************************************
+static void Pareto_Evaluate(struct pareto_config *c, std::vector<struct pareto_plot> &plots, const struct circle_lut *lut)
+{
+	typedef std::chrono::steady_clock clock;
+	struct lai_path_tolerance tolerance = { c->epsabs, c->epsrel };
+	LAI_PATH_SetTolerance(&tolerance);
+	c->nCompared = c->nFallback = 0;
+	c->maxLAI = c->meanLAI = c->maxCI = c->meanCI = 0;
+
+	const size_t nPlots = plots.size();
+	std::vector<double> LAI(nPlots);
+	std::vector<int> status(nPlots);
+	size_t nPasses = 0;
+	clock::time_point t0 = clock::now();
+	do
+	{
+		Pareto_Pass(c, plots, lut, LAI, status);
+		nPasses++;
+		c->seconds = std::chrono::duration<double>(clock::now() - t0).count();
+	} while (c->seconds < PARETO_MIN_TIME);
+	c->seconds /= nPasses;
+	LAI_PATH_SetTolerance(0);
+
+	for (size_t p = 0; p < nPlots; p++)
+		Pareto_Error(c, plots[p], LAI[p], status[p]);
+	if (c->nCompared)
+	{
+		c->meanLAI /= c->nCompared;
+		c->meanCI /= c->nCompared;
+	}
+}
+
+
+//configurations of the sweep, the defaults of the example marked
+static void Pareto_Configs(std::vector<struct pareto_config> &configs)
+{
+	static const size_t bins[] = { 8, 16, NUM_BINS, 50, 100, 200, 400 };
+	static const size_t quadratureBins[] = { 8, NUM_BINS };		//~100 plots/s at NUM_BINS
+	static const double epsabs[] = { 1e-2, 1e-3, LAI_PATH_EPSABS, 1e-6, 1e-8 };
+	static const double epsrel[] = { 1e-3, 1e-5, LAI_PATH_EPSREL, 1e-9 };
+	static const int isa[] = { BATCH_ISA_SCALAR, BATCH_ISA_AUTO };
+	static const uint32_t nodes[] = { 64, 256, 1024, CIRCLE_LUT_NODES, 8192 };
+
+	struct pareto_config c;
+	memset(&c, 0, sizeof(c));
+	c.epsrel = LAI_PATH_EPSREL;
+	c.isa = BATCH_ISA_AUTO;
+
+	c.method = PARETO_ANALYTIC;
+	for (size_t b = 0; b < sizeof(bins) / sizeof(bins[0]); b++)
+		for (size_t e = 0; e < sizeof(epsabs) / sizeof(epsabs[0]); e++)
+		{
+			c.bins = bins[b];
+			c.epsabs = epsabs[e];
+			c.isDefault = (c.bins == NUM_BINS && c.epsabs == LAI_PATH_EPSABS);
+			configs.push_back(c);
+		}
+
+	c.method = PARETO_QUADRATURE;
+	for (size_t b = 0; b < sizeof(quadratureBins) / sizeof(quadratureBins[0]); b++)
+		for (size_t e = 2; e < 4; e++)
+			for (size_t r = 0; r < sizeof(epsrel) / sizeof(epsrel[0]); r++)
+			{
+				c.bins = quadratureBins[b];
+				c.epsabs = epsabs[e];
+				c.epsrel = epsrel[r];
+				c.isDefault = (c.bins == NUM_BINS && c.epsabs == LAI_PATH_EPSABS && c.epsrel == LAI_PATH_EPSREL);
+				configs.push_back(c);
+			}
+	c.epsrel = LAI_PATH_EPSREL;
+
+	c.method = PARETO_BATCH;
+	c.epsabs = BATCH_EPSABS;
+	for (size_t b = 0; b < sizeof(bins) / sizeof(bins[0]); b++)
+		for (size_t i = 0; i < sizeof(isa) / sizeof(isa[0]); i++)
+		{
+			c.bins = bins[b];
+			c.isa = isa[i];
+			c.isDefault = false;
+			configs.push_back(c);
+		}
+	c.isa = BATCH_ISA_AUTO;
+
+	c.method = PARETO_EXACT;
+	c.bins = 0;
+	for (size_t e = 0; e < sizeof(epsabs) / sizeof(epsabs[0]); e++)
+	{
+		c.epsabs = epsabs[e];
+		c.isDefault = false;
+		configs.push_back(c);
+	}
+
+	c.method = PARETO_CIRCLE;
+	for (size_t e = 0; e < sizeof(epsabs) / sizeof(epsabs[0]); e++)
+	{
+		c.epsabs = epsabs[e];
+		c.isDefault = (c.epsabs == LAI_PATH_EPSABS);
+		configs.push_back(c);
+	}
+
+	c.method = PARETO_CIRCLE_LUT;
+	c.epsabs = LAI_PATH_EPSABS;
+	for (size_t n = 0; n < sizeof(nodes) / sizeof(nodes[0]); n++)
+	{
+		c.nodes = nodes[n];
+		c.isDefault = (c.nodes == CIRCLE_LUT_NODES);
+		configs.push_back(c);
+	}
+}
+
+
+//not beaten in both plots/s and max |dLAI| within its input family (ties of max |dLAI| within PARETO_TIE: the faster)
+static void Pareto_Front(std::vector<struct pareto_config> &configs)
+{
+	for (size_t i = 0; i < configs.size(); i++)
+	{
+		const bool ellipse_i = configs[i].method >= PARETO_CIRCLE;
+		configs[i].front = true;
+		for (size_t j = 0; j < configs.size() && configs[i].front; j++)
+		{
+			if (j == i || (configs[j].method >= PARETO_CIRCLE) != ellipse_i)
+				continue;
+			const bool asFast = configs[j].seconds <= configs[i].seconds;
+			const bool asGood = configs[j].maxLAI <= configs[i].maxLAI * (1 + PARETO_TIE);
+			const bool better = configs[j].maxLAI * (1 + PARETO_TIE) < configs[i].maxLAI;
+			if (asFast && asGood && (configs[j].seconds < configs[i].seconds || better))
+				configs[i].front = false;
+		}
+	}
+}
+
+
+//lanes of Batch_Step_*, arrays of batch_lanes
+struct pareto_lanes
+{
+	std::vector<double> gapFraction, x, x_prev, x_lo, x_hi, f, df, d2f, phase, hiChecked, iter;
+	std::vector<int> status;
+	struct batch_lanes l;
+};
+
+
+//random states of PARETO_LANES lanes, f, df and d2f given (Batch_fdf_* not called)
+static void Pareto_LaneStates(struct pareto_lanes *s)
+{
+	const size_t n = PARETO_LANES;
+	std::vector<double> *arrays[] = { &s->gapFraction, &s->x, &s->x_prev, &s->x_lo, &s->x_hi, &s->f, &s->df, &s->d2f,
+		&s->phase, &s->hiChecked, &s->iter };
+	for (size_t a = 0; a < sizeof(arrays) / sizeof(arrays[0]); a++)
+		arrays[a]->resize(n);
+	s->status.assign(n, GSL_CONTINUE);
+
+	uint64_t state = 20261017;
+	for (size_t k = 0; k < n; k++)
+	{
+		const double u = Bench_Uniform(&state);
+		s->phase[k] = (u < 0.1) ? BATCH_DONE : (u < 0.4) ? BATCH_CHECK_HI : BATCH_ACTIVE;
+		s->x_lo[k] = 0.1 + 5 * Bench_Uniform(&state);
+		s->x_hi[k] = s->x_lo[k] * (1.5 + 8.5 * Bench_Uniform(&state));
+		const double width = s->x_hi[k] - s->x_lo[k];
+		s->x[k] = (s->phase[k] == BATCH_CHECK_HI) ? s->x_hi[k] : s->x_lo[k] + width * Bench_Uniform(&state);
+		s->x_prev[k] = s->x_lo[k] + width * Bench_Uniform(&state);
+		s->hiChecked[k] = (s->phase[k] == BATCH_CHECK_HI || Bench_Uniform(&state) < 0.5) ? 0 : 1;
+		s->iter[k] = floor(BATCH_MAX_ITER * Bench_Uniform(&state));
+
+		//f - gap fraction: 0 (root), or Newton steps of up to twice the bracket either way; df > 0 in 10%
+		s->gapFraction[k] = 0.05 + 0.5 * Bench_Uniform(&state);
+		s->df[k] = -(0.05 + Bench_Uniform(&state)) * ((Bench_Uniform(&state) < 0.9) ? 1 : -1);
+		s->d2f[k] = Bench_Uniform(&state);
+		const double delta = (Bench_Uniform(&state) < 0.1) ? 0 : 2 * (Bench_Uniform(&state) - 0.5) * fabs(s->df[k]) * width;
+		s->f[k] = s->gapFraction[k] + delta;
+	}
+
+	memset(&s->l, 0, sizeof(s->l));
+	s->l.nplots = n;
+	s->l.gapFraction = s->gapFraction.data();
+	s->l.x = s->x.data();			s->l.x_prev = s->x_prev.data();
+	s->l.x_lo = s->x_lo.data();		s->l.x_hi = s->x_hi.data();
+	s->l.f = s->f.data();			s->l.df = s->df.data();			s->l.d2f = s->d2f.data();
+	s->l.phase = s->phase.data();	s->l.hiChecked = s->hiChecked.data();	s->l.iter = s->iter.data();
+	s->l.status = s->status.data();
+}
+
+
+//lanes whose state differs after the step
+static size_t Pareto_LanesDiffer(const struct pareto_lanes &a, const struct pareto_lanes &b)
+{
+	size_t nDiffer = 0;
+	for (size_t k = 0; k < PARETO_LANES; k++)
+		nDiffer += (a.x[k] != b.x[k] || a.x_prev[k] != b.x_prev[k] || a.x_lo[k] != b.x_lo[k] || a.x_hi[k] != b.x_hi[k]
+			|| a.phase[k] != b.phase[k] || a.hiChecked[k] != b.hiChecked[k] || a.iter[k] != b.iter[k] || a.status[k] != b.status[k]);
+	return nDiffer;
+}
+
+
+//SIMD lanes of LAI_PATH_Batch against the scalar ones: one step of random lane states, and the corpus
+static int Pareto_BatchIsa(std::vector<struct pareto_plot> &plots, FILE *out)
+{
+	static const char *const isa_names[] = { "scalar", "avx2", "avx512" };
+	const size_t nPlots = plots.size();
+	struct pareto_lanes scalar;
+	Pareto_LaneStates(&scalar);
+	size_t nActive = Batch_Step_Scalar(&scalar.l, 0, PARETO_LANES);
+
+	struct pareto_config c;
+	memset(&c, 0, sizeof(c));
+	c.method = PARETO_BATCH;
+	c.bins = NUM_BINS;
+	c.isa = BATCH_ISA_SCALAR;
+	std::vector<double> LAI(nPlots), isaLAI(nPlots);
+	std::vector<int> status(nPlots), isaStatus(nPlots);
+	Pareto_Pass(&c, plots, 0, LAI, status);
+
+	int failed = 0;
+	fprintf(out, ",\n  \"batch_isa\": [");
+	for (int isa = BATCH_ISA_AVX2; isa <= Batch_SupportedIsa(); isa++)
+	{
+		struct pareto_lanes lanes;
+		Pareto_LaneStates(&lanes);
+		size_t isaActive = (isa == BATCH_ISA_AVX512) ? Batch_Step_Avx512(&lanes.l, 0, PARETO_LANES) : Batch_Step_Avx2(&lanes.l, 0, PARETO_LANES);
+		size_t lanesDiffer = Pareto_LanesDiffer(scalar, lanes) + (isaActive != nActive);
+
+		c.isa = isa;
+		Pareto_Pass(&c, plots, 0, isaLAI, isaStatus);
+		size_t plotsDiffer = 0;
+		for (size_t p = 0; p < nPlots; p++)
+			plotsDiffer += (isaLAI[p] != LAI[p] || isaStatus[p] != status[p]);
+
+		const bool ok = (lanesDiffer == 0 && plotsDiffer == 0);
+		failed += !ok;
+		fprintf(stderr, "LAI_PATH_Batch %-6s %zu of %d lane steps, %zu of %zu plots differ from scalar  %s\n", isa_names[isa],
+			lanesDiffer, PARETO_LANES, plotsDiffer, nPlots, ok ? "ok" : "FAILED");
+		fprintf(out, "%s\n    {\"isa\": \"%s\", \"lanes\": %d, \"lanes_differ\": %zu, \"plots\": %zu, \"plots_differ\": %zu, \"ok\": %s}",
+			(isa > BATCH_ISA_AVX2) ? "," : "", isa_names[isa], PARETO_LANES, lanesDiffer, nPlots, plotsDiffer, ok ? "true" : "false");
+	}
+	fprintf(out, "\n  ]");
+	return failed ? 1 : 0;
+}
+
+
+//results of input_example<k>.txt as the example solves them, against input_example<k>_out.txt
+static int Pareto_Golden(const char *goldenDir, FILE *out)
+{
+	std::vector<struct manifest_plot> plots(PARETO_GOLDEN);
+	for (int k = 0; k < PARETO_GOLDEN; k++)
+	{
+		plots[k].id = "input_example" + std::to_string(k + 1);
+		plots[k].line = k + 1;
+		for (int i = 0; i < INPUT_HEADER_LINES; i++)
+			plots[k].header[i] = GSL_NAN;			//read from the header of the input file
+		plots[k].path = std::string(goldenDir) + "/" + plots[k].id + ".txt";
+	}
+	{
+		LaiPathPool pool;
+		Manifest_Solve(pool, plots);
+	}
+
+	int failed = 0;
+	fprintf(out, ",\n  \"golden\": [");
+	for (int k = 0; k < PARETO_GOLDEN; k++)
+	{
+		//Result: LAI_PATH = %.2f		Clumping Index = %.3f
+		double LAI = GSL_NAN, CI = GSL_NAN;
+		std::string fname = std::string(goldenDir) + "/" + plots[k].id + "_out.txt";
+		FILE *golden = 0;
+		if (fopen_s(&golden, fname.c_str(), "r") == 0)
+		{
+			char line[1024];
+			while (fgets(line, sizeof(line), golden))
+				if (sscanf_s(line, "Result: LAI_PATH = %lf Clumping Index = %lf", &LAI, &CI) == 2)
+					break;
+			fclose(golden);
+		}
+
+		const bool ok = plots[k].status != GSL_EFAILED && fabs(plots[k].LAI - LAI) <= 0.005 + 1e-9 && fabs(plots[k].CI - CI) <= 0.0005 + 1e-9;
+		failed += !ok;
+		fprintf(stderr, "%-16s LAI_PATH %.4f (expected %.2f)  CI %.4f (expected %.3f)  %s\n", plots[k].id.c_str(),
+			plots[k].LAI, LAI, plots[k].CI, CI, ok ? "ok" : "FAILED");
+		fprintf(out, "%s\n    {\"input\": \"%s\", \"LAI\": %.6f, \"LAI_expected\": %.2f, \"CI\": %.6f, \"CI_expected\": %.3f, \"ok\": %s}",
+			k ? "," : "", plots[k].id.c_str(), plots[k].LAI, LAI, plots[k].CI, CI, ok ? "true" : "false");
+	}
+	fprintf(out, "\n  ]");
+	return failed ? 1 : 0;
+}
+
+
+//************************************
+// Method:    Pareto_Run			Golden outputs and SIMD lanes, then accuracy / speed of all configurations
+// FullName:  Pareto_Run
+// Access:    public
+// Returns:   int					1: the golden outputs are not reproduced, or SIMD lanes differ from the scalar ones
+// Qualifier:
+// Parameter: size_t nPlots			plots of the synthetic corpus
+// Parameter: const char * goldenDir	directory of input_example1..3.txt and their _out.txt
+// Parameter: FILE * out			JSON
+//************************************
+int Pareto_Run(size_t nPlots, const char *goldenDir, FILE *out)
+{
+	fprintf(out, "{\n  \"version\": %d,\n  \"plots\": %zu,\n  \"reference_bins\": %d,\n  \"reference_epsabs\": %g",
+		LAI_PATH_VERSION, nPlots, PARETO_REF_BINS, PARETO_REF_EPSABS);
+	int status = Pareto_Golden(goldenDir, out);
+
+	std::vector<struct pareto_plot> plots(nPlots);
+	for (size_t p = 0; p < nPlots; p++)
+		Pareto_Plot(p, &plots[p]);
+	Pareto_Reference(plots);
+	status |= Pareto_BatchIsa(plots, out);
+
+	std::vector<struct pareto_config> configs;
+	Pareto_Configs(configs);
+	uint32_t lutNodes = 0;
+	struct circle_lut *lut = 0;
+	for (size_t i = 0; i < configs.size(); i++)
+	{
+		if (configs[i].method == PARETO_CIRCLE_LUT && configs[i].nodes != lutNodes)
+		{
+			CircleLUT_Close(lut);
+			lut = 0;
+			if (CircleLUT_Build(PARETO_LUT_FILE, configs[i].nodes, CIRCLE_LUT_T_MAX) == 0)
+				lut = CircleLUT_Open(PARETO_LUT_FILE);
+			if (lut == 0)
+				fprintf(stderr, "WARNING: could not write '%s', ellipse LUT solved directly\n", PARETO_LUT_FILE);
+			lutNodes = configs[i].nodes;
+		}
+		Pareto_Evaluate(&configs[i], plots, lut);
+	}
+	CircleLUT_Close(lut);
+	remove(PARETO_LUT_FILE);
+	Pareto_Front(configs);
+
+	fprintf(stderr, "\n%-12s %5s %8s %8s %5s %6s %10s %11s %11s %10s %10s %8s\n", "method", "bins", "epsabs", "epsrel", "isa", "nodes",
+		"plots/s", "max|dLAI|", "mean|dLAI|", "max|dCI|", "mean|dCI|", "LAI_MAX");
+	fprintf(out, ",\n  \"configs\": [");
+	for (size_t i = 0; i < configs.size(); i++)
+	{
+		const struct pareto_config &c = configs[i];
+		const double rate = nPlots / GSL_MAX(c.seconds, 1e-9);
+		const bool quadrature = (c.method == PARETO_QUADRATURE);
+		char epsrel[16] = "-";
+		if (quadrature)
+			snprintf(epsrel, sizeof(epsrel), "%.0e", c.epsrel);
+		fprintf(stderr, "%-12s %5zu %8.0e %8s %5s %6u %10.0f %11.2e %11.2e %10.2e %10.2e %8zu %s%s\n", pareto_methods[c.method], c.bins,
+			c.epsabs, epsrel,
+			(c.method == PARETO_BATCH) ? (c.isa == BATCH_ISA_SCALAR ? "scal" : "auto") : "-", c.nodes,
+			rate, c.maxLAI, c.meanLAI, c.maxCI, c.meanCI, c.nFallback, c.front ? "*" : "", c.isDefault ? " default" : "");
+		fprintf(out, "%s\n    {\"method\": \"%s\", \"bins\": %zu, \"epsabs\": %g, \"epsrel\": %g, \"isa\": %d, \"nodes\": %u, "
+			"\"plots_per_s\": %.1f, \"max_abs_dLAI\": %.3e, \"mean_abs_dLAI\": %.3e, \"max_abs_dCI\": %.3e, \"mean_abs_dCI\": %.3e, "
+			"\"compared\": %zu, \"lai_max\": %zu, \"front\": %s, \"default\": %s}",
+			i ? "," : "", pareto_methods[c.method], c.bins, c.epsabs, quadrature ? c.epsrel : 0, (c.method == PARETO_BATCH) ? c.isa : 0,
+			c.nodes, rate, c.maxLAI, c.meanLAI, c.maxCI, c.meanCI, c.nCompared, c.nFallback,
+			c.front ? "true" : "false", c.isDefault ? "true" : "false");
+	}
+	fprintf(out, "\n  ]\n}\n");
+
+	fprintf(stderr, "\nPareto front (* above), plots/s and max |dLAI| against the reference:\n");
+	for (size_t i = 0; i < configs.size(); i++)
+		if (configs[i].front)
+			fprintf(stderr, "  %-12s bins %4zu  epsabs %.0e  nodes %4u  %10.0f plots/s  max |dLAI| %.2e\n", pareto_methods[configs[i].method],
+				configs[i].bins, configs[i].epsabs, configs[i].nodes, nPlots / GSL_MAX(configs[i].seconds, 1e-9), configs[i].maxLAI);
+	return status;
+}
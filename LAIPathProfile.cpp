@@ -0,0 +1,228 @@
+/*!
+* \file LAIPathProfile.cpp
+* \date
+*			2026/10/17	Scoped phase timers, summary table and Chrome trace export
+*
+*/
+
+#include "LAIPathProfile.h"
+
+#ifdef LAI_PATH_PROFILE
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "LAIPath.h"
+#include "LAIPathCompat.h"
+
+struct profile_event
+{
+	const char *name;
+	uint64_t start;				//ns, steady clock
+	uint64_t duration;
+};
+
+struct profile_phase
+{
+	const char *name;
+	uint64_t calls;
+	uint64_t total;				//ns
+	uint64_t min;
+	uint64_t max;
+};
+
+//written by its thread only
+struct profile_thread
+{
+	unsigned id;
+	std::vector<struct profile_event> ring;		//PROFILE_RING_EVENTS
+	uint64_t nEvents;							//recorded, ring position nEvents % PROFILE_RING_EVENTS
+	struct profile_phase phase[PROFILE_PHASES];
+	size_t nPhases;
+	uint64_t nDropped;							//events of phases beyond PROFILE_PHASES
+};
+
+static std::mutex g_profileLock;
+static std::vector<std::unique_ptr<struct profile_thread> > g_profileThreads;
+
+
+static struct profile_thread *Profile_Thread()
+{
+	static thread_local struct profile_thread *t_profile = 0;
+	if (t_profile == 0)
+	{
+		std::unique_ptr<struct profile_thread> t(new profile_thread);
+		t->ring.resize(PROFILE_RING_EVENTS);
+		t->nEvents = 0;
+		t->nPhases = 0;
+		t->nDropped = 0;
+		std::lock_guard<std::mutex> guard(g_profileLock);
+		t->id = (unsigned)g_profileThreads.size();
+		t_profile = t.get();
+		g_profileThreads.push_back(std::move(t));
+	}
+	return t_profile;
+}
+
+
+//************************************
+// Method:    LAIPathProfile_Record	One timed scope of the calling thread (LaiPathProfileScope)
+// FullName:  LAIPathProfile_Record
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: const char * name		phase, string literal (compared by address first)
+// Parameter: uint64_t start			LAIPathProfile_Now() at entry
+// Parameter: uint64_t end
+//************************************
+void LAIPathProfile_Record(const char *name, uint64_t start, uint64_t end)
+{
+	struct profile_thread *t = Profile_Thread();
+	const uint64_t duration = end - start;
+
+	struct profile_event &e = t->ring[t->nEvents % PROFILE_RING_EVENTS];
+	e.name = name;
+	e.start = start;
+	e.duration = duration;
+	t->nEvents++;
+
+	size_t k = 0;
+	while (k < t->nPhases && t->phase[k].name != name && strcmp(t->phase[k].name, name) != 0)
+		k++;
+	if (k == t->nPhases)
+	{
+		if (k == PROFILE_PHASES)
+		{
+			t->nDropped++;
+			return;
+		}
+		struct profile_phase p = { name, 0, 0, UINT64_MAX, 0 };
+		t->phase[t->nPhases++] = p;
+	}
+	struct profile_phase &p = t->phase[k];
+	p.calls++;
+	p.total += duration;
+	p.min = GSL_MIN(p.min, duration);
+	p.max = GSL_MAX(p.max, duration);
+}
+
+
+//************************************
+// Method:    LAIPathProfile_Summary	Calls and time of every phase over all threads, by total time
+// FullName:  LAIPathProfile_Summary
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: FILE * out
+//************************************
+void LAIPathProfile_Summary(FILE *out)
+{
+	std::lock_guard<std::mutex> guard(g_profileLock);
+	std::vector<struct profile_phase> phases;
+	uint64_t nDropped = 0;
+	for (size_t i = 0; i < g_profileThreads.size(); i++)
+	{
+		const struct profile_thread *t = g_profileThreads[i].get();
+		nDropped += t->nDropped;
+		for (size_t k = 0; k < t->nPhases; k++)
+		{
+			const struct profile_phase &p = t->phase[k];
+			size_t j = 0;
+			while (j < phases.size() && strcmp(phases[j].name, p.name) != 0)
+				j++;
+			if (j == phases.size())
+			{
+				phases.push_back(p);
+				continue;
+			}
+			phases[j].calls += p.calls;
+			phases[j].total += p.total;
+			phases[j].min = GSL_MIN(phases[j].min, p.min);
+			phases[j].max = GSL_MAX(phases[j].max, p.max);
+		}
+	}
+	std::sort(phases.begin(), phases.end(),
+		[](const struct profile_phase &a, const struct profile_phase &b) { return a.total > b.total; });
+
+	fprintf(out, "%-24s %10s %12s %12s %12s %12s\n", "phase (inclusive)", "calls", "total ms", "mean us", "min us", "max us");
+	for (size_t j = 0; j < phases.size(); j++)
+	{
+		const struct profile_phase &p = phases[j];
+		fprintf(out, "%-24s %10llu %12.3f %12.3f %12.3f %12.3f\n", p.name, (unsigned long long)p.calls,
+			p.total * 1e-6, p.total * 1e-3 / p.calls, p.min * 1e-3, p.max * 1e-3);
+	}
+	fprintf(out, "%zu threads", g_profileThreads.size());
+	if (nDropped)
+		fprintf(out, ", %llu events of more than %d phases not counted", (unsigned long long)nDropped, PROFILE_PHASES);
+	fprintf(out, "\n");
+}
+
+
+//JSON string of a phase name
+static void Profile_Name(FILE *f, const char *name)
+{
+	fputc('"', f);
+	for (const char *c = name; *c; c++)
+	{
+		if (*c == '"' || *c == '\\')
+			fputc('\\', f);
+		if ((unsigned char)*c >= 0x20)
+			fputc(*c, f);
+	}
+	fputc('"', f);
+}
+
+
+//************************************
+// Method:    LAIPathProfile_Trace	Events kept in the rings as Chrome trace_event JSON (complete events, us)
+// FullName:  LAIPathProfile_Trace
+// Access:    public
+// Returns:   int					GSL_SUCCESS, GSL_EFAILED (cannot be written)
+// Qualifier:
+// Parameter: const char * fname
+//************************************
+int LAIPathProfile_Trace(const char *fname)
+{
+	FILE *f;
+	if (fopen_s(&f, fname, "wb") != 0)
+		return GSL_EFAILED;
+
+	std::lock_guard<std::mutex> guard(g_profileLock);
+	uint64_t origin = UINT64_MAX;
+	for (size_t i = 0; i < g_profileThreads.size(); i++)
+	{
+		const struct profile_thread *t = g_profileThreads[i].get();
+		const uint64_t n = GSL_MIN(t->nEvents, (uint64_t)PROFILE_RING_EVENTS);
+		for (uint64_t k = 0; k < n; k++)
+			origin = GSL_MIN(origin, t->ring[k].start);
+	}
+
+	fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	bool first = true;
+	for (size_t i = 0; i < g_profileThreads.size(); i++)
+	{
+		const struct profile_thread *t = g_profileThreads[i].get();
+		fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"thread %u\"}}",
+			first ? "" : ",\n", t->id, t->id);
+		first = false;
+
+		//oldest event first
+		const uint64_t n = GSL_MIN(t->nEvents, (uint64_t)PROFILE_RING_EVENTS);
+		for (uint64_t k = t->nEvents - n; k < t->nEvents; k++)
+		{
+			const struct profile_event &e = t->ring[k % PROFILE_RING_EVENTS];
+			fprintf(f, ",\n{\"name\":");
+			Profile_Name(f, e.name);
+			fprintf(f, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+				t->id, (e.start - origin) * 1e-3, e.duration * 1e-3);
+		}
+	}
+	fprintf(f, "\n]}\n");
+	return (fclose(f) == 0) ? GSL_SUCCESS : GSL_EFAILED;
+}
+
+#endif
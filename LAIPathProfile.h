@@ -0,0 +1,62 @@
+/*!
+* \file LAIPathProfile.h
+* \date
+*			2026/10/17	Scoped phase timers, summary table and Chrome trace export
+*
+* \brief
+*		Where the time of a run goes: LAI_PROFILE_SCOPE("phase") times the enclosing block
+*		(input parsing, Stat_hist, LAImax root, weighted path integral, output ...).
+*		Every thread records its scopes in its own ring of PROFILE_RING_EVENTS events and
+*		per-phase totals, without locks; LAIPathProfile_Summary prints the totals (inclusive
+*		of nested phases), LAIPathProfile_Trace writes the events as Chrome trace_event JSON
+*		(chrome://tracing, Perfetto). Export after the threads have finished their work.
+*
+*		Compiled only if LAI_PATH_PROFILE is defined (e.g. /D LAI_PATH_PROFILE, -DLAI_PATH_PROFILE),
+*		otherwise LAI_PROFILE_SCOPE is empty and nothing of this file is built.
+*
+*/
+
+#pragma once
+
+#ifdef LAI_PATH_PROFILE
+
+#include <chrono>
+#include <cstdio>
+#include <stdint.h>
+
+#define PROFILE_RING_EVENTS		65536		//events kept per thread for the trace, older ones are dropped
+#define PROFILE_PHASES			64			//phases per thread (names)
+
+#define LAI_PROFILE_CONCAT2(a, b)	a##b
+#define LAI_PROFILE_CONCAT(a, b)	LAI_PROFILE_CONCAT2(a, b)
+#define LAI_PROFILE_SCOPE(name)		LaiPathProfileScope LAI_PROFILE_CONCAT(profile_scope_, __LINE__)(name)
+
+inline uint64_t LAIPathProfile_Now()
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void LAIPathProfile_Record(const char *name, uint64_t start, uint64_t end);
+void LAIPathProfile_Summary(FILE *out);
+int LAIPathProfile_Trace(const char *fname);
+
+//times its lifetime, name: string literal
+class LaiPathProfileScope
+{
+public:
+	explicit LaiPathProfileScope(const char *name) : m_name(name), m_start(LAIPathProfile_Now()) {}
+	~LaiPathProfileScope() { LAIPathProfile_Record(m_name, m_start, LAIPathProfile_Now()); }
+
+private:
+	LaiPathProfileScope(const LaiPathProfileScope &);
+	LaiPathProfileScope &operator=(const LaiPathProfileScope &);
+
+	const char *m_name;
+	uint64_t m_start;
+};
+
+#else
+
+#define LAI_PROFILE_SCOPE(name)
+
+#endif
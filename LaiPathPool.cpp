@@ -0,0 +1,244 @@
+/*!
+* \file LaiPathPool.cpp
+* \date
+*			2026/10/17	Work-stealing thread pool for plot batches
+*			2026/10/17	Time of the tasks of other groups run in wait() (stolenTime)
+*
+*/
+
+#include <chrono>
+
+#include "LaiPathPool.h"
+
+//pool and worker index of the calling thread
+static thread_local const LaiPathPool *t_pool = 0;
+static thread_local unsigned t_index = 0;
+//group of the task run by the calling thread, ns in tasks of other groups run by wait()
+static thread_local LaiPathPool::group *t_group = 0;
+static thread_local uint64_t t_stolen = 0;
+
+
+LaiPathPool::group::group()
+	: pending(0), parent(t_group)
+{
+}
+
+
+//ancestor is g or one of its parents
+static bool LaiPathPool_IsChild(const LaiPathPool::group *g, const LaiPathPool::group *ancestor)
+{
+	for (; g; g = g->parent)
+		if (g == ancestor)
+			return true;
+	return false;
+}
+
+
+//************************************
+// Method:    LaiPathPool	Start the workers
+// FullName:  LaiPathPool::LaiPathPool
+// Access:    public
+// Qualifier:
+// Parameter: unsigned nThreads		number of workers, 0: std::thread::hardware_concurrency
+//************************************
+LaiPathPool::LaiPathPool(unsigned nThreads)
+	: m_queued(0), m_stop(false)
+{
+	if (nThreads == 0)
+		nThreads = GSL_MAX(std::thread::hardware_concurrency(), 1u);
+
+	m_oldHandler = gsl_set_error_handler(&LAI_PATH_ErrorHandler);
+
+	for (unsigned i = 0; i <= nThreads; i++)
+		m_queues.push_back(new queue);
+	for (unsigned i = 0; i < nThreads; i++)
+		m_threads.push_back(std::thread(&LaiPathPool::workerLoop, this, i));
+}
+
+
+LaiPathPool::~LaiPathPool()
+{
+	{
+		std::lock_guard<std::mutex> guard(m_sleepLock);
+		m_stop = true;
+	}
+	m_wake.notify_all();
+	for (size_t i = 0; i < m_threads.size(); i++)
+		m_threads[i].join();
+	for (size_t i = 0; i < m_queues.size(); i++)
+		delete m_queues[i];
+
+	gsl_set_error_handler(m_oldHandler);
+}
+
+
+//worker index of the calling thread, size() for threads outside the pool
+unsigned LaiPathPool::self() const
+{
+	return (t_pool == this) ? t_index : size();
+}
+
+
+//************************************
+// Method:    run	Queue a task of group g on the deque of the calling thread
+// FullName:  LaiPathPool::run
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: group & g							group of the task, see wait
+// Parameter: const std::function<void()> & task
+//************************************
+void LaiPathPool::run(group &g, const std::function<void()> &task)
+{
+	g.pending++;
+	m_queued++;
+	queue *q = m_queues[self()];
+	{
+		std::lock_guard<std::mutex> guard(q->lock);
+		struct task t = { task, &g };
+		q->tasks.push_back(t);
+	}
+
+	//lock: a worker between checking m_queued and sleeping would miss the notification
+	{
+		std::lock_guard<std::mutex> guard(m_sleepLock);
+	}
+	m_wake.notify_one();
+}
+
+
+//************************************
+// Method:    runOne	Run one task: own deque from the back, otherwise steal from the front of the others
+// FullName:  LaiPathPool::runOne
+// Access:    private
+// Returns:   bool					false: no task queued
+// Qualifier:
+// Parameter: unsigned index		worker index of the calling thread
+// Parameter: const group * waiting	group waited for by wait(), 0: worker loop
+//************************************
+bool LaiPathPool::runOne(unsigned index, const group *waiting)
+{
+	const size_t nQueues = m_queues.size();
+	struct task t;
+	bool found = false;
+
+	for (size_t k = 0; k < nQueues && !found; k++)
+	{
+		queue *q = m_queues[(index + k) % nQueues];
+		std::lock_guard<std::mutex> guard(q->lock);
+		if (q->tasks.empty())
+			continue;
+		if (k == 0)
+		{
+			t = q->tasks.back();
+			q->tasks.pop_back();
+		}
+		else
+		{
+			t = q->tasks.front();
+			q->tasks.pop_front();
+		}
+		found = true;
+	}
+	if (!found)
+		return false;
+
+	m_queued--;
+	group *outer = t_group;
+	t_group = t.g;
+	if (waiting && !LaiPathPool_IsChild(t.g, waiting))
+	{
+		//its whole time, the tasks it stole itself included (they are its own stolen time, not ours twice)
+		const uint64_t stolen = t_stolen;
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		t.fn();
+		t_stolen = stolen + (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+	}
+	else
+		t.fn();
+	t_group = outer;
+	t.g->pending--;
+	return true;
+}
+
+
+void LaiPathPool::workerLoop(unsigned index)
+{
+	t_pool = this;
+	t_index = index;
+
+	for (;;)
+	{
+		if (runOne(index, 0))
+			continue;
+
+		std::unique_lock<std::mutex> guard(m_sleepLock);
+		m_wake.wait(guard, [this] { return m_stop || m_queued > 0; });
+		if (m_stop)
+			return;
+	}
+}
+
+
+//************************************
+// Method:    wait	Run queued tasks until all tasks of group g are done
+// FullName:  LaiPathPool::wait
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: group & g
+//************************************
+void LaiPathPool::wait(group &g)
+{
+	const unsigned index = self();
+	while (g.pending > 0)
+	{
+		if (!runOne(index, &g))
+			std::this_thread::yield();
+	}
+}
+
+
+//************************************
+// Method:    stolenTime	ns the calling thread spent in wait() in tasks not of the waited group or its children
+// FullName:  LaiPathPool::stolenTime
+// Access:    public static
+// Returns:   uint64_t		increasing, differences over a task are the time it ran other work
+// Qualifier:
+//************************************
+uint64_t LaiPathPool::stolenTime()
+{
+	return t_stolen;
+}
+
+
+//************************************
+// Method:    parallelFor	body(b, e) over [begin, end), split in halves down to grain
+// FullName:  LaiPathPool::parallelFor
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: size_t begin, end
+// Parameter: size_t grain										largest range of one body call
+// Parameter: const std::function<void(size_t, size_t)> & body
+//************************************
+void LaiPathPool::parallelFor(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)> &body)
+{
+	group g;
+	std::function<void(size_t, size_t)> split = [&](size_t b, size_t e)
+	{
+		while (e - b > grain)
+		{
+			size_t mid = b + (e - b) / 2;
+			run(g, [&split, mid, e] { split(mid, e); });
+			e = mid;
+		}
+		body(b, e);
+	};
+
+	if (grain == 0)
+		grain = 1;
+	if (begin < end)
+		split(begin, end);
+	wait(g);
+}
@@ -0,0 +1,83 @@
+/*!
+* \file LaiPathPool.h
+* \date
+*			2026/10/17	Work-stealing thread pool for plot batches
+*			2026/10/17	Time of the tasks of other groups run in wait() (stolenTime)
+*
+* \brief
+*		Every worker owns a task deque: it pushes and pops its own tasks at the back (LIFO,
+*		hot in cache) and steals from the front of the others (FIFO, largest pieces first).
+*		Threads outside the pool share one extra deque. wait() executes queued tasks until
+*		its group is done, so tasks may spawn and wait for subtasks (nested parallelism)
+*		without blocking a worker.
+*
+*		A task run by wait() may belong to another group (e.g. another plot), stolenTime()
+*		is the time the calling thread spent in them, to take it out of a latency. Groups
+*		created in a task are children of its group: subtasks of a plot are not stolen.
+*
+*		The pool installs LAI_PATH_ErrorHandler, GSL errors are kept per thread
+*		(LAI_PATH_ErrorState) instead of aborting the program.
+*
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "LAIPath.h"
+
+class LaiPathPool
+{
+public:
+	//tasks run by run() and waited for by wait()
+	struct group
+	{
+		std::atomic<size_t> pending;
+		group *parent;				//group of the task that created it, 0: outside of tasks
+		group();
+	};
+
+	LaiPathPool(unsigned nThreads = 0);		//0: one worker per hardware thread
+	~LaiPathPool();
+
+	void run(group &g, const std::function<void()> &task);
+	void wait(group &g);
+	void parallelFor(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)> &body);
+
+	unsigned size() const { return (unsigned)m_threads.size(); }
+	static uint64_t stolenTime();
+
+private:
+	LaiPathPool(const LaiPathPool &);
+	LaiPathPool &operator=(const LaiPathPool &);
+
+	struct task
+	{
+		std::function<void()> fn;
+		group *g;
+	};
+	struct queue
+	{
+		std::mutex lock;
+		std::deque<task> tasks;
+	};
+
+	unsigned self() const;
+	bool runOne(unsigned index, const group *waiting);
+	void workerLoop(unsigned index);
+
+	std::vector<queue *> m_queues;			//one per worker, the last one for outside threads
+	std::vector<std::thread> m_threads;
+	std::atomic<size_t> m_queued;
+	std::mutex m_sleepLock;
+	std::condition_variable m_wake;
+	bool m_stop;
+	gsl_error_handler_t *m_oldHandler;
+};
@@ -0,0 +1,114 @@
+/*!
+* \file LaiPathSolver.cpp
+* \date
+*			2026/10/17	Reusable solver context of LAI_PATH
+*
+* \brief
+*		Workspaces are allocated once per solver and reused by every solve.
+*
+*/
+
+#include "LaiPathSolver.h"
+
+
+//************************************
+// Method:    LaiPathSolver	Allocate workspaces of the selected integration method
+// FullName:  LaiPathSolver::LaiPathSolver
+// Access:    public 
+// Qualifier:
+// Parameter: int integration			LAI_PATH_ANALYTIC, LAI_PATH_QUADRATURE or LAI_PATH_COMPARE
+// Parameter: bool warmStart			Halley iterations of solve start from the LAImax of the previous plot
+//************************************
+LaiPathSolver::LaiPathSolver(int integration, bool warmStart)
+	: m_integration(integration), m_warmStart(warmStart), m_seed(0), m_workspace(0), m_brent(0), m_hist(0), m_histCapacity(0)
+{
+	struct solver_info info = {};			//GSL_SUCCESS (0), no work
+	m_info = info;
+
+	if (m_integration != LAI_PATH_ANALYTIC)
+		m_workspace = gsl_integration_workspace_alloc(1000);
+	if (m_integration == LAI_PATH_QUADRATURE)
+		m_brent = gsl_root_fsolver_alloc(gsl_root_fsolver_brent);
+
+	histogram(NUM_BINS);
+}
+
+
+LaiPathSolver::~LaiPathSolver()
+{
+	if (m_hist)
+	{
+		m_hist->n = m_histCapacity;
+		gsl_histogram_free(m_hist);
+	}
+	if (m_brent)
+		gsl_root_fsolver_free(m_brent);
+	if (m_workspace)
+		gsl_integration_workspace_free(m_workspace);
+}
+
+
+//************************************
+// Method:    solve	LAI_PATH with the workspaces of this solver
+// FullName:  LaiPathSolver::solve
+// Access:    public 
+// Returns:   double					True LAI of Path length distribution model
+// Qualifier:
+// Parameter: gsl_histogram * pathHist	Path length distribution (Histrgram format)
+// Parameter: double gapFraction		Total gap fraction
+// Parameter: double zenith				Zenith angle (degree) of data 
+// Parameter: double G					Leaf projection function G
+//************************************
+double LaiPathSolver::solve(gsl_histogram *pathHist, double gapFraction, double zenith, double G)
+{
+	double LAI = LAI_PATH_Workspace(pathHist, gapFraction, zenith, G, m_integration, &m_info, m_workspace, m_brent,
+		m_warmStart ? m_seed : 0);
+	if (m_info.status == GSL_SUCCESS)
+		m_seed = m_info.LAImax;
+
+	return LAI;
+}
+
+
+//************************************
+// Method:    solveCircle	LAI_PATH_Circle (ellipse section assumption, no workspace needed)
+// FullName:  LaiPathSolver::solveCircle
+// Access:    public 
+// Returns:   double				True LAI
+// Qualifier:
+// Parameter: double gapFraction	Total gap fraction
+// Parameter: double zenith			Zenith angle (degree) of data 
+// Parameter: double G				Leaf projection function G
+//************************************
+double LaiPathSolver::solveCircle(double gapFraction, double zenith, double G)
+{
+	return LAI_PATH_Circle(gapFraction, zenith, G, &m_info);
+}
+
+
+//************************************
+// Method:    histogram	Scratch histogram with uniform ranges on [0, 1], reallocated only when it grows
+// FullName:  LaiPathSolver::histogram
+// Access:    public 
+// Returns:   gsl_histogram *		owned by the solver, valid until the next call
+// Qualifier:
+// Parameter: size_t nbins			number of bins
+//************************************
+gsl_histogram *LaiPathSolver::histogram(size_t nbins)
+{
+	if (nbins > m_histCapacity)
+	{
+		if (m_hist)
+		{
+			m_hist->n = m_histCapacity;
+			gsl_histogram_free(m_hist);
+		}
+		m_hist = gsl_histogram_alloc(nbins);
+		m_histCapacity = nbins;
+	}
+
+	m_hist->n = nbins;
+	gsl_histogram_set_ranges_uniform(m_hist, 0, 1);
+
+	return m_hist;
+}
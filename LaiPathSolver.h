@@ -0,0 +1,44 @@
+/*!
+* \file LaiPathSolver.h
+* \date
+*			2026/10/17	Reusable solver context of LAI_PATH
+*			2026/10/17	Warm start from the LAImax of the previous plot
+*
+* \brief
+*		One LaiPathSolver per thread owns the GSL integration workspace, the Brent solver
+*		and a scratch histogram. They are allocated once (constructor, or the first larger
+*		histogram), so solving many plots does not touch the heap.
+*
+*/
+
+#pragma once
+
+#include "LAIPath.h"
+
+class LaiPathSolver
+{
+public:
+	LaiPathSolver(int integration = LAI_PATH_ANALYTIC, bool warmStart = false);
+	~LaiPathSolver();
+
+	double solve(gsl_histogram *pathHist, double gapFraction, double zenith = 0, double G = 0.5);
+	double solveCircle(double gapFraction, double zenith = 0, double G = 0.5);
+
+	gsl_histogram *histogram(size_t nbins);						//scratch histogram, uniform ranges on [0, 1]
+	const struct solver_info &info() const { return m_info; }	//LAImax solve of the last call
+	int integration() const { return m_integration; }
+	void setWarmStart(bool warmStart) { m_warmStart = warmStart; }	//seed LAImax with the previous plot (sorted batches)
+
+private:
+	LaiPathSolver(const LaiPathSolver &);
+	LaiPathSolver &operator=(const LaiPathSolver &);
+
+	int m_integration;
+	bool m_warmStart;
+	double m_seed;						//LAImax of the last successful solve
+	gsl_integration_workspace *m_workspace;
+	gsl_root_fsolver *m_brent;
+	gsl_histogram *m_hist;
+	size_t m_histCapacity;
+	struct solver_info m_info;
+};
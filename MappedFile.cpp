@@ -0,0 +1,126 @@
+/*!
+* \file MappedFile.cpp
+* \date
+*			2026/10/17	Read-only memory mapped files (Windows / POSIX)
+*
+* \brief
+*		Files are mapped once and read in place, e.g. lookup tables and large path length files.
+*
+*/
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+//************************************
+// Method:    MappedFile_Open	Map a whole file read-only
+// FullName:  MappedFile_Open
+// Access:    public 
+// Returns:   int						0 on success, -1 if the file cannot be opened or mapped
+// Qualifier:
+// Parameter: mapped_file * mf			mapping (for return)
+// Parameter: const char * fname		file name
+//************************************
+int MappedFile_Open(struct mapped_file *mf, const char *fname)
+{
+	mf->data = 0;
+	mf->size = 0;
+	mf->hFile = 0;
+	mf->hMapping = 0;
+
+#ifdef _WIN32
+	HANDLE hFile = CreateFileA(fname, GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return -1;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(hFile, &size))
+	{
+		CloseHandle(hFile);
+		return -1;
+	}
+	mf->hFile = hFile;
+	mf->size = static_cast<size_t>(size.QuadPart);
+	if (mf->size == 0)
+		return 0;
+
+	HANDLE hMapping = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (hMapping == NULL)
+	{
+		MappedFile_Close(mf);
+		return -1;
+	}
+	mf->hMapping = hMapping;
+
+	mf->data = static_cast<const char *>(MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0));
+	if (mf->data == NULL)
+	{
+		MappedFile_Close(mf);
+		return -1;
+	}
+#else
+	int fd = open(fname, O_RDONLY);
+	if (fd < 0)
+		return -1;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0)
+	{
+		close(fd);
+		return -1;
+	}
+	mf->size = static_cast<size_t>(st.st_size);
+	if (mf->size > 0)
+	{
+		void *p = mmap(0, mf->size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (p == MAP_FAILED)
+		{
+			close(fd);
+			mf->size = 0;
+			return -1;
+		}
+		mf->data = static_cast<const char *>(p);
+	}
+	close(fd);		//the mapping stays valid
+#endif
+
+	return 0;
+}
+
+
+//************************************
+// Method:    MappedFile_Close	Unmap a file opened by MappedFile_Open
+// FullName:  MappedFile_Close
+// Access:    public 
+// Returns:   void
+// Qualifier:
+// Parameter: mapped_file * mf			mapping
+//************************************
+void MappedFile_Close(struct mapped_file *mf)
+{
+#ifdef _WIN32
+	if (mf->data)
+		UnmapViewOfFile(mf->data);
+	if (mf->hMapping)
+		CloseHandle(static_cast<HANDLE>(mf->hMapping));
+	if (mf->hFile)
+		CloseHandle(static_cast<HANDLE>(mf->hFile));
+#else
+	if (mf->data)
+		munmap(const_cast<char *>(mf->data), mf->size);
+#endif
+
+	mf->data = 0;
+	mf->size = 0;
+	mf->hFile = 0;
+	mf->hMapping = 0;
+}
@@ -0,0 +1,24 @@
+/*!
+* \file MappedFile.h
+* \date
+*			2026/10/17	Read-only memory mapped files (Windows / POSIX)
+*
+* \brief
+*		Files are mapped once and read in place, e.g. lookup tables and large path length files.
+*
+*/
+
+#pragma once
+
+#include <cstddef>
+
+struct mapped_file
+{
+	const char *data;		//first byte of the file (NULL if empty or not opened)
+	size_t size;			//size of the file in bytes
+	void *hFile;			//platform handles
+	void *hMapping;
+};
+
+int MappedFile_Open(struct mapped_file *mf, const char *fname);
+void MappedFile_Close(struct mapped_file *mf);
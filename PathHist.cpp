@@ -0,0 +1,374 @@
+/*!
+* \file PathHist.cpp
+* \date
+*			2026/10/17	Path length histograms without modifying the path lengths, AVX2 / AVX-512 bin index
+*
+*/
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "PathHist.h"
+#include "LAIPathBatchSimd.h"
+#include "LAIPathCounters.h"
+
+#define PATH_HIST_INDEX		1024		//bin indices computed before counting
+#define PATH_HIST_ROWS		4			//counters of a bin, consecutive path lengths of the same bin do not wait for each other
+#define PATH_HIST_GATHER	(1 << 28)	//largest stride of the gathers (32-bit offsets of 8 path lengths)
+
+
+//instruction set used: requested, limited to the CPU and the stride
+static int PathHist_Isa(int isa, size_t stride)
+{
+	int supported = (stride < PATH_HIST_GATHER) ? Batch_SupportedIsa() : BATCH_ISA_SCALAR;
+	return (isa == BATCH_ISA_AUTO || isa > supported) ? supported : isa;
+}
+
+
+//bin of path length d, n if outside the histogram
+static inline unsigned PathHist_Bin(const struct path_hist_counts *c, double d)
+{
+	const double *t = c->threshold;
+	if (!(d >= t[0] && d < t[c->n]))
+		return (unsigned)c->n;
+
+	double guess = d * c->scale;
+	size_t i = (guess > 0) ? (size_t)guess : 0;
+	if (i > c->n - 1)
+		i = c->n - 1;
+	if (d < t[i])
+		i--;
+	else if (d >= t[i + 1])
+		i++;
+	return (unsigned)i;
+}
+
+
+//doubles in ascending order as integers (-0 as +0)
+static inline long long PathHist_Key(double d)
+{
+	long long bits;
+	memcpy(&bits, &d, sizeof(bits));
+	return (bits >= 0) ? bits : -(bits & 0x7fffffffffffffffLL);
+}
+
+static inline double PathHist_FromKey(long long key)
+{
+	long long bits = (key >= 0) ? key : (-key | (long long)0x8000000000000000ULL);
+	double d;
+	memcpy(&d, &bits, sizeof(d));
+	return d;
+}
+
+
+//smallest d with d / maxPathLen >= r (maxPathLen > 0), the division of Stat_hist
+static double PathHist_Threshold(double r, double maxPathLen)
+{
+	//the keys span more than the range of long long
+	long long lo = PathHist_Key(-GSL_POSINF), hi = PathHist_Key(GSL_POSINF);
+	unsigned long long span = (unsigned long long)hi - (unsigned long long)lo;
+	while (span > 1)
+	{
+		long long mid = (long long)((unsigned long long)lo + span / 2);
+		if (PathHist_FromKey(mid) / maxPathLen >= r)
+			hi = mid;
+		else
+			lo = mid;
+		span = (unsigned long long)hi - (unsigned long long)lo;
+	}
+	return PathHist_FromKey(hi);
+}
+
+
+//************************************
+// Method:    PathHist_Alloc	Bins and counts of a path length histogram
+// FullName:  PathHist_Alloc
+// Access:    public
+// Returns:   int					GSL_SUCCESS, GSL_EINVAL (nbins = 0 or >= 2^31), GSL_ENOMEM
+// Qualifier:
+// Parameter: path_hist_counts * c
+// Parameter: size_t nbins
+// Parameter: double maxPathLen		path lengths are relative to it
+//************************************
+int PathHist_Alloc(struct path_hist_counts *c, size_t nbins, double maxPathLen)
+{
+	c->n = nbins;
+	c->threshold = 0;
+	c->count = 0;
+	if (nbins == 0 || nbins >= (1u << 31))
+		return GSL_EINVAL;
+
+	c->threshold = (double *)malloc((nbins + 1) * sizeof(double));
+	c->count = (unsigned long long *)malloc((nbins + 1) * sizeof(unsigned long long));
+	if (!c->threshold || !c->count)
+	{
+		PathHist_Free(c);
+		return GSL_ENOMEM;
+	}
+
+	PathHist_Reset(c, maxPathLen);
+	return GSL_SUCCESS;
+}
+
+
+void PathHist_Free(struct path_hist_counts *c)
+{
+	free(c->threshold);
+	free(c->count);
+	c->threshold = 0;
+	c->count = 0;
+}
+
+
+//************************************
+// Method:    PathHist_Reset	Clear the counts, path lengths are relative to maxPathLen from now on
+// FullName:  PathHist_Reset
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: path_hist_counts * c
+// Parameter: double maxPathLen		not positive and finite: nothing is counted
+//************************************
+void PathHist_Reset(struct path_hist_counts *c, double maxPathLen)
+{
+	const size_t n = c->n;
+	c->maxPathLen = maxPathLen;
+	c->ndata = 0;
+	memset(c->count, 0, (n + 1) * sizeof(unsigned long long));
+
+	if (!(maxPathLen > 0 && maxPathLen < GSL_POSINF))
+	{
+		c->scale = 0;
+		for (size_t i = 0; i <= n; i++)
+			c->threshold[i] = GSL_POSINF;
+		return;
+	}
+
+	//ranges as gsl_histogram_set_ranges_uniform(h, 0, 1) and Stat_hist
+	c->scale = n / maxPathLen;
+	for (size_t i = 0; i < n; i++)
+		c->threshold[i] = PathHist_Threshold((double)i / (double)n, maxPathLen);
+	c->threshold[n] = PathHist_Threshold(PATH_HIST_TOP, maxPathLen);
+}
+
+
+template <class T>
+static double PathHist_Max_Scalar(const T *data, size_t stride, size_t ndata)
+{
+	//independent maxima of 4 path lengths, comparisons are false for NaN
+	double m[4] = { -GSL_POSINF, -GSL_POSINF, -GSL_POSINF, -GSL_POSINF };
+	size_t k = 0;
+	for (; k + 4 <= ndata; k += 4)
+		for (size_t j = 0; j < 4; j++)
+		{
+			double x = data[(k + j) * stride];
+			m[j] = (x > m[j]) ? x : m[j];
+		}
+	for (; k < ndata; k++)
+	{
+		double x = data[k * stride];
+		m[0] = (x > m[0]) ? x : m[0];
+	}
+	return GSL_MAX(GSL_MAX(m[0], m[1]), GSL_MAX(m[2], m[3]));
+}
+
+
+template <class T>
+static double PathHist_Max_Dispatch(const T *data, size_t stride, size_t ndata, int isa)
+{
+	isa = PathHist_Isa(isa, stride);
+	const size_t width = (isa == BATCH_ISA_AVX512) ? 8 : (isa == BATCH_ISA_AVX2) ? 4 : 1;
+	const size_t nVector = (isa == BATCH_ISA_SCALAR) ? 0 : ndata - ndata % width;
+
+	double maxPathLen = -GSL_POSINF;
+	if (nVector && isa == BATCH_ISA_AVX512)
+		maxPathLen = PathHist_Max_Avx512(data, stride, nVector);
+	else if (nVector && isa == BATCH_ISA_AVX2)
+		maxPathLen = PathHist_Max_Avx2(data, stride, nVector);
+	return GSL_MAX(maxPathLen, PathHist_Max_Scalar(data + nVector * stride, stride, ndata - nVector));
+}
+
+
+//************************************
+// Method:    PathHist_Max	Maximum path length (NaN ignored)
+// FullName:  PathHist_Max
+// Access:    public
+// Returns:   double				-inf if there is no path length
+// Qualifier:
+// Parameter: const double * data	path lengths data[k * stride], k < ndata
+// Parameter: size_t stride
+// Parameter: size_t ndata
+// Parameter: int isa				BATCH_ISA_AUTO, or BATCH_ISA_SCALAR, _AVX2, _AVX512 (limited to the CPU)
+//************************************
+double PathHist_Max(const double *data, size_t stride, size_t ndata, int isa)
+{
+	return PathHist_Max_Dispatch(data, stride, ndata, isa);
+}
+
+double PathHist_Max(const float *data, size_t stride, size_t ndata, int isa)
+{
+	return PathHist_Max_Dispatch(data, stride, ndata, isa);
+}
+
+
+template <class T>
+static void PathHist_Count_Dispatch(struct path_hist_counts *c, const T *data, size_t stride, size_t ndata, int isa)
+{
+	isa = PathHist_Isa(isa, stride);
+	const size_t width = (isa == BATCH_ISA_AVX512) ? 8 : (isa == BATCH_ISA_AVX2) ? 4 : 1;
+	const size_t nbins = c->n + 1;
+	unsigned index[PATH_HIST_INDEX];
+	std::vector<unsigned long long> rows(PATH_HIST_ROWS * nbins);
+
+	for (size_t k0 = 0; k0 < ndata; k0 += PATH_HIST_INDEX)
+	{
+		const T *block = data + k0 * stride;
+		const size_t m = GSL_MIN(ndata - k0, (size_t)PATH_HIST_INDEX);
+		const size_t mVector = (isa == BATCH_ISA_SCALAR) ? 0 : m - m % width;
+
+		if (mVector && isa == BATCH_ISA_AVX512)
+			PathHist_Index_Avx512(c, block, stride, mVector, index);
+		else if (mVector && isa == BATCH_ISA_AVX2)
+			PathHist_Index_Avx2(c, block, stride, mVector, index);
+		for (size_t k = mVector; k < m; k++)
+			index[k] = PathHist_Bin(c, block[k * stride]);
+
+		size_t k = 0;
+		for (; k + PATH_HIST_ROWS <= m; k += PATH_HIST_ROWS)
+		{
+			rows[index[k]]++;
+			rows[nbins + index[k + 1]]++;
+			rows[2 * nbins + index[k + 2]]++;
+			rows[3 * nbins + index[k + 3]]++;
+		}
+		for (; k < m; k++)
+			rows[index[k]]++;
+	}
+
+	for (size_t i = 0; i < nbins; i++)
+		for (size_t r = 0; r < PATH_HIST_ROWS; r++)
+			c->count[i] += rows[r * nbins + i];
+	c->ndata += ndata;
+}
+
+
+//************************************
+// Method:    PathHist_Count	Add path lengths to the counts, path lengths are not modified
+// FullName:  PathHist_Count
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: path_hist_counts * c
+// Parameter: const double * data	path lengths data[k * stride], k < ndata (float: widened to double)
+// Parameter: size_t stride
+// Parameter: size_t ndata
+// Parameter: int isa				BATCH_ISA_AUTO, or BATCH_ISA_SCALAR, _AVX2, _AVX512 (limited to the CPU)
+//************************************
+void PathHist_Count(struct path_hist_counts *c, const double *data, size_t stride, size_t ndata, int isa)
+{
+	PathHist_Count_Dispatch(c, data, stride, ndata, isa);
+}
+
+void PathHist_Count(struct path_hist_counts *c, const float *data, size_t stride, size_t ndata, int isa)
+{
+	PathHist_Count_Dispatch(c, data, stride, ndata, isa);
+}
+
+
+//************************************
+// Method:    PathHist_Merge	Add the counts of src to dst
+// FullName:  PathHist_Merge
+// Access:    public
+// Returns:   int					GSL_SUCCESS, GSL_EINVAL (bins or maximum path length differ)
+// Qualifier:
+// Parameter: path_hist_counts * dst
+// Parameter: const path_hist_counts * src
+//************************************
+int PathHist_Merge(struct path_hist_counts *dst, const struct path_hist_counts *src)
+{
+	if (dst->n != src->n || dst->maxPathLen != src->maxPathLen)
+		return GSL_EINVAL;
+
+	for (size_t i = 0; i <= dst->n; i++)
+		dst->count[i] += src->count[i];
+	dst->ndata += src->ndata;
+	return GSL_SUCCESS;
+}
+
+
+//************************************
+// Method:    PathHist_Histogram	Path length distribution of the counts, as Stat_hist
+// FullName:  PathHist_Histogram
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: const path_hist_counts * c
+// Parameter: gsl_histogram * out_hist	c->n bins
+//************************************
+void PathHist_Histogram(const struct path_hist_counts *c, gsl_histogram *out_hist)
+{
+	gsl_histogram_set_ranges_uniform(out_hist, 0, 1);
+	out_hist->range[out_hist->n] = PATH_HIST_TOP;
+
+	// normalize total probability to 1
+	const double scale = static_cast<double>(out_hist->n) / c->ndata;
+	for (size_t i = 0; i < out_hist->n; i++)
+		out_hist->bin[i] = c->count[i] * scale;
+}
+
+
+template <class T>
+static void Stat_hist_View_Blocks(const T *data, size_t stride, size_t ndata, gsl_histogram *out_hist, int isa)
+{
+	LaiPathCounterScope counter(COUNTER_HISTOGRAM);
+	struct path_hist_counts c;
+	if (PathHist_Alloc(&c, out_hist->n, -GSL_POSINF) != GSL_SUCCESS)
+	{
+		gsl_histogram_reset(out_hist);
+		return;
+	}
+
+	//blocks before recount were counted relative to a smaller maximum
+	size_t recount = 0;
+	for (size_t k0 = 0; k0 < ndata; k0 += PATH_HIST_BLOCK)
+	{
+		const T *block = data + k0 * stride;
+		const size_t m = GSL_MIN(ndata - k0, (size_t)PATH_HIST_BLOCK);
+		double blockMax = PathHist_Max(block, stride, m, isa);
+		if (blockMax > c.maxPathLen)
+		{
+			PathHist_Reset(&c, blockMax);
+			recount = k0;
+		}
+		PathHist_Count(&c, block, stride, m, isa);
+	}
+	for (size_t k0 = 0; k0 < recount; k0 += PATH_HIST_BLOCK)
+		PathHist_Count(&c, data + k0 * stride, stride, GSL_MIN(recount - k0, (size_t)PATH_HIST_BLOCK), isa);
+
+	PathHist_Histogram(&c, out_hist);
+	PathHist_Free(&c);
+}
+
+
+//************************************
+// Method:    Stat_hist_View	Stat_hist in one pass, path lengths are not modified
+// FullName:  Stat_hist_View
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: const double * data		path lengths data[k * stride], k < ndata (float: widened to double)
+// Parameter: size_t stride
+// Parameter: size_t ndata
+// Parameter: gsl_histogram * out_hist	path length distribution histogram (for return)
+// Parameter: int isa					BATCH_ISA_AUTO, or BATCH_ISA_SCALAR, _AVX2, _AVX512 (limited to the CPU)
+//************************************
+void Stat_hist_View(const double *data, size_t stride, size_t ndata, gsl_histogram *out_hist, int isa)
+{
+	Stat_hist_View_Blocks(data, stride, ndata, out_hist, isa);
+}
+
+void Stat_hist_View(const float *data, size_t stride, size_t ndata, gsl_histogram *out_hist, int isa)
+{
+	Stat_hist_View_Blocks(data, stride, ndata, out_hist, isa);
+}
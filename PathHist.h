@@ -0,0 +1,69 @@
+/*!
+* \file PathHist.h
+* \date
+*			2026/10/17	Path length histograms without modifying the path lengths, AVX2 / AVX-512 bin index
+*			2026/10/17	NaN path lengths are skipped by the maximum: gsl_stats_max of Stat_hist returned NaN,
+*						then every path length was NaN and no bin was counted
+*
+* \brief
+*		Stat_hist divides the path lengths by their maximum in place, then searches the bin of
+*		every path length (gsl_histogram_increment). Here the path lengths are read only
+*		(double or float, any stride) and the bin is computed without division: for every
+*		range r of Stat_hist (gsl_histogram_set_ranges_uniform(0, 1), r[n] = 1 + 1e-6) the
+*		smallest path length t with t / maxPathLen >= r (in double) is found by bisection once
+*		per maximum. The bin of a path length d is i = (int)(d * n / maxPathLen), corrected by
+*		one bin against these thresholds, and equals the bin of Stat_hist.
+*
+*		Counts are integers in path_hist_counts: partial counts of the same maximum (e.g. one
+*		per thread) are merged exactly in any order. Stat_hist_View scans blocks of
+*		PATH_HIST_BLOCK path lengths once, maximum and counts together; blocks counted
+*		before the final maximum was found are counted again at the end.
+*
+*		Path lengths that are NaN are ignored by the maximum. Path lengths outside the
+*		histogram (NaN, < 0) are not counted, but normalize as in Stat_hist (n / ndata).
+*		Nothing is counted if the maximum is not positive and finite.
+*
+*/
+
+#pragma once
+
+#include "LAIPath.h"
+#include "LAIPathBatch.h"
+
+#define PATH_HIST_BLOCK		(1 << 14)		//path lengths per block of Stat_hist_View (in L2 cache)
+#define PATH_HIST_TOP		(1 + 1e-6)		//upper range of the last bin, as Stat_hist
+
+//bin counts of path lengths relative to maxPathLen
+struct path_hist_counts
+{
+	size_t n;						//number of bins
+	double maxPathLen;				//path lengths are relative to it
+	double scale;					//n / maxPathLen, initial guess of the bin
+	double *threshold;				//n + 1, smallest path length of every bin, threshold[n]: first one above the histogram
+	unsigned long long ndata;		//path lengths seen, counted or not
+	unsigned long long *count;		//n + 1, count[n]: path lengths outside the histogram
+};
+
+int PathHist_Alloc(struct path_hist_counts *c, size_t nbins, double maxPathLen);
+void PathHist_Free(struct path_hist_counts *c);
+void PathHist_Reset(struct path_hist_counts *c, double maxPathLen);
+
+double PathHist_Max(const double *data, size_t stride, size_t ndata, int isa = BATCH_ISA_AUTO);
+double PathHist_Max(const float *data, size_t stride, size_t ndata, int isa = BATCH_ISA_AUTO);
+void PathHist_Count(struct path_hist_counts *c, const double *data, size_t stride, size_t ndata, int isa = BATCH_ISA_AUTO);
+void PathHist_Count(struct path_hist_counts *c, const float *data, size_t stride, size_t ndata, int isa = BATCH_ISA_AUTO);
+int PathHist_Merge(struct path_hist_counts *dst, const struct path_hist_counts *src);
+void PathHist_Histogram(const struct path_hist_counts *c, gsl_histogram *out_hist);
+
+void Stat_hist_View(const double *data, size_t stride, size_t ndata, gsl_histogram *out_hist, int isa = BATCH_ISA_AUTO);
+void Stat_hist_View(const float *data, size_t stride, size_t ndata, gsl_histogram *out_hist, int isa = BATCH_ISA_AUTO);
+
+//kernels of PathHistSimd.cpp: bin index of data[k * stride], k < ndata (index n: outside)
+void PathHist_Index_Avx2(const struct path_hist_counts *c, const double *data, size_t stride, size_t ndata, unsigned *index);
+void PathHist_Index_Avx2(const struct path_hist_counts *c, const float *data, size_t stride, size_t ndata, unsigned *index);
+void PathHist_Index_Avx512(const struct path_hist_counts *c, const double *data, size_t stride, size_t ndata, unsigned *index);
+void PathHist_Index_Avx512(const struct path_hist_counts *c, const float *data, size_t stride, size_t ndata, unsigned *index);
+double PathHist_Max_Avx2(const double *data, size_t stride, size_t ndata);
+double PathHist_Max_Avx2(const float *data, size_t stride, size_t ndata);
+double PathHist_Max_Avx512(const double *data, size_t stride, size_t ndata);
+double PathHist_Max_Avx512(const float *data, size_t stride, size_t ndata);
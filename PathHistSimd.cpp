@@ -0,0 +1,225 @@
+/*!
+* \file PathHistSimd.cpp
+* \date
+*			2026/10/17	AVX2 / AVX-512 bin index and maximum of path lengths
+*
+* \brief
+*		Same operations as PathHist_Bin of PathHist.cpp: i = (int)(d * n / maxPathLen), one bin
+*		down if d < threshold[i], one bin up if d >= threshold[i + 1]. The corrections are done
+*		in double (exact for the bin numbers), strided path lengths are gathered.
+*		ndata must be a multiple of the width.
+*
+*/
+
+#include "PathHist.h"
+#include "LAIPathBatchSimd.h"
+
+#ifdef BATCH_X86
+
+//************************************
+// Method:    PathHist_Index_Avx2	Bin indices, 4 path lengths per vector
+// FullName:  PathHist_Index_Avx2
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: const path_hist_counts * c
+// Parameter: const double * data	path lengths data[k * stride], k < ndata
+// Parameter: size_t stride			< 2^28
+// Parameter: size_t ndata			multiple of 4
+// Parameter: unsigned * index		bin of data[k * stride], c->n if outside the histogram
+//************************************
+BATCH_TARGET_AVX2 void PathHist_Index_Avx2(const struct path_hist_counts *c, const double *data, size_t stride, size_t ndata, unsigned *index)
+{
+	const __m256d scale = _mm256_set1_pd(c->scale), zero = _mm256_setzero_pd(), one = _mm256_set1_pd(1);
+	const __m256d t0 = _mm256_set1_pd(c->threshold[0]), tn = _mm256_set1_pd(c->threshold[c->n]), nv = _mm256_set1_pd((double)c->n);
+	const __m128i last = _mm_set1_epi32((int)c->n - 1);
+	const __m256i offset = _mm256_set_epi64x(3 * stride, 2 * stride, stride, 0);
+
+	for (size_t k = 0; k < ndata; k += 4)
+	{
+		__m256d d = (stride == 1) ? _mm256_loadu_pd(data + k) : _mm256_i64gather_pd(data + k * stride, offset, 8);
+		__m256d inside = _mm256_and_pd(_mm256_cmp_pd(d, t0, _CMP_GE_OQ), _mm256_cmp_pd(d, tn, _CMP_LT_OQ));
+		__m256d guess = _mm256_blendv_pd(zero, _mm256_mul_pd(d, scale), inside);
+
+		__m128i i = _mm_min_epi32(_mm256_cvttpd_epi32(guess), last);
+		__m256d lo = _mm256_i32gather_pd(c->threshold, i, 8), hi = _mm256_i32gather_pd(c->threshold + 1, i, 8);
+		__m256d bin = _mm256_cvtepi32_pd(i);
+		bin = _mm256_sub_pd(bin, _mm256_and_pd(_mm256_cmp_pd(d, lo, _CMP_LT_OQ), one));
+		bin = _mm256_add_pd(bin, _mm256_and_pd(_mm256_cmp_pd(d, hi, _CMP_GE_OQ), one));
+		bin = _mm256_blendv_pd(nv, bin, inside);
+		_mm_storeu_si128((__m128i *)(index + k), _mm256_cvttpd_epi32(bin));
+	}
+}
+
+
+BATCH_TARGET_AVX2 void PathHist_Index_Avx2(const struct path_hist_counts *c, const float *data, size_t stride, size_t ndata, unsigned *index)
+{
+	const __m256d scale = _mm256_set1_pd(c->scale), zero = _mm256_setzero_pd(), one = _mm256_set1_pd(1);
+	const __m256d t0 = _mm256_set1_pd(c->threshold[0]), tn = _mm256_set1_pd(c->threshold[c->n]), nv = _mm256_set1_pd((double)c->n);
+	const __m128i last = _mm_set1_epi32((int)c->n - 1);
+	const __m128i offset = _mm_set_epi32((int)(3 * stride), (int)(2 * stride), (int)stride, 0);
+
+	for (size_t k = 0; k < ndata; k += 4)
+	{
+		__m128 f = (stride == 1) ? _mm_loadu_ps(data + k) : _mm_i32gather_ps(data + k * stride, offset, 4);
+		__m256d d = _mm256_cvtps_pd(f);
+		__m256d inside = _mm256_and_pd(_mm256_cmp_pd(d, t0, _CMP_GE_OQ), _mm256_cmp_pd(d, tn, _CMP_LT_OQ));
+		__m256d guess = _mm256_blendv_pd(zero, _mm256_mul_pd(d, scale), inside);
+
+		__m128i i = _mm_min_epi32(_mm256_cvttpd_epi32(guess), last);
+		__m256d lo = _mm256_i32gather_pd(c->threshold, i, 8), hi = _mm256_i32gather_pd(c->threshold + 1, i, 8);
+		__m256d bin = _mm256_cvtepi32_pd(i);
+		bin = _mm256_sub_pd(bin, _mm256_and_pd(_mm256_cmp_pd(d, lo, _CMP_LT_OQ), one));
+		bin = _mm256_add_pd(bin, _mm256_and_pd(_mm256_cmp_pd(d, hi, _CMP_GE_OQ), one));
+		bin = _mm256_blendv_pd(nv, bin, inside);
+		_mm_storeu_si128((__m128i *)(index + k), _mm256_cvttpd_epi32(bin));
+	}
+}
+
+
+//largest of the 4 lanes
+BATCH_TARGET_AVX2 static double PathHist_Reduce_Avx2(__m256d m)
+{
+	double lane[4];
+	_mm256_storeu_pd(lane, m);
+	return GSL_MAX(GSL_MAX(lane[0], lane[1]), GSL_MAX(lane[2], lane[3]));
+}
+
+
+//************************************
+// Method:    PathHist_Max_Avx2	Maximum path length, 4 per vector (NaN ignored: max_pd returns the second operand)
+// FullName:  PathHist_Max_Avx2
+// Access:    public
+// Returns:   double
+// Qualifier:
+// Parameter: const double * data
+// Parameter: size_t stride			< 2^28
+// Parameter: size_t ndata			multiple of 4
+//************************************
+BATCH_TARGET_AVX2 double PathHist_Max_Avx2(const double *data, size_t stride, size_t ndata)
+{
+	const __m256i offset = _mm256_set_epi64x(3 * stride, 2 * stride, stride, 0);
+	__m256d m = _mm256_set1_pd(-GSL_POSINF);
+	for (size_t k = 0; k < ndata; k += 4)
+	{
+		__m256d d = (stride == 1) ? _mm256_loadu_pd(data + k) : _mm256_i64gather_pd(data + k * stride, offset, 8);
+		m = _mm256_max_pd(d, m);
+	}
+	return PathHist_Reduce_Avx2(m);
+}
+
+
+BATCH_TARGET_AVX2 double PathHist_Max_Avx2(const float *data, size_t stride, size_t ndata)
+{
+	const __m128i offset = _mm_set_epi32((int)(3 * stride), (int)(2 * stride), (int)stride, 0);
+	__m256d m = _mm256_set1_pd(-GSL_POSINF);
+	for (size_t k = 0; k < ndata; k += 4)
+	{
+		__m128 f = (stride == 1) ? _mm_loadu_ps(data + k) : _mm_i32gather_ps(data + k * stride, offset, 4);
+		m = _mm256_max_pd(_mm256_cvtps_pd(f), m);
+	}
+	return PathHist_Reduce_Avx2(m);
+}
+
+
+//************************************
+// Method:    PathHist_Index_Avx512	PathHist_Index_Avx2, 8 path lengths per vector
+// FullName:  PathHist_Index_Avx512
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: const path_hist_counts * c
+// Parameter: const double * data	path lengths data[k * stride], k < ndata
+// Parameter: size_t stride			< 2^28
+// Parameter: size_t ndata			multiple of 8
+// Parameter: unsigned * index		bin of data[k * stride], c->n if outside the histogram
+//************************************
+BATCH_TARGET_AVX512 void PathHist_Index_Avx512(const struct path_hist_counts *c, const double *data, size_t stride, size_t ndata, unsigned *index)
+{
+	const __m512d scale = _mm512_set1_pd(c->scale), one = _mm512_set1_pd(1);
+	const __m512d t0 = _mm512_set1_pd(c->threshold[0]), tn = _mm512_set1_pd(c->threshold[c->n]), nv = _mm512_set1_pd((double)c->n);
+	const __m256i last = _mm256_set1_epi32((int)c->n - 1);
+	const __m512i offset = _mm512_set_epi64(7 * stride, 6 * stride, 5 * stride, 4 * stride, 3 * stride, 2 * stride, stride, 0);
+
+	for (size_t k = 0; k < ndata; k += 8)
+	{
+		__m512d d = (stride == 1) ? _mm512_loadu_pd(data + k) : _mm512_i64gather_pd(offset, data + k * stride, 8);
+		__mmask8 inside = _mm512_cmp_pd_mask(d, t0, _CMP_GE_OQ) & _mm512_cmp_pd_mask(d, tn, _CMP_LT_OQ);
+		__m512d guess = _mm512_maskz_mul_pd(inside, d, scale);
+
+		__m256i i = _mm256_min_epi32(_mm512_cvttpd_epi32(guess), last);
+		__m512d lo = _mm512_i32gather_pd(i, c->threshold, 8), hi = _mm512_i32gather_pd(i, c->threshold + 1, 8);
+		__m512d bin = _mm512_cvtepi32_pd(i);
+		bin = _mm512_mask_sub_pd(bin, _mm512_cmp_pd_mask(d, lo, _CMP_LT_OQ), bin, one);
+		bin = _mm512_mask_add_pd(bin, _mm512_cmp_pd_mask(d, hi, _CMP_GE_OQ), bin, one);
+		bin = _mm512_mask_mov_pd(nv, inside, bin);
+		_mm256_storeu_si256((__m256i *)(index + k), _mm512_cvttpd_epi32(bin));
+	}
+}
+
+
+BATCH_TARGET_AVX512 void PathHist_Index_Avx512(const struct path_hist_counts *c, const float *data, size_t stride, size_t ndata, unsigned *index)
+{
+	const __m512d scale = _mm512_set1_pd(c->scale), one = _mm512_set1_pd(1);
+	const __m512d t0 = _mm512_set1_pd(c->threshold[0]), tn = _mm512_set1_pd(c->threshold[c->n]), nv = _mm512_set1_pd((double)c->n);
+	const __m256i last = _mm256_set1_epi32((int)c->n - 1);
+	const __m256i offset = _mm256_set_epi32((int)(7 * stride), (int)(6 * stride), (int)(5 * stride), (int)(4 * stride),
+		(int)(3 * stride), (int)(2 * stride), (int)stride, 0);
+
+	for (size_t k = 0; k < ndata; k += 8)
+	{
+		__m256 f = (stride == 1) ? _mm256_loadu_ps(data + k) : _mm256_i32gather_ps(data + k * stride, offset, 4);
+		__m512d d = _mm512_cvtps_pd(f);
+		__mmask8 inside = _mm512_cmp_pd_mask(d, t0, _CMP_GE_OQ) & _mm512_cmp_pd_mask(d, tn, _CMP_LT_OQ);
+		__m512d guess = _mm512_maskz_mul_pd(inside, d, scale);
+
+		__m256i i = _mm256_min_epi32(_mm512_cvttpd_epi32(guess), last);
+		__m512d lo = _mm512_i32gather_pd(i, c->threshold, 8), hi = _mm512_i32gather_pd(i, c->threshold + 1, 8);
+		__m512d bin = _mm512_cvtepi32_pd(i);
+		bin = _mm512_mask_sub_pd(bin, _mm512_cmp_pd_mask(d, lo, _CMP_LT_OQ), bin, one);
+		bin = _mm512_mask_add_pd(bin, _mm512_cmp_pd_mask(d, hi, _CMP_GE_OQ), bin, one);
+		bin = _mm512_mask_mov_pd(nv, inside, bin);
+		_mm256_storeu_si256((__m256i *)(index + k), _mm512_cvttpd_epi32(bin));
+	}
+}
+
+
+BATCH_TARGET_AVX512 double PathHist_Max_Avx512(const double *data, size_t stride, size_t ndata)
+{
+	const __m512i offset = _mm512_set_epi64(7 * stride, 6 * stride, 5 * stride, 4 * stride, 3 * stride, 2 * stride, stride, 0);
+	__m512d m = _mm512_set1_pd(-GSL_POSINF);
+	for (size_t k = 0; k < ndata; k += 8)
+	{
+		__m512d d = (stride == 1) ? _mm512_loadu_pd(data + k) : _mm512_i64gather_pd(offset, data + k * stride, 8);
+		m = _mm512_max_pd(d, m);
+	}
+	return _mm512_reduce_max_pd(m);
+}
+
+
+BATCH_TARGET_AVX512 double PathHist_Max_Avx512(const float *data, size_t stride, size_t ndata)
+{
+	const __m256i offset = _mm256_set_epi32((int)(7 * stride), (int)(6 * stride), (int)(5 * stride), (int)(4 * stride),
+		(int)(3 * stride), (int)(2 * stride), (int)stride, 0);
+	__m512d m = _mm512_set1_pd(-GSL_POSINF);
+	for (size_t k = 0; k < ndata; k += 8)
+	{
+		__m256 f = (stride == 1) ? _mm256_loadu_ps(data + k) : _mm256_i32gather_ps(data + k * stride, offset, 4);
+		m = _mm512_max_pd(_mm512_cvtps_pd(f), m);
+	}
+	return _mm512_reduce_max_pd(m);
+}
+
+#else
+
+//not x86: never called, Batch_SupportedIsa returns BATCH_ISA_SCALAR
+void PathHist_Index_Avx2(const struct path_hist_counts *, const double *, size_t, size_t, unsigned *) {}
+void PathHist_Index_Avx2(const struct path_hist_counts *, const float *, size_t, size_t, unsigned *) {}
+void PathHist_Index_Avx512(const struct path_hist_counts *, const double *, size_t, size_t, unsigned *) {}
+void PathHist_Index_Avx512(const struct path_hist_counts *, const float *, size_t, size_t, unsigned *) {}
+double PathHist_Max_Avx2(const double *, size_t, size_t) { return -GSL_POSINF; }
+double PathHist_Max_Avx2(const float *, size_t, size_t) { return -GSL_POSINF; }
+double PathHist_Max_Avx512(const double *, size_t, size_t) { return -GSL_POSINF; }
+double PathHist_Max_Avx512(const float *, size_t, size_t) { return -GSL_POSINF; }
+
+#endif
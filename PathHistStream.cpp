@@ -0,0 +1,234 @@
+/*!
+* \file PathHistStream.cpp
+* \date
+*			2026/10/17	Streaming path length histogram, constant memory and unknown maximum
+*
+*/
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "PathHistStream.h"
+#include "PathHist.h"
+
+
+//************************************
+// Method:    PathStream_Alloc	Empty streaming histogram
+// FullName:  PathStream_Alloc
+// Access:    public
+// Returns:   int				GSL_SUCCESS, GSL_EINVAL (nfine not a power of 2 >= 2), GSL_ENOMEM
+// Qualifier:
+// Parameter: path_hist_stream * s
+// Parameter: size_t nfine		fine bins, memory is 8 * nfine bytes
+//************************************
+int PathStream_Alloc(struct path_hist_stream *s, size_t nfine)
+{
+	s->nfine = nfine;
+	s->exponent = 0;
+	s->maxPathLen = -GSL_POSINF;
+	s->ndata = 0;
+	s->count = 0;
+	if (nfine < 2 || (nfine & (nfine - 1)) != 0)
+		return GSL_EINVAL;
+
+	s->count = (unsigned long long *)calloc(nfine, sizeof(unsigned long long));
+	return s->count ? GSL_SUCCESS : GSL_ENOMEM;
+}
+
+
+void PathStream_Free(struct path_hist_stream *s)
+{
+	free(s->count);
+	s->count = 0;
+}
+
+
+//double the range: fine bins 2j and 2j + 1 become bin j
+static void PathStream_Coarsen(struct path_hist_stream *s, int exponent)
+{
+	const size_t half = s->nfine / 2;
+	int log2fine = 0;
+	while (((size_t)1 << log2fine) < s->nfine)
+		log2fine++;
+
+	if (exponent - s->exponent > log2fine)
+	{
+		//everything falls into the first bin
+		unsigned long long total = 0;
+		for (size_t j = 0; j < s->nfine; j++)
+			total += s->count[j];
+		memset(s->count, 0, s->nfine * sizeof(unsigned long long));
+		s->count[0] = total;
+		s->exponent = exponent;
+		return;
+	}
+
+	for (; s->exponent < exponent; s->exponent++)
+	{
+		for (size_t j = 0; j < half; j++)
+			s->count[j] = s->count[2 * j] + s->count[2 * j + 1];
+		memset(s->count + half, 0, half * sizeof(unsigned long long));
+	}
+}
+
+
+//range of the fine bins above maxPathLen (> 0), rebinned if necessary
+static void PathStream_Grow(struct path_hist_stream *s, double maxPathLen)
+{
+	int exponent;
+	frexp(maxPathLen, &exponent);		//maxPathLen < 2^exponent
+
+	if (!(s->maxPathLen > 0))
+		s->exponent = exponent;			//only 0 counted so far: the first bin at any range
+	else if (exponent > s->exponent)
+		PathStream_Coarsen(s, exponent);
+	s->maxPathLen = maxPathLen;
+}
+
+
+template <class T>
+static void PathStream_Add_Chunk(struct path_hist_stream *s, const T *data, size_t stride, size_t ndata)
+{
+	//maximum of the chunk first, the chunk is counted in the final range of its path lengths
+	double chunkMax = -GSL_POSINF;
+	for (size_t k = 0; k < ndata; k++)
+	{
+		double d = data[k * stride];
+		if (d > chunkMax && d < GSL_POSINF)
+			chunkMax = d;
+	}
+	if (chunkMax > 0 && chunkMax > s->maxPathLen)
+		PathStream_Grow(s, chunkMax);
+	else if (chunkMax > s->maxPathLen)
+		s->maxPathLen = chunkMax;
+
+	const double perBin = ldexp((double)s->nfine, -s->exponent);		//exact, power of 2
+	const size_t last = s->nfine - 1;
+	for (size_t k = 0; k < ndata; k++)
+	{
+		double d = data[k * stride];
+		if (!(d >= 0 && d < GSL_POSINF))
+			continue;
+		size_t j = (size_t)(d * perBin);
+		s->count[GSL_MIN(j, last)]++;
+	}
+	s->ndata += ndata;
+}
+
+
+//************************************
+// Method:    PathStream_Add	Count path lengths, they are not kept
+// FullName:  PathStream_Add
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: path_hist_stream * s
+// Parameter: const double * data	path lengths data[k * stride], k < ndata (float: widened to double)
+// Parameter: size_t stride
+// Parameter: size_t ndata			chunks of PATH_STREAM_CHUNK or more rebin less often
+//************************************
+void PathStream_Add(struct path_hist_stream *s, const double *data, size_t stride, size_t ndata)
+{
+	PathStream_Add_Chunk(s, data, stride, ndata);
+}
+
+void PathStream_Add(struct path_hist_stream *s, const float *data, size_t stride, size_t ndata)
+{
+	PathStream_Add_Chunk(s, data, stride, ndata);
+}
+
+
+//************************************
+// Method:    PathStream_Merge	Add the counts of src to dst (e.g. one stream per thread)
+// FullName:  PathStream_Merge
+// Access:    public
+// Returns:   int					GSL_SUCCESS, GSL_EINVAL (fine bins differ)
+// Qualifier:
+// Parameter: path_hist_stream * dst
+// Parameter: const path_hist_stream * src
+//************************************
+int PathStream_Merge(struct path_hist_stream *dst, const struct path_hist_stream *src)
+{
+	if (dst->nfine != src->nfine)
+		return GSL_EINVAL;
+
+	if (!(src->maxPathLen > 0))
+		dst->count[0] += src->count[0];		//only 0 counted in src
+	else
+	{
+		if (src->maxPathLen > dst->maxPathLen)
+			PathStream_Grow(dst, src->maxPathLen);
+		if (src->exponent > dst->exponent)
+			PathStream_Coarsen(dst, src->exponent);
+
+		const int shift = dst->exponent - src->exponent;
+		for (size_t j = 0; j < src->nfine; j++)
+			dst->count[(shift < 64) ? (j >> shift) : 0] += src->count[j];
+	}
+	dst->maxPathLen = GSL_MAX(dst->maxPathLen, src->maxPathLen);
+	dst->ndata += src->ndata;
+	return GSL_SUCCESS;
+}
+
+
+//************************************
+// Method:    PathStream_Histogram	Path length distribution as Stat_hist, relative to the largest path length
+// FullName:  PathStream_Histogram
+// Access:    public
+// Returns:   double					bound of the difference of any bin to Stat_hist of the same path lengths
+// Qualifier:
+// Parameter: const path_hist_stream * s
+// Parameter: gsl_histogram * out_hist	path length distribution histogram (for return)
+//************************************
+double PathStream_Histogram(const struct path_hist_stream *s, gsl_histogram *out_hist)
+{
+	const size_t n = out_hist->n;
+	gsl_histogram_set_ranges_uniform(out_hist, 0, 1);
+	out_hist->range[n] = PATH_HIST_TOP;
+	if (s->ndata == 0 || !(s->maxPathLen > 0))
+		return 0;
+
+	const double maxPathLen = s->maxPathLen;
+	const double width = ldexp(1.0, s->exponent) / s->nfine;
+	std::vector<double> across(n, 0);		//counts of fine bins across the edges of each bin
+
+	for (size_t j = 0; j < s->nfine; j++)
+	{
+		const double c = (double)s->count[j];
+		if (c == 0)
+			continue;
+
+		//fine bin [a, b) in units of bins, b clipped at the largest path length
+		const double a = j * width, b = GSL_MIN((j + 1) * width, maxPathLen);
+		const double u = a / maxPathLen * n, v = b / maxPathLen * n;
+		size_t iu = GSL_MIN((size_t)u, n - 1), iv = (size_t)v;
+		if (b < maxPathLen && v == floor(v) && iv > iu)
+			iv--;		//b excluded
+		iv = GSL_MIN(iv, n - 1);
+
+		if (iu == iv || v <= u)
+		{
+			out_hist->bin[iu] += c;
+			continue;
+		}
+		for (size_t i = iu; i <= iv; i++)
+		{
+			double overlap = GSL_MIN(v, (double)(i + 1)) - GSL_MAX(u, (double)i);
+			if (i == n - 1)
+				overlap = v - GSL_MAX(u, (double)i);
+			out_hist->bin[i] += c * overlap / (v - u);
+			across[i] += c;
+		}
+	}
+
+	// normalize total probability to 1
+	const double scale = static_cast<double>(n) / s->ndata;
+	double maxError = 0;
+	for (size_t i = 0; i < n; i++)
+	{
+		out_hist->bin[i] *= scale;
+		maxError = GSL_MAX(maxError, across[i] * scale);
+	}
+	return maxError;
+}
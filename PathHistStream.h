@@ -0,0 +1,42 @@
+/*!
+* \file PathHistStream.h
+* \date
+*			2026/10/17	Streaming path length histogram, constant memory and unknown maximum
+*
+* \brief
+*		Path lengths are added in chunks and not kept. They are counted in nfine bins of
+*		width 2^exponent / nfine on [0, 2^exponent), the smallest power of 2 above the largest
+*		path length so far. When a larger path length arrives the range is doubled: pairs of
+*		fine bins are added (no path length is lost), the upper half is cleared.
+*
+*		At the end the fine bins are distributed to the bins of Stat_hist (relative to the
+*		largest path length), a fine bin across two bins is split in proportion to the
+*		overlap. The counts of these fine bins bound the difference to Stat_hist, the fine
+*		bins are at most 2 * maxPathLen / nfine wide.
+*
+*		Path lengths that are NaN or < 0 are not counted, but normalize as in Stat_hist.
+*
+*/
+
+#pragma once
+
+#include "LAIPath.h"
+
+#define PATH_STREAM_FINE	(1 << 16)		//fine bins (power of 2)
+#define PATH_STREAM_CHUNK	4096			//path lengths buffered by the callers before PathStream_Add
+
+struct path_hist_stream
+{
+	size_t nfine;					//power of 2
+	int exponent;					//fine bins cover [0, 2^exponent)
+	double maxPathLen;				//largest path length so far (-inf: none)
+	unsigned long long ndata;		//path lengths added, counted or not
+	unsigned long long *count;		//nfine
+};
+
+int PathStream_Alloc(struct path_hist_stream *s, size_t nfine = PATH_STREAM_FINE);
+void PathStream_Free(struct path_hist_stream *s);
+void PathStream_Add(struct path_hist_stream *s, const double *data, size_t stride, size_t ndata);
+void PathStream_Add(struct path_hist_stream *s, const float *data, size_t stride, size_t ndata);
+int PathStream_Merge(struct path_hist_stream *dst, const struct path_hist_stream *src);
+double PathStream_Histogram(const struct path_hist_stream *s, gsl_histogram *out_hist);
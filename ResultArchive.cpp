@@ -0,0 +1,403 @@
+/*!
+* \file ResultArchive.cpp
+* \date
+*			2026/10/17	Append-only columnar archive of plot results, mapped for reading
+*			2026/10/17	A trailer after every block: readable after a crash, readers scan back to the last valid trailer
+*
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include "ResultArchive.h"
+#include "LAIPathCompat.h"
+
+#define ARCHIVE_MAGIC		"LAIPARC"
+#define ARCHIVE_END_MAGIC	"LAIPEND"
+#define ARCHIVE_ALIGN		8			//blocks and footer start at multiples of 8 bytes
+
+#ifdef _WIN32
+#include <io.h>
+#define archive_fseek		_fseeki64
+#define archive_ftell		_ftelli64
+#define archive_truncate(f, size)	_chsize_s(_fileno(f), (long long)(size))
+#else
+#include <unistd.h>
+#define archive_fseek		fseeko
+#define archive_ftell		ftello
+#define archive_truncate(f, size)	ftruncate(fileno(f), (off_t)(size))
+#endif
+
+
+//bytes of a block of n rows, without padding
+static inline size_t Archive_BlockBytes(size_t n, size_t nbins)
+{
+	return n * (ARCHIVE_ID_BYTES + 3 * sizeof(double) + sizeof(int32_t) + nbins * sizeof(float));
+}
+
+
+//columns of a block of n rows at base
+static void Archive_Layout(const char *base, size_t n, size_t nbins, struct archive_columns *c)
+{
+	c->nRows = n;
+	c->nbins = nbins;
+	c->id = base;
+	c->LAI = reinterpret_cast<const double *>(base + n * ARCHIVE_ID_BYTES);
+	c->CI = c->LAI + n;
+	c->LAImax = c->CI + n;
+	c->status = reinterpret_cast<const int32_t *>(c->LAImax + n);
+	c->bins = reinterpret_cast<const float *>(c->status + n);
+}
+
+
+static void Archive_Write(struct result_archive *archive, const void *data, size_t bytes)
+{
+	if (bytes && fwrite(data, 1, bytes, archive->file) != bytes)
+		archive->failed = true;
+	archive->end += bytes;
+}
+
+
+static void Archive_Pad(struct result_archive *archive)
+{
+	static const char zeros[ARCHIVE_ALIGN] = { 0 };
+	Archive_Write(archive, zeros, (size_t)((ARCHIVE_ALIGN - archive->end % ARCHIVE_ALIGN) % ARCHIVE_ALIGN));
+}
+
+
+//footer of nBlocks entries and its trailer, flushed: the archive is readable up to here
+static void Archive_WriteFooter(struct result_archive *archive, const struct archive_block_index *entries, size_t nBlocks,
+	uint64_t prevTrailer)
+{
+	struct archive_trailer trailer;
+	memset(&trailer, 0, sizeof(trailer));
+	trailer.footerOffset = archive->end;
+	trailer.nBlocks = nBlocks;
+	trailer.prevTrailer = prevTrailer;
+	memcpy(trailer.magic, ARCHIVE_END_MAGIC, sizeof(ARCHIVE_END_MAGIC));
+	Archive_Write(archive, entries, nBlocks * sizeof(struct archive_block_index));
+	archive->lastTrailer = archive->end;
+	Archive_Write(archive, &trailer, sizeof(trailer));
+	if (fflush(archive->file) != 0)
+		archive->failed = true;
+}
+
+
+//first n rows of a staged block to the file, column by column
+static void Archive_WriteBlock(struct result_archive *archive, const struct archive_stage *stage, uint64_t block, size_t n)
+{
+	const size_t nbins = archive->header.nbins;
+	struct archive_columns c;
+	Archive_Layout(stage->data, ARCHIVE_BLOCK_ROWS, nbins, &c);
+
+	std::lock_guard<std::mutex> guard(archive->fileLock);
+	struct archive_block_index entry;
+	entry.offset = archive->end;
+	entry.firstRow = archive->firstRow + block * ARCHIVE_BLOCK_ROWS;
+	entry.nRows = n;
+
+	Archive_Write(archive, c.id, n * ARCHIVE_ID_BYTES);
+	Archive_Write(archive, c.LAI, n * sizeof(double));
+	Archive_Write(archive, c.CI, n * sizeof(double));
+	Archive_Write(archive, c.LAImax, n * sizeof(double));
+	Archive_Write(archive, c.status, n * sizeof(int32_t));
+	Archive_Write(archive, c.bins, n * nbins * sizeof(float));
+	Archive_Pad(archive);
+	Archive_WriteFooter(archive, &entry, 1, archive->lastTrailer);
+	archive->index.push_back(entry);
+}
+
+
+//trailer at pos and the footers of the trailers before it (index, not sorted), false if one of them is not valid
+static bool Archive_ReadChain(const char *data, size_t size, const struct archive_header *header, uint64_t pos,
+	std::vector<struct archive_block_index> &index)
+{
+	index.clear();
+	for (;;)
+	{
+		if (pos % ARCHIVE_ALIGN != 0 || pos < sizeof(struct archive_header) || pos > size - sizeof(struct archive_trailer))
+			return false;
+		const struct archive_trailer *trailer = reinterpret_cast<const struct archive_trailer *>(data + pos);
+		if (memcmp(trailer->magic, ARCHIVE_END_MAGIC, sizeof(ARCHIVE_END_MAGIC)) != 0
+			|| trailer->footerOffset % ARCHIVE_ALIGN != 0 || trailer->footerOffset < sizeof(struct archive_header)
+			|| trailer->footerOffset > pos || (pos - trailer->footerOffset) / sizeof(struct archive_block_index) != trailer->nBlocks
+			|| (pos - trailer->footerOffset) % sizeof(struct archive_block_index) != 0)
+			return false;
+
+		const struct archive_block_index *entry = reinterpret_cast<const struct archive_block_index *>(data + trailer->footerOffset);
+		for (uint64_t k = 0; k < trailer->nBlocks; k++)
+		{
+			if (entry[k].offset % ARCHIVE_ALIGN != 0 || entry[k].offset < sizeof(struct archive_header)
+				|| entry[k].nRows > header->blockRows || entry[k].offset > trailer->footerOffset
+				|| Archive_BlockBytes((size_t)entry[k].nRows, header->nbins) > trailer->footerOffset - entry[k].offset)
+				return false;
+			index.push_back(entry[k]);
+		}
+
+		//trailers before are further down the file: the chain ends
+		if (trailer->prevTrailer == 0)
+			return true;
+		if (trailer->prevTrailer >= trailer->footerOffset)
+			return false;
+		pos = trailer->prevTrailer;
+	}
+}
+
+
+//header and index by row of an archive, from the last valid trailer (a killed run leaves a partial block after it)
+static int Archive_Recover(const char *data, size_t size, std::vector<struct archive_block_index> &index, uint64_t *end)
+{
+	if (size < sizeof(struct archive_header) + sizeof(struct archive_trailer))
+		return GSL_EINVAL;
+	const struct archive_header *header = reinterpret_cast<const struct archive_header *>(data);
+	if (memcmp(header->magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0 || header->version != ARCHIVE_VERSION
+		|| header->idBytes != ARCHIVE_ID_BYTES || header->blockRows == 0)
+		return GSL_EINVAL;
+
+	for (uint64_t pos = (size - sizeof(struct archive_trailer)) / ARCHIVE_ALIGN * ARCHIVE_ALIGN;
+		pos >= sizeof(struct archive_header); pos -= ARCHIVE_ALIGN)
+		if (memcmp(data + pos + offsetof(struct archive_trailer, magic), ARCHIVE_END_MAGIC, sizeof(ARCHIVE_END_MAGIC)) == 0
+			&& Archive_ReadChain(data, size, header, pos, index))
+		{
+			std::sort(index.begin(), index.end(),
+				[](const struct archive_block_index &a, const struct archive_block_index &b) { return a.firstRow < b.firstRow; });
+			*end = pos + sizeof(struct archive_trailer);
+			return GSL_SUCCESS;
+		}
+	index.clear();
+	return GSL_EINVAL;
+}
+
+
+//header and index of an archive written before, from its last valid trailer; the partial block of a killed run
+//after it is cut off and the file is opened at the end
+static int Archive_ReadExisting(struct result_archive *archive, const char *fname, uint32_t nbins)
+{
+	struct archive_reader reader;
+	int status = ArchiveReader_Open(&reader, fname);
+	if (status == GSL_SUCCESS && (reader.header->nbins != nbins || reader.header->blockRows != ARCHIVE_BLOCK_ROWS))
+		status = GSL_EINVAL;
+	if (status == GSL_SUCCESS)
+	{
+		archive->header = *reader.header;
+		archive->index = reader.index;
+		archive->end = reader.end;
+		archive->lastTrailer = reader.end - sizeof(struct archive_trailer);
+		for (size_t k = 0; k < archive->index.size(); k++)
+			archive->firstRow = GSL_MAX(archive->firstRow, archive->index[k].firstRow + archive->index[k].nRows);
+	}
+	ArchiveReader_Close(&reader);
+	if (status != GSL_SUCCESS)
+		return status;
+
+	if (fopen_s(&archive->file, fname, "r+b") != 0 || archive_truncate(archive->file, archive->end) != 0
+		|| archive_fseek(archive->file, (long long)archive->end, SEEK_SET) != 0)
+		return GSL_EFAILED;
+	return GSL_SUCCESS;
+}
+
+
+//************************************
+// Method:    Archive_Open	Create an archive, or open one to append rows
+// FullName:  Archive_Open
+// Access:    public
+// Returns:   result_archive *		NULL if the file cannot be written, or is not an archive of nbins bins
+// Qualifier:
+// Parameter: const char * fname
+// Parameter: uint32_t nbins		bins column of every row, 0: none
+//************************************
+struct result_archive *Archive_Open(const char *fname, uint32_t nbins)
+{
+	struct result_archive *archive = new result_archive;
+	archive->end = 0;
+	archive->lastTrailer = 0;
+	archive->firstRow = 0;
+	archive->next = 0;
+	archive->failed = false;
+	for (uint64_t i = 0; i < ARCHIVE_RING; i++)
+	{
+		archive->ring[i].block = i;
+		archive->ring[i].filled = 0;
+		archive->ring[i].data = (char *)malloc(Archive_BlockBytes(ARCHIVE_BLOCK_ROWS, nbins));
+		archive->failed |= (archive->ring[i].data == 0);
+	}
+
+	int status = GSL_SUCCESS;
+	if (fopen_s(&archive->file, fname, "r+b") == 0 && archive_fseek(archive->file, 0, SEEK_END) == 0 && archive_ftell(archive->file) > 0)
+	{
+		//read through the mapping, which needs the file closed for writing
+		fclose(archive->file);
+		archive->file = 0;
+		status = Archive_ReadExisting(archive, fname, nbins);
+	}
+	else
+	{
+		if (archive->file)
+			fclose(archive->file);
+		fopen_s(&archive->file, fname, "wb");			//NULL: cannot be written, see below
+		memset(&archive->header, 0, sizeof(archive->header));
+		memcpy(archive->header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+		archive->header.version = ARCHIVE_VERSION;
+		archive->header.nbins = nbins;
+		archive->header.idBytes = ARCHIVE_ID_BYTES;
+		archive->header.blockRows = ARCHIVE_BLOCK_ROWS;
+		if (archive->file)
+		{
+			Archive_Write(archive, &archive->header, sizeof(archive->header));
+			Archive_WriteFooter(archive, 0, 0, 0);
+		}
+	}
+
+	if (archive->file == 0 || status != GSL_SUCCESS || archive->failed)
+	{
+		if (archive->file)
+			fclose(archive->file);
+		for (int i = 0; i < ARCHIVE_RING; i++)
+			free(archive->ring[i].data);
+		delete archive;
+		return 0;
+	}
+	return archive;
+}
+
+
+//************************************
+// Method:    Archive_Append	Add the results of one plot, lock-free
+// FullName:  Archive_Append
+// Access:    public
+// Returns:   uint64_t					row number of the plot in the archive
+// Qualifier:
+// Parameter: result_archive * archive
+// Parameter: const lai_path_record * r	id, LAI, CI, info.LAImax and status
+// Parameter: const gsl_histogram * hist	path length distribution, 0 or other number of bins: NaN
+//************************************
+uint64_t Archive_Append(struct result_archive *archive, const struct lai_path_record *r, const gsl_histogram *hist)
+{
+	const size_t nbins = archive->header.nbins;
+	const uint64_t slot = archive->next.fetch_add(1, std::memory_order_relaxed);
+	const uint64_t block = slot / ARCHIVE_BLOCK_ROWS;
+	const size_t row = (size_t)(slot % ARCHIVE_BLOCK_ROWS);
+
+	//the stage is free when the block ARCHIVE_RING before is written
+	struct archive_stage &stage = archive->ring[block % ARCHIVE_RING];
+	while (stage.block.load(std::memory_order_acquire) != block)
+		std::this_thread::yield();
+
+	struct archive_columns c;
+	Archive_Layout(stage.data, ARCHIVE_BLOCK_ROWS, nbins, &c);
+	char *id = const_cast<char *>(c.id) + row * ARCHIVE_ID_BYTES;
+	memset(id, 0, ARCHIVE_ID_BYTES);
+	memcpy(id, r->id, GSL_MIN(strlen(r->id), (size_t)ARCHIVE_ID_BYTES));
+	const_cast<double *>(c.LAI)[row] = r->LAI;
+	const_cast<double *>(c.CI)[row] = r->CI;
+	const_cast<double *>(c.LAImax)[row] = r->info.LAImax;
+	const_cast<int32_t *>(c.status)[row] = r->status;
+	float *bins = const_cast<float *>(c.bins) + row * nbins;
+	for (size_t i = 0; i < nbins; i++)
+		bins[i] = (hist && hist->n == nbins) ? (float)hist->bin[i] : (float)GSL_NAN;
+
+	if (stage.filled.fetch_add(1, std::memory_order_acq_rel) + 1 == ARCHIVE_BLOCK_ROWS)
+	{
+		Archive_WriteBlock(archive, &stage, block, ARCHIVE_BLOCK_ROWS);
+		stage.filled.store(0, std::memory_order_relaxed);
+		stage.block.store(block + ARCHIVE_RING, std::memory_order_release);
+	}
+	return archive->firstRow + slot;
+}
+
+
+//************************************
+// Method:    Archive_Close	Write the last rows and the footer, close the archive
+// FullName:  Archive_Close
+// Access:    public
+// Returns:   int					GSL_SUCCESS, GSL_EFAILED (a write failed)
+// Qualifier:
+// Parameter: result_archive * archive	all Archive_Append calls have returned
+//************************************
+int Archive_Close(struct result_archive *archive)
+{
+	if (archive == 0)
+		return GSL_EFAILED;
+
+	const uint64_t rows = archive->next.load();
+	if (rows % ARCHIVE_BLOCK_ROWS)
+	{
+		const uint64_t block = rows / ARCHIVE_BLOCK_ROWS;
+		Archive_WriteBlock(archive, &archive->ring[block % ARCHIVE_RING], block, (size_t)(rows % ARCHIVE_BLOCK_ROWS));
+	}
+
+	//one footer of every block: a closed archive is read without following the chain
+	std::sort(archive->index.begin(), archive->index.end(),
+		[](const struct archive_block_index &a, const struct archive_block_index &b) { return a.firstRow < b.firstRow; });
+	Archive_WriteFooter(archive, archive->index.data(), archive->index.size(), 0);
+
+	if (fclose(archive->file) != 0)
+		archive->failed = true;
+	int status = archive->failed ? GSL_EFAILED : GSL_SUCCESS;
+	for (int i = 0; i < ARCHIVE_RING; i++)
+		free(archive->ring[i].data);
+	delete archive;
+	return status;
+}
+
+
+//************************************
+// Method:    ArchiveReader_Open	Map an archive for reading, up to its last valid trailer (reader->end)
+// FullName:  ArchiveReader_Open
+// Access:    public
+// Returns:   int					GSL_SUCCESS, GSL_EFAILED (cannot be opened), GSL_EINVAL (not an archive, or no valid trailer)
+// Qualifier:
+// Parameter: archive_reader * reader
+// Parameter: const char * fname
+//************************************
+int ArchiveReader_Open(struct archive_reader *reader, const char *fname)
+{
+	reader->header = 0;
+	reader->index.clear();
+	reader->nBlocks = 0;
+	reader->nRows = 0;
+	reader->end = 0;
+	if (MappedFile_Open(&reader->file, fname) != 0)
+		return GSL_EFAILED;
+
+	int status = Archive_Recover(reader->file.data, reader->file.size, reader->index, &reader->end);
+	if (status != GSL_SUCCESS)
+		return status;
+	for (size_t k = 0; k < reader->index.size(); k++)
+		reader->nRows += reader->index[k].nRows;
+	reader->header = reinterpret_cast<const struct archive_header *>(reader->file.data);
+	reader->nBlocks = reader->index.size();
+	return GSL_SUCCESS;
+}
+
+
+//************************************
+// Method:    ArchiveReader_Block	Columns of block k, in the mapping
+// FullName:  ArchiveReader_Block
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: const archive_reader * reader
+// Parameter: uint64_t k				block, < reader->nBlocks (blocks by row number)
+// Parameter: archive_columns * columns	(for return)
+//************************************
+void ArchiveReader_Block(const struct archive_reader *reader, uint64_t k, struct archive_columns *columns)
+{
+	const struct archive_block_index &entry = reader->index[k];
+	Archive_Layout(reader->file.data + entry.offset, (size_t)entry.nRows, reader->header->nbins, columns);
+	columns->firstRow = entry.firstRow;
+}
+
+
+void ArchiveReader_Close(struct archive_reader *reader)
+{
+	MappedFile_Close(&reader->file);
+	reader->header = 0;
+	reader->index.clear();
+	reader->nBlocks = 0;
+	reader->nRows = 0;
+	reader->end = 0;
+}
@@ -0,0 +1,129 @@
+/*!
+* \file ResultArchive.h
+* \date
+*			2026/10/17	Append-only columnar archive of plot results, mapped for reading
+*			2026/10/17	A trailer after every block: readable after a crash, readers scan back to the last valid trailer
+*
+* \brief
+*		Results of many runs in one file, fixed-width columns read in place without parsing.
+*		Rows are stored in blocks of up to ARCHIVE_BLOCK_ROWS rows, column after column:
+*			id		char[ARCHIVE_ID_BYTES]	plot id, truncated, zero-padded
+*			LAI		double					LAI_PATH with large gaps
+*			CI		double					clumping index
+*			LAImax	double
+*			status	int32_t
+*			bins	float[nbins]			normalized path length distribution (NaN: other bins, mode 0), nbins may be 0
+*		A scan of one column reads only the pages of that column.
+*
+*		Binary layout (little-endian): archive_header, then blocks, footers (archive_block_index
+*		entries) and archive_trailers. Every block is followed by its index entry and a trailer
+*		chained to the trailer before (prevTrailer), flushed before the next block is written.
+*		If a run is killed, the archive keeps every complete block and may end in a partial one:
+*		readers scan back from the end of the file to the last valid trailer and follow the chain.
+*		Archive_Close writes one footer of every block, by row (prevTrailer 0), so a closed
+*		archive is read from the trailer at its end. Archive_Open cuts a partial block off and
+*		appends behind the last valid trailer; complete blocks are never changed.
+*
+*		Writers reserve rows with one atomic add (Archive_Append is lock-free, any number of
+*		threads). Rows are staged in a ring of ARCHIVE_RING blocks; the thread writing the
+*		last row of a block writes the block to the file. Writers wait only when the ring is
+*		full of blocks with rows still being written.
+*
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+#include "LAIPath.h"
+#include "LAIPathOutput.h"
+#include "MappedFile.h"
+
+#define ARCHIVE_VERSION		2
+#define ARCHIVE_ID_BYTES	32
+#define ARCHIVE_BLOCK_ROWS	4096
+#define ARCHIVE_RING		8
+
+//binary layout
+struct archive_header
+{
+	char magic[8];			//"LAIPARC"
+	uint32_t version;		//ARCHIVE_VERSION
+	uint32_t nbins;			//bins column per row
+	uint32_t idBytes;		//ARCHIVE_ID_BYTES
+	uint32_t blockRows;		//ARCHIVE_BLOCK_ROWS
+	uint64_t reserved[5];
+};
+
+struct archive_block_index
+{
+	uint64_t offset;		//first byte of the block
+	uint64_t firstRow;		//row number of its first row
+	uint64_t nRows;
+};
+
+struct archive_trailer
+{
+	uint64_t footerOffset;	//archive_block_index[nBlocks], the trailer follows them
+	uint64_t nBlocks;
+	uint64_t prevTrailer;	//trailer of the blocks before, 0: none (footer of every block)
+	char magic[8];			//"LAIPEND"
+};
+
+//rows staged before they are written
+struct archive_stage
+{
+	std::atomic<uint64_t> block;	//block staged here (ring position + k * ARCHIVE_RING)
+	std::atomic<uint32_t> filled;	//rows written
+	char *data;						//columns of ARCHIVE_BLOCK_ROWS rows
+};
+
+struct result_archive
+{
+	FILE *file;
+	struct archive_header header;
+	uint64_t end;							//file size
+	uint64_t lastTrailer;					//offset of the last trailer written
+	uint64_t firstRow;						//rows before this session
+	std::atomic<uint64_t> next;				//rows reserved in this session
+	struct archive_stage ring[ARCHIVE_RING];
+	std::mutex fileLock;					//block writes, lastTrailer and index
+	std::vector<struct archive_block_index> index;
+	bool failed;							//write error
+};
+
+//columns of a block, in the mapping (reader) or the stage (writer)
+struct archive_columns
+{
+	uint64_t firstRow;
+	size_t nRows;
+	size_t nbins;
+	const char *id;					//nRows * ARCHIVE_ID_BYTES, not terminated if the id fills it
+	const double *LAI;
+	const double *CI;
+	const double *LAImax;
+	const int32_t *status;
+	const float *bins;				//nRows * nbins
+};
+
+struct archive_reader
+{
+	struct mapped_file file;
+	const struct archive_header *header;
+	std::vector<struct archive_block_index> index;	//by row
+	uint64_t nBlocks;
+	uint64_t nRows;
+	uint64_t end;					//bytes up to the last valid trailer, the rest of the file is an interrupted run
+};
+
+struct result_archive *Archive_Open(const char *fname, uint32_t nbins);
+uint64_t Archive_Append(struct result_archive *archive, const struct lai_path_record *r, const gsl_histogram *hist = 0);
+int Archive_Close(struct result_archive *archive);
+
+int ArchiveReader_Open(struct archive_reader *reader, const char *fname);
+void ArchiveReader_Block(const struct archive_reader *reader, uint64_t k, struct archive_columns *columns);
+void ArchiveReader_Close(struct archive_reader *reader);
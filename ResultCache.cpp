@@ -0,0 +1,348 @@
+/*!
+* \file ResultCache.cpp
+* \date
+*			2026/10/17	Content-addressed cache of plot results across runs
+*			2026/10/17	Plots of the same inputs solved at the same time: the first one solves, the others wait for it
+*
+*/
+
+#include <cstdio>
+#include <cstring>
+
+#include "ResultCache.h"
+#include "LAIPathCompat.h"
+
+#define CACHE_MAGIC		"LAIPCCH"
+
+//XXH64 primes
+#define XXH_PRIME1		0x9E3779B185EBCA87ULL
+#define XXH_PRIME2		0xC2B2AE3D27D4EB4FULL
+#define XXH_PRIME3		0x165667B19E3779F9ULL
+#define XXH_PRIME4		0x85EBCA77C2B2AE63ULL
+#define XXH_PRIME5		0x27D4EB2F165667C5ULL
+
+
+static inline uint64_t Hash_Rotl(uint64_t x, int r)
+{
+	return (x << r) | (x >> (64 - r));
+}
+
+
+static inline uint64_t Hash_Read64(const unsigned char *p)
+{
+	uint64_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+
+static inline uint64_t Hash_Round(uint64_t acc, uint64_t input)
+{
+	acc += input * XXH_PRIME2;
+	return Hash_Rotl(acc, 31) * XXH_PRIME1;
+}
+
+
+static inline uint64_t Hash_Merge(uint64_t acc, uint64_t v)
+{
+	acc ^= Hash_Round(0, v);
+	return acc * XXH_PRIME1 + XXH_PRIME4;
+}
+
+
+//************************************
+// Method:    ResultCache_Hash	XXH64 of a byte string (several GB/s, not cryptographic)
+// FullName:  ResultCache_Hash
+// Access:    public
+// Returns:   uint64_t
+// Qualifier:
+// Parameter: const void * data
+// Parameter: size_t len
+// Parameter: uint64_t seed
+//************************************
+uint64_t ResultCache_Hash(const void *data, size_t len, uint64_t seed)
+{
+	const unsigned char *p = static_cast<const unsigned char *>(data);
+	const unsigned char *end = p + len;
+	uint64_t h;
+
+	if (len >= 32)
+	{
+		uint64_t v1 = seed + XXH_PRIME1 + XXH_PRIME2, v2 = seed + XXH_PRIME2, v3 = seed, v4 = seed - XXH_PRIME1;
+		for (; p + 32 <= end; p += 32)
+		{
+			v1 = Hash_Round(v1, Hash_Read64(p));
+			v2 = Hash_Round(v2, Hash_Read64(p + 8));
+			v3 = Hash_Round(v3, Hash_Read64(p + 16));
+			v4 = Hash_Round(v4, Hash_Read64(p + 24));
+		}
+		h = Hash_Rotl(v1, 1) + Hash_Rotl(v2, 7) + Hash_Rotl(v3, 12) + Hash_Rotl(v4, 18);
+		h = Hash_Merge(h, v1);
+		h = Hash_Merge(h, v2);
+		h = Hash_Merge(h, v3);
+		h = Hash_Merge(h, v4);
+	}
+	else
+		h = seed + XXH_PRIME5;
+	h += len;
+
+	for (; p + 8 <= end; p += 8)
+		h = Hash_Rotl(h ^ Hash_Round(0, Hash_Read64(p)), 27) * XXH_PRIME1 + XXH_PRIME4;
+	if (p + 4 <= end)
+	{
+		uint32_t k;
+		memcpy(&k, p, sizeof(k));
+		h = Hash_Rotl(h ^ (k * XXH_PRIME1), 23) * XXH_PRIME2 + XXH_PRIME3;
+		p += 4;
+	}
+	for (; p < end; p++)
+		h = Hash_Rotl(h ^ (*p * XXH_PRIME5), 11) * XXH_PRIME1;
+
+	h ^= h >> 33;
+	h *= XXH_PRIME2;
+	h ^= h >> 29;
+	h *= XXH_PRIME3;
+	h ^= h >> 32;
+	return h;
+}
+
+
+//************************************
+// Method:    ResultCache_Key	Key of the inputs of a plot
+// FullName:  ResultCache_Key
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: cache_entry * entry		(for return) key, header and flags, the results are cleared
+// Parameter: const double * header	INPUT_HEADER_LINES values, as used by the solve
+// Parameter: int flags				integration method | CACHE_LUT
+// Parameter: const void * content	data of the path length file, or normalized frequencies (0: mode 0)
+// Parameter: size_t bytes
+//************************************
+void ResultCache_Key(struct cache_entry *entry, const double *header, int flags, const void *content, size_t bytes)
+{
+	memset(entry, 0, sizeof(*entry));
+	memcpy(entry->header, header, sizeof(entry->header));
+	entry->flags = flags;
+
+	struct
+	{
+		uint64_t libVersion;
+		uint64_t flags;
+		uint64_t bytes;
+		uint64_t content;
+		double header[INPUT_HEADER_LINES];
+	} key;
+	key.libVersion = LAI_PATH_VERSION;
+	key.flags = (uint64_t)flags;
+	key.bytes = bytes;
+	key.content = ResultCache_Hash(content, content ? bytes : 0);
+	memcpy(key.header, header, sizeof(key.header));
+	entry->key = ResultCache_Hash(&key, sizeof(key), LAI_PATH_VERSION);
+}
+
+
+//************************************
+// Method:    ResultCache_Open	Map the cache file of the previous runs
+// FullName:  ResultCache_Open
+// Access:    public
+// Returns:   result_cache *		(never NULL) a missing, outdated or truncated file gives an empty cache, rewritten at close
+// Qualifier:
+// Parameter: const char * fname
+//************************************
+struct result_cache *ResultCache_Open(const char *fname)
+{
+	struct result_cache *cache = new result_cache;
+	cache->fname = fname;
+	cache->stored = 0;
+	cache->rewrite = true;
+	cache->memoryHits = 0;
+	cache->fileHits = 0;
+	cache->misses = 0;
+	memset(&cache->file, 0, sizeof(cache->file));
+
+	if (MappedFile_Open(&cache->file, fname) != 0)
+		return cache;
+	const struct cache_file_header *header = reinterpret_cast<const struct cache_file_header *>(cache->file.data);
+	if (cache->file.size < sizeof(struct cache_file_header) || memcmp(header->magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0
+		|| header->version != CACHE_VERSION || header->libVersion != LAI_PATH_VERSION || header->entryBytes != sizeof(struct cache_entry)
+		|| (cache->file.size - sizeof(struct cache_file_header)) % sizeof(struct cache_entry) != 0)
+	{
+		MappedFile_Close(&cache->file);
+		return cache;
+	}
+
+	cache->rewrite = false;
+	cache->stored = reinterpret_cast<const struct cache_entry *>(cache->file.data + sizeof(struct cache_file_header));
+	const size_t nStored = (cache->file.size - sizeof(struct cache_file_header)) / sizeof(struct cache_entry);
+	cache->index.reserve(nStored);
+	for (size_t i = 0; i < nStored; i++)
+		cache->index[cache->stored[i].key] = i;
+	return cache;
+}
+
+
+//most recent first, the oldest entry is dropped when full (lock held)
+static void Cache_Touch(struct result_cache *cache, const struct cache_entry *entry)
+{
+	auto found = cache->lruIndex.find(entry->key);
+	if (found != cache->lruIndex.end())
+	{
+		*found->second = *entry;
+		cache->lru.splice(cache->lru.begin(), cache->lru, found->second);
+		return;
+	}
+	cache->lru.push_front(*entry);
+	cache->lruIndex[entry->key] = cache->lru.begin();
+	if (cache->lru.size() > CACHE_LRU_ENTRIES)
+	{
+		cache->lruIndex.erase(cache->lru.back().key);
+		cache->lru.pop_back();
+	}
+}
+
+
+static inline bool Cache_Same(const struct cache_entry *a, const struct cache_entry *b)
+{
+	return a->flags == b->flags && memcmp(a->header, b->header, sizeof(a->header)) == 0;
+}
+
+
+//results of this run or a recent hit (lock held)
+static bool Cache_FindMemory(struct result_cache *cache, struct cache_entry *entry)
+{
+	auto found = cache->lruIndex.find(entry->key);
+	if (found == cache->lruIndex.end() || !Cache_Same(&*found->second, entry))
+		return false;
+	*entry = *found->second;
+	cache->lru.splice(cache->lru.begin(), cache->lru, found->second);
+	cache->memoryHits++;
+	return true;
+}
+
+
+//************************************
+// Method:    ResultCache_Find	Results of a plot of the same inputs, in this run or a previous one
+// FullName:  ResultCache_Find
+// Access:    public
+// Returns:   int					CACHE_HIT (results returned in entry), CACHE_MISS (the caller solves and stores the plot),
+//									CACHE_WAITING (another plot solves the same inputs, waiter is returned by its ResultCache_Store)
+// Qualifier:
+// Parameter: result_cache * cache
+// Parameter: cache_entry * entry	key, header and flags of ResultCache_Key
+// Parameter: size_t waiter			number of the plot for the caller, queued on CACHE_WAITING
+//************************************
+int ResultCache_Find(struct result_cache *cache, struct cache_entry *entry, size_t waiter)
+{
+	{
+		std::lock_guard<std::mutex> guard(cache->lock);
+		if (Cache_FindMemory(cache, entry))
+			return CACHE_HIT;
+	}
+
+	//the index of the file is not changed after ResultCache_Open
+	auto stored = cache->index.find(entry->key);
+	if (stored != cache->index.end() && Cache_Same(&cache->stored[stored->second], entry))
+	{
+		*entry = cache->stored[stored->second];
+		std::lock_guard<std::mutex> guard(cache->lock);
+		Cache_Touch(cache, entry);
+		cache->fileHits++;
+		return CACHE_HIT;
+	}
+
+	//not solved yet: the first plot of these inputs claims them, the next ones wait for it
+	std::lock_guard<std::mutex> guard(cache->lock);
+	if (Cache_FindMemory(cache, entry))
+		return CACHE_HIT;				//stored since the first look
+	auto claim = cache->inFlight.find(entry->key);
+	if (claim == cache->inFlight.end())
+		cache->inFlight[entry->key].entry = *entry;
+	else if (Cache_Same(&claim->second.entry, entry))
+	{
+		claim->second.waiters.push_back(waiter);
+		cache->memoryHits++;
+		return CACHE_WAITING;
+	}
+	cache->misses++;
+	return CACHE_MISS;					//other inputs of the same key are solved apart
+}
+
+
+//************************************
+// Method:    ResultCache_Store	Results of a plot solved in this run
+// FullName:  ResultCache_Store
+// Access:    public
+// Returns:   void
+// Qualifier:
+// Parameter: result_cache * cache
+// Parameter: const cache_entry * entry	ResultCache_Key and the results
+// Parameter: std::vector<size_t> * waiters	(for return) plots that waited for these results (CACHE_WAITING),
+//											must be given if ResultCache_Find is called with waiters
+//************************************
+void ResultCache_Store(struct result_cache *cache, const struct cache_entry *entry, std::vector<size_t> *waiters)
+{
+	std::lock_guard<std::mutex> guard(cache->lock);
+	Cache_Touch(cache, entry);
+	cache->pending.push_back(*entry);
+
+	auto claim = cache->inFlight.find(entry->key);
+	if (claim != cache->inFlight.end() && Cache_Same(&claim->second.entry, entry))
+	{
+		if (waiters)
+			waiters->swap(claim->second.waiters);
+		cache->inFlight.erase(claim);
+	}
+}
+
+
+//************************************
+// Method:    ResultCache_Close	Append the results of this run to the cache file, free the cache
+// FullName:  ResultCache_Close
+// Access:    public
+// Returns:   int					GSL_SUCCESS, GSL_EFAILED (the file cannot be written)
+// Qualifier:
+// Parameter: result_cache * cache
+//************************************
+int ResultCache_Close(struct result_cache *cache)
+{
+	if (cache == 0)
+		return GSL_EFAILED;
+
+	//entries of plots sharing inputs within this run are written once
+	size_t nStored = cache->index.size();
+	std::vector<struct cache_entry> entries;
+	entries.reserve(cache->pending.size());
+	for (size_t i = 0; i < cache->pending.size(); i++)
+		if (cache->index.emplace(cache->pending[i].key, nStored + entries.size()).second)
+			entries.push_back(cache->pending[i]);
+
+	MappedFile_Close(&cache->file);
+	int status = GSL_SUCCESS;
+	if (cache->rewrite || !entries.empty())
+	{
+		FILE *f = 0;
+		if (fopen_s(&f, cache->fname.c_str(), cache->rewrite ? "wb" : "ab") != 0)
+			status = GSL_EFAILED;
+		else
+		{
+			if (cache->rewrite)
+			{
+				struct cache_file_header header;
+				memset(&header, 0, sizeof(header));
+				memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+				header.version = CACHE_VERSION;
+				header.libVersion = LAI_PATH_VERSION;
+				header.entryBytes = sizeof(struct cache_entry);
+				if (fwrite(&header, sizeof(header), 1, f) != 1)
+					status = GSL_EFAILED;
+			}
+			if (!entries.empty() && fwrite(entries.data(), sizeof(struct cache_entry), entries.size(), f) != entries.size())
+				status = GSL_EFAILED;
+			if (fclose(f) != 0)
+				status = GSL_EFAILED;
+		}
+	}
+	delete cache;
+	return status;
+}
@@ -0,0 +1,106 @@
+/*!
+* \file ResultCache.h
+* \date
+*			2026/10/17	Content-addressed cache of plot results across runs
+*			2026/10/17	Plots of the same inputs solved at the same time: the first one solves, the others wait for it
+*
+* \brief
+*		Plots whose inputs did not change since the last run are not parsed nor solved again.
+*		The key of a plot is a 64-bit hash (XXH64) of LAI_PATH_VERSION, the integration method,
+*		the header (gap fraction, large gaps, zenith, G, mode) and the content: the data of its
+*		path length file (hashed in the mapping, before it is parsed into a histogram), or the
+*		inline frequencies normalized to sum 1. The header is stored with the results and
+*		compared too.
+*
+*		Cache file: cache_file_header, then cache_entry records (appended at ResultCache_Close).
+*		The file is mapped at ResultCache_Open and indexed by key; results of this run and
+*		recent hits are kept in front of it in an LRU list of up to CACHE_LRU_ENTRIES entries.
+*		A miss claims the key until ResultCache_Store: plots of the same inputs found in the
+*		meantime are queued as waiters (CACHE_WAITING) instead of being solved, and handed to
+*		the plot that solves them by ResultCache_Store. Nobody blocks, so plots sharing inputs
+*		within one run are solved once, also when they run at the same time. All functions are
+*		thread-safe.
+*
+*/
+
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "LAIPath.h"
+#include "LAIPathInput.h"
+#include "MappedFile.h"
+
+#define CACHE_VERSION		1
+#define CACHE_LRU_ENTRIES	65536
+
+struct cache_file_header
+{
+	char magic[8];			//"LAIPCCH"
+	uint32_t version;		//CACHE_VERSION
+	uint32_t libVersion;	//LAI_PATH_VERSION
+	uint32_t entryBytes;	//sizeof(cache_entry)
+	uint32_t reserved[3];
+};
+
+//results of a plot by the key of its inputs
+struct cache_entry
+{
+	uint64_t key;
+	double header[INPUT_HEADER_LINES];	//INPUT_GAP_FRACTION ... INPUT_MODE
+	int32_t flags;						//integration method, CACHE_LUT
+	int32_t status;
+	int32_t gsl_errno;
+	int32_t reserved;
+	uint64_t nPath;
+	double LAIe;
+	double LAI;
+	double CI;
+	struct solver_info info;
+};
+
+#define CACHE_LUT			0x100		//flags: ellipse assumption interpolated in a circle_lut
+
+//ResultCache_Find
+#define CACHE_MISS			0			//the caller solves the plot and stores its results
+#define CACHE_HIT			1			//results returned in the entry
+#define CACHE_WAITING		2			//a plot of the same inputs is being solved, the waiter is returned by its ResultCache_Store
+
+//key being solved and the plots waiting for its results
+struct cache_claim
+{
+	struct cache_entry entry;					//key, header and flags of the plot solving it
+	std::vector<size_t> waiters;
+};
+
+struct result_cache
+{
+	std::string fname;
+	struct mapped_file file;					//entries of the previous runs
+	const struct cache_entry *stored;
+	std::unordered_map<uint64_t, size_t> index;	//key: stored entry
+	bool rewrite;								//file missing or of another version
+
+	std::mutex lock;							//lru, lruIndex, pending, inFlight
+	std::list<struct cache_entry> lru;			//most recent first
+	std::unordered_map<uint64_t, std::list<struct cache_entry>::iterator> lruIndex;
+	std::vector<struct cache_entry> pending;	//new entries, written at close
+	std::unordered_map<uint64_t, struct cache_claim> inFlight;	//missed keys until they are stored
+
+	std::atomic<size_t> memoryHits;				//also plots that waited for a plot of the same inputs
+	std::atomic<size_t> fileHits;
+	std::atomic<size_t> misses;
+};
+
+uint64_t ResultCache_Hash(const void *data, size_t len, uint64_t seed = 0);
+void ResultCache_Key(struct cache_entry *entry, const double *header, int flags, const void *content, size_t bytes);
+struct result_cache *ResultCache_Open(const char *fname);
+int ResultCache_Find(struct result_cache *cache, struct cache_entry *entry, size_t waiter = 0);
+void ResultCache_Store(struct result_cache *cache, const struct cache_entry *entry, std::vector<size_t> *waiters = 0);
+int ResultCache_Close(struct result_cache *cache);
@@ -37,11 +37,27 @@
 *
 */
 
+#include <cstdarg>
 #include <cstdio>
 #include <string.h>
 #include <list>
+#include <mutex>
+#include <vector>
 
 #include "LAIPath.h"
+#include "LAIPathCompat.h"
+#include "CircleLUT.h"
+#include "LaiPathSolver.h"
+#include "PathHistStream.h"
+#include "LAIPathInput.h"
+#include "LAIPathManifest.h"
+#include "LAIPathOutput.h"
+#include "ResultArchive.h"
+#include "ResultCache.h"
+#include "LAIPathProfile.h"
+#include "LAIPathCounters.h"
+#include "CanopySim.h"
+#include "LAIPathExact.h"
 
 void usage(bool wait = false)
 {
@@ -53,6 +69,26 @@ AGR FOREST METEOROL, 265, 390-411.\n\n");
 	//fprintf(stderr, "laslib in.las out.las\n");
 	fprintf(stderr, "LAIPATH -i in.txt -o out.txt\n");
 	fprintf(stderr, "LAIPATH -i in.txt\n");
+	fprintf(stderr, "LAIPATH -i in.txt -quad     (adaptive quadrature instead of closed form)\n");
+	fprintf(stderr, "LAIPATH -i in.txt -check    (report closed form vs. quadrature)\n");
+	fprintf(stderr, "LAIPATH -i in.txt -stream   (path lengths in one pass and constant memory, mode < 0)\n");
+	fprintf(stderr, "LAIPATH -i in.txt -exact    (Eq.13 over the path lengths themselves instead of %d bins, mode < 0)\n", NUM_BINS);
+	fprintf(stderr, "LAIPATH -i in.npy           (binary: .npy, .f32, .f64, header lines in in.hdr)\n");
+	fprintf(stderr, "LAIPATH -i in.f32 -hdr header.txt\n");
+	fprintf(stderr, "LAIPATH -i in.txt -o out.csv    (one record for scripts: .csv or .jsonl instead of the report)\n");
+	fprintf(stderr, "LAIPATH -i in.txt -quiet        (no report on the console)\n");
+	fprintf(stderr, "LAIPATH -manifest plots.csv -o results.csv    (one row per plot, CSV or JSON lines)\n");
+	fprintf(stderr, "LAIPATH -manifest plots.csv -archive results.lpa    (results also appended to a binary archive)\n");
+	fprintf(stderr, "LAIPATH -manifest plots.csv -cache results.lpc    (plots with unchanged inputs are not solved again)\n");
+	fprintf(stderr, "LAIPATH -scan_archive results.lpa    (rows and mean LAI / CI of an archive)\n");
+	fprintf(stderr, "LAIPATH -manifest plots.csv -counters    (cycles, IPC and cache misses per plot of the phases, Linux)\n");
+#ifdef LAI_PATH_PROFILE
+	fprintf(stderr, "LAIPATH -i in.txt -profile trace.json    (time of the phases, and Chrome trace_event JSON)\n");
+#endif
+	fprintf(stderr, "LAIPATH -simulate scene.txt -o plot.txt    (path lengths of a Monte Carlo canopy with known LAI, also .npy, .f32, .f64)\n");
+	fprintf(stderr, "LAIPATH -simulate scene.txt -plots 100 -o plot.f32    (plot_0001.f32 ... and the manifest plot_manifest.csv)\n");
+	fprintf(stderr, "LAIPATH -build_lut table.bin    (tabulate the ellipse assumption, mode 0)\n");
+	fprintf(stderr, "LAIPATH -i in.txt -lut table.bin\n");
 	fprintf(stderr, "LAIPATH -h\n");
 	//fprintf(stderr, "laslib -i in.las -o out.las\n");
 	//fprintf(stderr, "laslib -ilas -olas < in.las > out.las\n");
@@ -88,16 +124,313 @@ char* output_path(char* new_path, const char* original_path, const char* fname_a
 }
 
 
+//report of the example, once to the console (0: -quiet) and once to the report file (0: none)
+static void report(FILE *console, FILE *fout, const char *format, ...)
+{
+	LAI_PROFILE_SCOPE("report");
+	va_list args;
+	if (console)
+	{
+		va_start(args, format);
+		vfprintf(console, format, args);
+		va_end(args);
+	}
+	if (fout)
+	{
+		va_start(args, format);
+		vfprintf(fout, format, args);
+		va_end(args);
+	}
+}
+
+
+//path length distribution table of the report
+static void report_histogram(FILE *console, FILE *fout, const gsl_histogram *hist)
+{
+	report(console, fout, "\nPath length distribution:\nmin  max  probability\n");
+	if (console)
+		gsl_histogram_fprintf(console, hist, "%.2f", "%.3f");
+	if (fout)
+		gsl_histogram_fprintf(fout, hist, "%.2f", "%.3f");
+}
+
+
+//lines of the input file without a number
+static void print_invalid_lines(FILE *fout, const struct input_values_info *info)
+{
+	if (info->nInvalid == 0)
+		return;
+	report(stderr, fout, "Warning: %zu lines without a number are ignored (first: line %zu)\n", info->nInvalid, info->firstInvalid);
+}
+
+
+#ifdef LAI_PATH_PROFILE
+static char fname_trace[_MAX_PATH];			// -profile, '\0': summary only
+
+//phases of the run, at exit
+static void profile_report()
+{
+	fprintf(stderr, "\n");
+	LAIPathProfile_Summary(stderr);
+	if (fname_trace[0] != '\0' && LAIPathProfile_Trace(fname_trace) != GSL_SUCCESS)
+		fprintf(stderr, "WARNING: could not write '%s'\n", fname_trace);
+}
+#endif
+
+
+//batches (-manifest) and -quiet: no banner
+static bool has_option(int argc, char *argv[], const char *option)
+{
+	for (int i = 1; i < argc; i++)
+		if (strcmp(argv[i], option) == 0)
+			return true;
+	return false;
+}
+
+
+//all plots of a manifest in one process, one results table, the archive and the cache (fname[0] == '\0': none)
+static int run_manifest(const char *fname_manifest, const char *fname_out, const char *fname_archive, const char *fname_cache,
+	int integration, const struct circle_lut *lut)
+{
+	std::vector<struct manifest_plot> plots;
+	int status = Manifest_Read(fname_manifest, plots, stderr);
+	if (status == GSL_EFAILED)
+	{
+		fprintf(stderr, "ERROR: could not open '%s' for reading\n", fname_manifest);
+		return 1;
+	}
+
+	struct result_archive *archive = 0;
+	if (fname_archive[0] != '\0')
+	{
+		archive = Archive_Open(fname_archive, NUM_BINS);
+		if (archive == 0)
+		{
+			fprintf(stderr, "ERROR: could not write '%s', or it is not an archive of %d bins\n", fname_archive, NUM_BINS);
+			return 1;
+		}
+	}
+
+	struct result_cache *cache = (fname_cache[0] != '\0') ? ResultCache_Open(fname_cache) : 0;
+
+	size_t failed;
+	{
+		LaiPathPool pool;									// one task per plot
+		failed = Manifest_Solve(pool, plots, integration, lut, archive, cache);
+	}
+	if (cache)
+	{
+		fprintf(stderr, "cache: %zu hits (%zu in memory), %zu misses\n", cache->memoryHits + cache->fileHits,
+			cache->memoryHits.load(), cache->misses.load());
+		if (ResultCache_Close(cache) != GSL_SUCCESS)
+			fprintf(stderr, "WARNING: could not write '%s'\n", fname_cache);
+	}
+	if (archive && Archive_Close(archive) != GSL_SUCCESS)
+	{
+		fprintf(stderr, "ERROR: could not write '%s'\n", fname_archive);
+		return 1;
+	}
+
+	int format = LAIPathOutput_Format(fname_out);
+	if (Manifest_WriteTable(fname_out, plots, (format < 0) ? OUTPUT_CSV : format) != GSL_SUCCESS)
+	{
+		fprintf(stderr, "ERROR: could not write '%s'\n", fname_out);
+		return 1;
+	}
+	fprintf(stderr, "%zu plots, %zu not solved: '%s'\n", plots.size(), failed, fname_out);
+
+	// numerical work of the batch (plots solved in this run, not the cache hits), expensive plots are in the columns of the table
+	struct solver_work work;
+	memset(&work, 0, sizeof(work));
+	for (size_t p = 0; p < plots.size(); p++)
+		if (plots[p].solved)
+			LAI_PATH_AddWork(&work, &plots[p].info);
+	fprintf(stderr, "work: %lld iterations (max %d, %zu at the limit), %lld evaluations, %lld integrand calls, "
+		"%lld quadrature subintervals (max %d), %zu bracket failures, %zu LAI_MAX\n",
+		work.iter, work.maxIter, work.nMaxIter, work.nEval, work.nPathProb, work.nIntervals, work.maxIntervals,
+		work.nBracketFail, work.nFallback);
+
+	// tail latency by input mode, histograms merged for all plots
+	static const char *const mode_names[MANIFEST_MODES] = { "path lengths", "histogram", "ellipse" };
+	struct latency_hist latency[MANIFEST_MODES], all;
+	Manifest_Latency(plots, latency);
+	LatencyHist_Clear(&all);
+	LatencyHist_Report(stderr, 0, 0);
+	for (int m = 0; m < MANIFEST_MODES; m++)
+	{
+		LatencyHist_Report(stderr, mode_names[m], &latency[m]);
+		LatencyHist_Merge(&all, &latency[m]);
+	}
+	LatencyHist_Report(stderr, "all", &all);
+
+	// hardware counters of the phases (-counters), per plot
+	LAIPathCounters_Report(stderr, plots.size());
+	return 0;
+}
+
+
+//plots of a simulated canopy (-simulate), nPlots == 0: one plot in fname_out, else numbered files and a manifest;
+//plots without path lengths (no ray crosses a crown) are not written
+static int run_simulate(const char *fname_scene, const char *fname_out, size_t nPlots)
+{
+	struct canopy_scene scene;
+	int status = CanopySim_ReadScene(fname_scene, &scene, stderr);
+	if (status == GSL_EFAILED)
+	{
+		fprintf(stderr, "ERROR: could not open '%s' for reading\n", fname_scene);
+		return 1;
+	}
+	if (status != GSL_SUCCESS)
+	{
+		fprintf(stderr, "ERROR: '%s' is not a valid scene\n", fname_scene);
+		return 1;
+	}
+
+	char fname_manifest[_MAX_PATH];
+	FILE *manifest = 0;
+	if (nPlots > 0)
+	{
+		output_path(fname_manifest, fname_out, "_manifest", "csv");
+		if (fopen_s(&manifest, fname_manifest, "w") != 0)
+		{
+			fprintf(stderr, "ERROR: could not write '%s'\n", fname_manifest);
+			return 1;
+		}
+		fprintf(manifest, "id,path,true_lai\n");		// header lines in the plot files
+	}
+
+	LaiPathPool pool;
+	struct canopy_sim sim;
+	size_t nSkipped = 0;
+	for (size_t p = 0; p < GSL_MAX(nPlots, (size_t)1); p++)
+	{
+		char fname_plot[_MAX_PATH], number[16];
+		snprintf(number, sizeof(number), "_%04zu", p + 1);
+		if (nPlots > 0)
+			output_path(fname_plot, fname_out, number, 0);
+		else
+			strcpy_s(fname_plot, fname_out);
+
+		if (CanopySim_Plot(pool, &scene, scene.seed + p, &sim) != GSL_SUCCESS)
+		{
+			// no path lengths: the file would not be a valid input
+			if (manifest == 0)
+			{
+				fprintf(stderr, "ERROR: no ray of the plot crosses a crown, '%s' is not written\n", fname_plot);
+				return 1;
+			}
+			fprintf(stderr, "WARNING: no ray of plot %zu crosses a crown, '%s' is not written\n", p + 1, fname_plot);
+			nSkipped++;
+			continue;
+		}
+		if (CanopySim_Write(fname_plot, &scene, &sim) != GSL_SUCCESS)
+		{
+			fprintf(stderr, "ERROR: could not write '%s'\n", fname_plot);
+			if (manifest)
+				fclose(manifest);
+			return 1;
+		}
+		fprintf(stderr, "'%s': %zu crowns, true LAI %f, LAIe %f, gap fraction %f inside canopy, %f large gaps, %zu path lengths\n",
+			fname_plot, sim.crowns.size(), sim.trueLAI,
+			-log(sim.gapFraction * (1 - sim.largeGaps) + sim.largeGaps) / scene.G * cos(scene.zenith * M_PI / 180),
+			sim.gapFraction, sim.largeGaps, sim.pathLengths.size());
+		if (manifest)
+		{
+			const char *name = fname_plot + strlen(fname_plot);		// the plots are next to the manifest
+			while (name > fname_plot && name[-1] != '/' && name[-1] != '\\')
+				name--;
+			fprintf(manifest, "%zu,%s,%.6f\n", p + 1, name, sim.trueLAI);
+		}
+	}
+	if (manifest)
+	{
+		if (fclose(manifest) != 0)
+		{
+			fprintf(stderr, "ERROR: could not write '%s'\n", fname_manifest);
+			return 1;
+		}
+		fprintf(stderr, "%zu plots: '%s'\n", nPlots - nSkipped, fname_manifest);
+		if (nSkipped > 0)
+			fprintf(stderr, "WARNING: %zu plots without path lengths are not in the manifest\n", nSkipped);
+	}
+	return (nPlots > 0 && nSkipped == nPlots) ? 1 : 0;
+}
+
+
+//one pass over the LAI, CI and status columns of an archive
+static int scan_archive(const char *fname_archive)
+{
+	struct archive_reader reader;
+	if (ArchiveReader_Open(&reader, fname_archive) != GSL_SUCCESS)
+	{
+		fprintf(stderr, "ERROR: '%s' cannot be read, or is not an archive\n", fname_archive);
+		ArchiveReader_Close(&reader);
+		return 1;
+	}
+	if (reader.end < reader.file.size)
+		fprintf(stderr, "WARNING: last %llu bytes of '%s' are a partial block of an interrupted run, not read\n",
+			(unsigned long long)(reader.file.size - reader.end), fname_archive);
+
+	size_t nSolved = 0;
+	double sumLAI = 0, sumCI = 0;
+	for (uint64_t k = 0; k < reader.nBlocks; k++)
+	{
+		struct archive_columns columns;
+		ArchiveReader_Block(&reader, k, &columns);
+		for (size_t i = 0; i < columns.nRows; i++)
+			if ((columns.status[i] == GSL_SUCCESS || columns.status[i] == LAI_PATH_ZERO_PATH)
+				&& gsl_finite(columns.LAI[i]) && gsl_finite(columns.CI[i]))
+			{
+				sumLAI += columns.LAI[i];
+				sumCI += columns.CI[i];
+				nSolved++;
+			}
+	}
+	if (nSolved == 0)
+		fprintf(stdout, "%llu rows in %llu blocks, no solved rows\n",
+			(unsigned long long)reader.nRows, (unsigned long long)reader.nBlocks);
+	else
+		fprintf(stdout, "%llu rows in %llu blocks, %zu solved: mean LAI_PATH %f, mean CI %f\n",
+			(unsigned long long)reader.nRows, (unsigned long long)reader.nBlocks, nSolved, sumLAI / nSolved, sumCI / nSolved);
+	ArchiveReader_Close(&reader);
+	return 0;
+}
+
+
 int main(int argc, char *argv[])
 {
 	char fname_in[_MAX_PATH];
 	char fname_out[_MAX_PATH];
 	fname_out[0] = '\0';
+	int integration = LAI_PATH_ANALYTIC;
+	char fname_lut[_MAX_PATH];
+	fname_lut[0] = '\0';
+	char fname_hdr[_MAX_PATH];					// header lines of binary input files
+	fname_hdr[0] = '\0';
+	char fname_manifest[_MAX_PATH];				// plots of a batch
+	fname_manifest[0] = '\0';
+	char fname_archive[_MAX_PATH];				// results of batches, -archive or -scan_archive
+	fname_archive[0] = '\0';
+	char fname_cache[_MAX_PATH];				// results of batches by their inputs
+	fname_cache[0] = '\0';
+	char fname_scene[_MAX_PATH];				// simulated canopy
+	fname_scene[0] = '\0';
+	size_t n_plots = 0;							// simulated plots, 0: one without manifest
+	bool scan = false;
+	bool build_lut = false;
+	bool stream = false;
+	bool exact = false;
+	bool quiet = false;
+	bool counters = false;
+	struct circle_lut *lut = 0;
 
 
 	errno_t err;
-	FILE * fin, *fout;
-	char tmpline[1000];
+	FILE *fout = 0;							// report file, 0: record (-o *.csv, *.jsonl)
+	FILE *console;							// report on the console, 0: -quiet
+	int record_format;
+	struct lai_path_input input;			// mapped input file
+	struct input_values_info values_info;
 	//char tmp[100];
 	//double tmpPathLen;
 
@@ -113,7 +446,7 @@ int main(int argc, char *argv[])
 		fname_out[strlen(fname_out) - 1] = '\0';
 
 	}
-	else
+	else if (!has_option(argc, argv, "-manifest") && !has_option(argc, argv, "-scan_archive") && !has_option(argc, argv, "-simulate") && !has_option(argc, argv, "-quiet"))		// batches print no banner
 	{
 		usage();
 		//lasreadopener.parse(argc, argv);
@@ -151,6 +484,114 @@ int main(int argc, char *argv[])
 			strcpy_s(fname_out, argv[i + 1]);
 			i += 1;
 		}
+		else if (strcmp(argv[i], "-manifest") == 0)
+		{
+			if ((i + 1) >= argc)
+			{
+				fprintf(stderr, "ERROR: '%s' needs 1 argument: stop\n", argv[i]);
+				return 1;
+			}
+			strcpy_s(fname_manifest, argv[i + 1]);
+			i += 1;
+		}
+		else if (strcmp(argv[i], "-archive") == 0 || strcmp(argv[i], "-scan_archive") == 0)
+		{
+			if ((i + 1) >= argc)
+			{
+				fprintf(stderr, "ERROR: '%s' needs 1 argument: stop\n", argv[i]);
+				return 1;
+			}
+			scan = (strcmp(argv[i], "-scan_archive") == 0);
+			strcpy_s(fname_archive, argv[i + 1]);
+			i += 1;
+		}
+#ifdef LAI_PATH_PROFILE
+		else if (strcmp(argv[i], "-profile") == 0)
+		{
+			if ((i + 1) >= argc)
+			{
+				fprintf(stderr, "ERROR: '%s' needs 1 argument: stop\n", argv[i]);
+				return 1;
+			}
+			strcpy_s(fname_trace, argv[i + 1]);
+			i += 1;
+		}
+#endif
+		else if (strcmp(argv[i], "-cache") == 0)
+		{
+			if ((i + 1) >= argc)
+			{
+				fprintf(stderr, "ERROR: '%s' needs 1 argument: stop\n", argv[i]);
+				return 1;
+			}
+			strcpy_s(fname_cache, argv[i + 1]);
+			i += 1;
+		}
+		else if (strcmp(argv[i], "-simulate") == 0)
+		{
+			if ((i + 1) >= argc)
+			{
+				fprintf(stderr, "ERROR: '%s' needs 1 argument: stop\n", argv[i]);
+				return 1;
+			}
+			strcpy_s(fname_scene, argv[i + 1]);
+			i += 1;
+		}
+		else if (strcmp(argv[i], "-plots") == 0)
+		{
+			if ((i + 1) >= argc || atoi(argv[i + 1]) < 1)
+			{
+				fprintf(stderr, "ERROR: '%s' needs 1 argument (number of plots > 0): stop\n", argv[i]);
+				return 1;
+			}
+			n_plots = atoi(argv[i + 1]);
+			i += 1;
+		}
+		else if (strcmp(argv[i], "-hdr") == 0)
+		{
+			if ((i + 1) >= argc)
+			{
+				fprintf(stderr, "ERROR: '%s' needs 1 argument: stop\n", argv[i]);
+				return 1;
+			}
+			strcpy_s(fname_hdr, argv[i + 1]);
+			i += 1;
+		}
+		else if (strcmp(argv[i], "-lut") == 0 || strcmp(argv[i], "-build_lut") == 0)
+		{
+			if ((i + 1) >= argc)
+			{
+				fprintf(stderr, "ERROR: '%s' needs 1 argument: stop\n", argv[i]);
+				return 1;
+			}
+			build_lut = (strcmp(argv[i], "-build_lut") == 0);
+			strcpy_s(fname_lut, argv[i + 1]);
+			i += 1;
+		}
+		else if (strcmp(argv[i], "-quad") == 0)
+		{
+			integration = LAI_PATH_QUADRATURE;
+		}
+		else if (strcmp(argv[i], "-check") == 0)
+		{
+			integration = LAI_PATH_COMPARE;
+		}
+		else if (strcmp(argv[i], "-stream") == 0)
+		{
+			stream = true;
+		}
+		else if (strcmp(argv[i], "-exact") == 0)
+		{
+			exact = true;
+		}
+		else if (strcmp(argv[i], "-quiet") == 0)
+		{
+			quiet = true;
+		}
+		else if (strcmp(argv[i], "-counters") == 0)
+		{
+			counters = true;
+		}
 		else
 		{
 			fprintf(stderr, "ERROR: cannot understand argument '%s'\n", argv[i]);
@@ -160,13 +601,76 @@ int main(int argc, char *argv[])
 
 
 
-	err = fopen_s(&fin, fname_in, "r");
-	if (err != 0)
+#ifdef LAI_PATH_PROFILE
+	atexit(profile_report);
+#endif
+
+	const char *counters_reason;
+	if (counters && !LAIPathCounters_Enable(&counters_reason))
+		fprintf(stderr, "WARNING: no hardware counters: %s\n", counters_reason);
+
+	if (build_lut)
+	{
+		if (CircleLUT_Build(fname_lut, CIRCLE_LUT_NODES, CIRCLE_LUT_T_MAX, stderr) != 0)
+		{
+			fprintf(stderr, "ERROR: could not build '%s'\n", fname_lut);
+			return 1;
+		}
+		return 0;
+	}
+
+	if (scan)
+	{
+		return scan_archive(fname_archive);
+	}
+
+	if (fname_scene[0] != '\0')
+	{
+		if (fname_out[0] == '\0')
+		{
+			output_path(fname_out, fname_scene, "_plot", "txt");
+		}
+		return run_simulate(fname_scene, fname_out, n_plots);
+	}
+
+	if (fname_lut[0] != '\0')
 	{
-		fprintf(stderr, "ERROR: could not open '%s' for reading\n", fname_in);
+		lut = CircleLUT_Open(fname_lut);
+		if (lut == 0)
+			fprintf(stderr, "WARNING: could not map '%s', ellipse assumption is solved directly\n", fname_lut);
+	}
+
+	if (fname_manifest[0] != '\0')
+	{
+		if (fname_out[0] == '\0')
+		{
+			output_path(fname_out, fname_manifest, "_results", "csv");
+		}
+		int status = run_manifest(fname_manifest, fname_out, fname_archive, fname_cache, integration, lut);
+		CircleLUT_Close(lut);
+		return status;
+	}
+
+	int input_status = LAIPathInput_Open(&input, fname_in, (fname_hdr[0] != '\0') ? fname_hdr : 0);
+	if (input_status == GSL_EFAILED)
+	{
+		fprintf(stderr, "ERROR: could not open '%s' or its header file for reading\n", fname_in);
+		LAIPathInput_Close(&input);
 		getc(stdin);
 		return 1;	
 	}
+	if (input_status != GSL_SUCCESS && input.format != INPUT_TEXT)
+	{
+		fprintf(stderr, "ERROR: '%s' is not a float32 / float64 array, or its header file needs %d lines starting with a number\n", fname_in, INPUT_HEADER_LINES);
+		LAIPathInput_Close(&input);
+		return 1;
+	}
+	if (input_status != GSL_SUCCESS)
+	{
+		fprintf(stderr, "ERROR: '%s' needs %d header lines starting with a number\n", fname_in, INPUT_HEADER_LINES);
+		LAIPathInput_Close(&input);
+		return 1;
+	}
 
 	if (fname_out[0] == '\0')
 	{
@@ -174,20 +678,26 @@ int main(int argc, char *argv[])
 	}
 
 
-	err = fopen_s(&fout, fname_out, "w");
-	if (err != 0)
+	console = quiet ? 0 : stdout;
+	record_format = LAIPathOutput_Format(fname_out);
+	if (record_format < 0)
 	{
-		fprintf(stderr, "ERROR: could not open '%s' for writing\n", fname_out);
-		getc(stdin);
-		//return 1;
-
+		err = fopen_s(&fout, fname_out, "w");				// text mode: "\n" is the line end of the platform
+		if (err != 0)
+		{
+			fprintf(stderr, "ERROR: could not open '%s' for writing\n", fname_out);
+			LAIPathInput_Close(&input);
+			CircleLUT_Close(lut);
+			getc(stdin);
+			return 1;
+		}
 	}
 
-	fprintf(fout, "Path Length Distribution Method\r\nContact: Ronghai HU (huronghai@ucas.edu.cn)\r\n \
-Reference: \r\n1. Hu, R.et al. (2014).Indirect Measurement of Leaf Area Index \
-on the Basis of Path Length Distribution.REMOTE SENS ENVIRON, 155, 239 - 247.\r\n \
+	report(0, fout, "Path Length Distribution Method\nContact: Ronghai HU (huronghai@ucas.edu.cn)\n \
+Reference: \n1. Hu, R.et al. (2014).Indirect Measurement of Leaf Area Index \
+on the Basis of Path Length Distribution.REMOTE SENS ENVIRON, 155, 239 - 247.\n \
 2. Yan, G. et al. (2019). Review of indirect optical measurements of leaf area index: Recent advances, challenges, and perspectives.\
-AGR FOREST METEOROL, 265, 390-411.\r\n");
+AGR FOREST METEOROL, 265, 390-411.\n");
 
 
 
@@ -208,36 +718,27 @@ AGR FOREST METEOROL, 265, 390-411.\r\n");
 
 	double total_gap_fraction, LAIe, CI;
 
-	fgets(tmpline, 1000, fin);
-	sscanf_s(tmpline, "%lf", &gap_fraction_inside_canopy);
-
-	fgets(tmpline, 1000, fin);
-	sscanf_s(tmpline, "%lf", &gap_fraction_of_large_gaps);
-
-	fgets(tmpline, 1000, fin);
-	sscanf_s(tmpline, "%lf", &zenith);
-
-	fgets(tmpline, 1000, fin);
-	sscanf_s(tmpline, "%lf", &G);
-
-	fgets(tmpline, 1000, fin);
-	sscanf_s(tmpline, "%d", &mode);
+	gap_fraction_inside_canopy = input.header[INPUT_GAP_FRACTION];
+	gap_fraction_of_large_gaps = input.header[INPUT_LARGE_GAPS];
+	zenith = input.header[INPUT_ZENITH];
+	G = input.header[INPUT_G];
+	mode = (int)input.header[INPUT_MODE];
 
+	if (exact && (mode >= 0 || stream))
+	{
+		fprintf(stderr, "WARNING: -exact needs path lengths (mode < 0) and no -stream, the histogram is solved\n");
+		exact = false;
+	}
 	
 	total_gap_fraction = gap_fraction_of_large_gaps + (1 - gap_fraction_of_large_gaps)* gap_fraction_inside_canopy;
 	LAIe = -log(total_gap_fraction) / G * cos(zenith*M_PI / 180);
 	double LAIe_inside_canopy = -log(gap_fraction_inside_canopy) / G * cos(zenith*M_PI / 180);
 	//double LAIe_remove_large_gaps = LAIe_inside_canopy * (1 - gap_fraction_of_large_gaps) ;
 
-	printf("\n Input:\nZenith angle:\t%.1f\nG:\t\t%.1f\n", zenith, G);
-	printf("Gap fraction of large gaps:\t%.4f\n", gap_fraction_of_large_gaps);
-	printf("Gap fraction inside canopy:\t%.4f\n", gap_fraction_inside_canopy);
-	printf("Effective LAI (LAIe) = %.4f\n", LAIe);
-
-	fprintf(fout,"\r\n Input:\nZenith angle:\t%.1f\nG:\t\t%.1f\r\n", zenith, G);
-	fprintf(fout, "Gap fraction of large gaps:\t%.4f\r\n", gap_fraction_of_large_gaps);
-	fprintf(fout, "Gap fraction inside canopy:\t%.4f\r\n", gap_fraction_inside_canopy);
-	fprintf(fout, "Effective LAI (LAIe) = %.4f\r\n", LAIe);
+	report(console, fout, "\n Input:\nZenith angle:\t%.1f\nG:\t\t%.1f\n", zenith, G);
+	report(console, fout, "Gap fraction of large gaps:\t%.4f\n", gap_fraction_of_large_gaps);
+	report(console, fout, "Gap fraction inside canopy:\t%.4f\n", gap_fraction_inside_canopy);
+	report(console, fout, "Effective LAI (LAIe) = %.4f\n", LAIe);
 
 
 	/************Input 2: path length distribution **************/
@@ -254,6 +755,12 @@ AGR FOREST METEOROL, 265, 390-411.\r\n");
 
 	double LAI_path;
 	gsl_histogram * gsl_hist_path;
+	struct solver_info info;
+	LaiPathSolver solver(integration);					// workspaces of LAI_PATH
+
+	//record for scripts: GSL errors of the solve are returned in gsl_errno instead of aborting, as the manifest
+	gsl_error_handler_t *old_handler = (record_format >= 0) ? gsl_set_error_handler(&LAI_PATH_ErrorHandler) : 0;
+	LAI_PATH_ErrorState()->gsl_errno = GSL_SUCCESS;
 
 	if (mode < 0)	//input path lengths
 	{
@@ -263,63 +770,95 @@ AGR FOREST METEOROL, 265, 390-411.\r\n");
 		*	e.g., { 1, 2, 3 } and {0.1, 0.2, 0.3} make no difference.
 		*/
 
-		printf("\nInput mode of path length distribution: Path lengths (-1)\n");
-		fprintf(fout, "\r\nInput mode of path length distribution: Path lengths (-1)\r\n");
+		report(console, fout, "\nInput mode of path length distribution: Path lengths (-1)\n");
 
-		int num_of_lines = 0;
-		while ( fgets(tmpline, 1000, fin) && tmpline[0] != '\n' )
-			++num_of_lines;
+		gsl_hist_path = solver.histogram(NUM_BINS);			// path length distribution
 
-		double *path_lengths = new double[num_of_lines];				//path lengths
-		
-		rewind(fin);
-		fgets(tmpline, 1000, fin);
-		fgets(tmpline, 1000, fin);
-		fgets(tmpline, 1000, fin);
-		fgets(tmpline, 1000, fin);
-		fgets(tmpline, 1000, fin);
-
-		int num_of_path_lengths = 0;
-		double tmp_path_length;
-		while (fgets(tmpline, 1000, fin) && tmpline[0] != '\n')
-		{
-			sscanf_s(tmpline, "%lf", &tmp_path_length);			// read path lengths
-			if (tmp_path_length < -1e-6)
-			{ 
-				fprintf(stderr, "Warning: Path length %lf < 0 will be processed as large gaps\n", tmp_path_length);
-				fprintf(fout, "Warning: Path length %lf < 0 will be processed as large gaps\r\n", tmp_path_length);
+		{
+			LaiPathPool pool;									// threads parsing the input file
+
+			if (stream)
+			{
+				/*	Constant memory: path lengths are counted chunk by chunk and not kept,
+				*	the histogram is rebinned when a longer path length arrives (PathHistStream.h)
+				*/
+				struct path_hist_stream hist_stream;
+				std::mutex hist_stream_lock;
+				int stream_status = PathStream_Alloc(&hist_stream);
+
+				if (stream_status == GSL_SUCCESS)
+					LAIPathInput_ForEachChunk(&input, pool, true, [&](const double *path_lengths, size_t n)
+					{
+						struct path_hist_stream chunk_stream;
+						int chunk_status = PathStream_Alloc(&chunk_stream);
+						if (chunk_status == GSL_SUCCESS)
+							PathStream_Add(&chunk_stream, path_lengths, 1, n);
+						std::lock_guard<std::mutex> guard(hist_stream_lock);
+						if (chunk_status == GSL_SUCCESS)
+							PathStream_Merge(&hist_stream, &chunk_stream);
+						else
+							stream_status = chunk_status;
+						PathStream_Free(&chunk_stream);
+					}, &values_info);
+
+				if (stream_status != GSL_SUCCESS)
+				{
+					fprintf(stderr, "ERROR: no memory for the streaming histogram (%s): stop\n", gsl_strerror(stream_status));
+					PathStream_Free(&hist_stream);
+					LAIPathInput_Close(&input);
+					if (fout) fclose(fout);
+					CircleLUT_Close(lut);
+					return 1;
+				}
+
+				double stream_error = PathStream_Histogram(&hist_stream, gsl_hist_path);
+				PathStream_Free(&hist_stream);
+
+				report(console, fout, "\nStreaming histogram: probabilities within %.2g of the exact distribution\n", stream_error);
+			}
+			else if (exact)
+			{
+				/*	No histogram: the simulated gap fraction is the mean of exp(-LAImax * l) over
+				*	the relative path lengths l, the mean path length their mean (LAIPathExact.h)
+				*/
+				struct path_samples samples;
+				std::vector<double> path_lengths;
+				LAIPathInput_Values(&input, pool, true, path_lengths, &values_info);
+				Exact_Samples(path_lengths.data(), path_lengths.size(), &samples);
+				std::vector<double>().swap(path_lengths);
+
+				LAI_path = LAI_PATH_Exact(&samples, gap_fraction_inside_canopy, zenith, G, &info, &pool);
+				report(console, fout, "\nExact path lengths: %zu samples, mean relative path length %.4f (no histogram)\n",
+					samples.l.size(), info.meanPath);
 			}
 			else
-				path_lengths[num_of_path_lengths++] = tmp_path_length;
+			{
+				LAIPathInput_Histogram(&input, pool, gsl_hist_path, &values_info);	// running statistics to get path length distribution (binary files in place)
+			}
 		}
+		LAIPathInput_Close(&input);
 
-		fclose(fin);
-		fin = 0;
-
-		gsl_hist_path = gsl_histogram_alloc(NUM_BINS);			// path length distribution
-		
-
-		Stat_hist(path_lengths, num_of_path_lengths, gsl_hist_path);			// running statistics to get path length distribution
-		delete[] path_lengths;
-
-		printf("\nPath length distribution:\nmin  max  probability\n");
-		fprintf(fout, "\r\nPath length distribution:\r\nmin  max  probability\r\n");
-		gsl_histogram_fprintf(stdout, gsl_hist_path, "%.2f", "%.3f");
-		gsl_histogram_fprintf(fout, gsl_hist_path, "%.2f", "%.3f");
+		if (values_info.nNegative)
+		{
+			report(stderr, fout, "Warning: %zu path lengths < 0 (smallest %lf) will be processed as large gaps\n", values_info.nNegative, values_info.minNegative);
+		}
+		print_invalid_lines(fout, &values_info);
 
-		LAI_path = LAI_PATH(gsl_hist_path, gap_fraction_inside_canopy, zenith, G) \
-			* (1 - gap_fraction_of_large_gaps) / num_of_lines * num_of_path_lengths;
+		double num_of_lines = (double)values_info.nLines;
+		double num_of_path_lengths = (double)(values_info.nLines - values_info.nNegative);
 
-		//Fix 2020-03-12: fix the too high estimates when too much path lengths close to 0 observed in path length distribution by Ronghai HU
-		if (gsl_fcmp(LAI_path, LAI_MAX, 1e-6) == 0)
+		if (!exact)
 		{
-			gap_fraction_of_large_gaps = gsl_hist_path->bin[0] / NUM_BINS;
-			gsl_hist_path->bin[0] = 0.0;
-			gsl_histogram_scale(gsl_hist_path, 1 / (1 - gap_fraction_of_large_gaps));
-			LAI_path = LAI_PATH(gsl_hist_path, gap_fraction_inside_canopy, zenith, G) \
-				* (1 - gap_fraction_of_large_gaps) / num_of_lines * num_of_path_lengths;
+			report_histogram(console, fout, gsl_hist_path);
 
+			LAI_path = solver.solve(gsl_hist_path, gap_fraction_inside_canopy, zenith, G);
+			info = solver.info();
 		}
+
+		//Fix 2020-03-12: fix the too high estimates when too much path lengths close to 0 observed in path length distribution by Ronghai HU
+		//Since 2026-10 in the same solve: LAI_PATH takes the first bin as large gaps (LAI_PATH_ZERO_PATH) and already scales
+		//its LAI by their mass, the measured large gaps are kept as for mode > 0 (LAIe and CI use them too)
+		LAI_path *= (1 - gap_fraction_of_large_gaps) / num_of_lines * num_of_path_lengths;
 		
 	}
 	else if (mode > 0)	//input path length distributions 
@@ -331,29 +870,30 @@ AGR FOREST METEOROL, 265, 390-411.\r\n");
 		*	e.g., { 100, 200, 300 } and {0.1, 0.2, 0.3} make no difference.
 		*/
 
-		printf("\nInput mode of path length distribution: Distribution (%d bins)\n", mode);
-		fprintf(fout, "\r\nInput mode of path length distribution: Distribution (%d bins)\r\n", mode);
+		report(console, fout, "\nInput mode of path length distribution: Distribution (%d bins)\n", mode);
 
-		gsl_hist_path = gsl_histogram_alloc(mode);  // path length distribution
-		gsl_histogram_set_ranges_uniform(gsl_hist_path, 0, 1);
+		gsl_hist_path = solver.histogram(mode);  // path length distribution, uniform on [0, 1]
 
-		int i = 0;
-		while (fgets(tmpline, 1000, fin) && tmpline[0] != '\n')
 		{
-			sscanf_s(tmpline, "%lf", &gsl_hist_path->bin[i++]);
+			LaiPathPool pool;									// threads parsing the input file
+			std::vector<double> frequencies;
+			LAIPathInput_Values(&input, pool, false, frequencies, &values_info);
+			for (size_t i = 0; i < frequencies.size() && i < gsl_hist_path->n; i++)
+				gsl_hist_path->bin[i] = frequencies[i];
 		}
+		LAIPathInput_Close(&input);
 
-		fclose(fin);
-		fin = 0;
+		if (values_info.nValues != gsl_hist_path->n)
+		{
+			report(stderr, fout, "Warning: %zu frequencies for %d bins\n", values_info.nValues, mode);
+		}
+		print_invalid_lines(fout, &values_info);
 
 		gsl_histogram_scale(gsl_hist_path, static_cast<double>(gsl_hist_path->n) / gsl_histogram_sum(gsl_hist_path));
 
-		printf("\nPath length distribution:\nmin  max  probability\n");
-		fprintf(fout, "\r\nPath length distribution:\r\nmin  max  probability\r\n");
-		gsl_histogram_fprintf(stdout, gsl_hist_path, "%.2f", "%.3f");
-		gsl_histogram_fprintf(fout, gsl_hist_path, "%.2f", "%.3f");
+		report_histogram(console, fout, gsl_hist_path);
 
-		LAI_path = LAI_PATH(gsl_hist_path, gap_fraction_inside_canopy, zenith, G) \
+		LAI_path = solver.solve(gsl_hist_path, gap_fraction_inside_canopy, zenith, G) \
 			* (1 - gap_fraction_of_large_gaps) ;
 
 	} 
@@ -365,27 +905,63 @@ AGR FOREST METEOROL, 265, 390-411.\r\n");
 		*
 		*/
 
-		fclose(fin);
-		fin = 0;
+		LAIPathInput_Close(&input);
 
-		printf("\nInput mode of path length distribution: no input, ellipse assumption (0)\n");
-		fprintf(fout, "\r\nInput mode of path length distribution: no input, ellipse assumption (0)\r\n");
+		report(console, fout, "\nInput mode of path length distribution: no input, ellipse assumption (0)\n");
 
-		LAI_path = LAI_PATH_Circle(gap_fraction_inside_canopy, zenith, G)  \
+		LAI_path = LAI_PATH_Circle_LUT(lut, gap_fraction_inside_canopy, zenith, G, &info)  \
 			* (1 - gap_fraction_of_large_gaps);
 
-		double LAI_path_circle_assumption2 = LAIe2LAI_PATH_Circle(LAIe_inside_canopy, zenith, G)	\
+		double LAI_path_circle_assumption2 = LAI_PATH_Circle_LUT(lut, exp(-LAIe_inside_canopy * G / cos(zenith*M_PI / 180)), zenith, G)	\
 			* (1 - gap_fraction_of_large_gaps);
 
 	}
 
 	CI = LAIe / LAI_path;
+	if (mode > 0)
+		info = solver.info();
+
+	if (integration == LAI_PATH_COMPARE)
+	{
+		fprintf(stderr, "LAImax = %.6f: %d iterations, %d evaluations (status %d)\n", info.LAImax, info.iter, info.nEval, info.status);
+		fprintf(stderr, "%lld integrand calls, %d quadrature subintervals (max %d), %d bracket failures%s\n",
+			info.nPathProb, info.nIntervals, info.maxIntervals, info.nBracketFail, info.fallback ? ", LAI_MAX returned" : "");
+	}
+
+	report(console, fout, "\nResult: LAI_PATH = %.2f\t\tClumping Index = %.3f\n\n", LAI_path, CI);
 
-	printf("\nResult: LAI_PATH = %.2f\t\tClumping Index = %.3f\n\n", LAI_path, CI);
-	fprintf(fout, "\r\nResult: LAI_PATH = %.2f\t\tClumping Index = %.3f\r\n\r\n", LAI_path, CI);
+	if (fout)
+	{
+		fclose(fout);
+		fout = 0;
+	}
+	else
+	{
+		struct lai_path_output out;
+		struct lai_path_record record;
+		record.id = fname_in;
+		memcpy(record.header, input.header, sizeof(record.header));
+		record.nPath = (mode != 0) ? values_info.nValues : 0;
+		record.LAIe = LAIe;
+		record.LAI = LAI_path;
+		record.CI = CI;
+		record.info = info;
+		record.status = info.status;
+		record.gsl_errno = LAI_PATH_ErrorState()->gsl_errno;
+		gsl_set_error_handler(old_handler);
+		if (LAIPathOutput_Open(&out, fname_out, record_format) != GSL_SUCCESS)
+		{
+			fprintf(stderr, "ERROR: could not open '%s' for writing\n", fname_out);
+			CircleLUT_Close(lut);
+			return 1;
+		}
+		LAIPathOutput_Record(&out, &record);
+		if (LAIPathOutput_Close(&out) != GSL_SUCCESS)
+			fprintf(stderr, "ERROR: could not write '%s'\n", fname_out);
+	}
 
-	fclose(fout);
-	fout = 0;
+	CircleLUT_Close(lut);
+	LAIPathCounters_Report(stderr, 1);
 
 	//getc(stdin);
 